@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstdio>
+#include <sbs/geometry/get_simple_bar_model.h>
+#include <sbs/physics/collision/bvh_model.h>
+#include <sbs/physics/collision/contact.h>
+#include <sbs/physics/collision/sdf_model.h>
+#include <sbs/physics/simulation.h>
+#include <sbs/physics/tetrahedral_body.h>
+
+/**
+ * Compares bounding spheres and bounding boxes as the hulls of point_bvh_model_t, for an elongated
+ * beam lying on a plane sdf and for two crossing beams. Reports the number of leaves (or pairs of
+ * leaves) whose primitives are tested and the time per collide() call.
+ */
+
+namespace {
+
+struct counting_contact_handler_t : public sbs::physics::collision::contact_handler_t
+{
+    virtual void handle(sbs::physics::collision::contact_t const& contact) override { ++count; }
+
+    std::size_t count = 0u;
+};
+
+sbs::physics::tetrahedral_body_t&
+add_beam(sbs::physics::simulation_t& simulation, Eigen::Affine3d const& transform)
+{
+    sbs::common::geometry_t beam_geometry = sbs::geometry::get_simple_bar_model(4u, 4u, 48u);
+    beam_geometry.set_color(255, 255, 0);
+    auto const beam_idx = static_cast<sbs::index_type>(simulation.bodies().size());
+    simulation.add_body();
+    simulation.bodies()[beam_idx] =
+        std::make_unique<sbs::physics::tetrahedral_body_t>(simulation, beam_idx, beam_geometry);
+    sbs::physics::tetrahedral_body_t& beam =
+        *dynamic_cast<sbs::physics::tetrahedral_body_t*>(simulation.bodies()[beam_idx].get());
+    beam.transform(transform);
+    beam.update_collision_model();
+    return beam;
+}
+
+template <class Func>
+double microseconds_per_call(std::size_t iterations, Func&& f)
+{
+    auto const begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0u; i < iterations; ++i)
+        f();
+    auto const end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - begin).count() /
+           static_cast<double>(iterations);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t constexpr iterations = 1000u;
+
+    sbs::physics::simulation_t simulation{};
+
+    // an elongated beam lying diagonally on the floor, slightly sunk into it
+    Eigen::Affine3d beam1_transform{Eigen::Translation3d(0., -0.5, 0.)};
+    beam1_transform.rotate(Eigen::AngleAxisd(3.14159 / 6., Eigen::Vector3d::UnitY()));
+    sbs::physics::tetrahedral_body_t& beam1 = add_beam(simulation, beam1_transform);
+
+    // a second beam crossing over the first one
+    Eigen::Affine3d beam2_transform{Eigen::Translation3d(-20., 2.2, 20.)};
+    beam2_transform.rotate(Eigen::AngleAxisd(3.14159 / 2., Eigen::Vector3d::UnitY()));
+    sbs::physics::tetrahedral_body_t& beam2 = add_beam(simulation, beam2_transform);
+
+    Eigen::AlignedBox3d const floor_volume{
+        Eigen::Vector3d{-100., -5., -100.},
+        Eigen::Vector3d{100., 5., 100.}};
+    auto floor = sbs::physics::collision::sdf_model_t::from_plane(
+        Eigen::Hyperplane<sbs::scalar_type, 3>(
+            Eigen::Vector3d{0., 1., 0.},
+            Eigen::Vector3d{0., 0., 0.}),
+        floor_volume);
+    floor.id() = static_cast<sbs::index_type>(simulation.bodies().size());
+
+    std::printf(
+        "%-8s %-12s %16s %12s %14s\n",
+        "hull",
+        "query",
+        "leaves visited",
+        "contacts",
+        "us/collide");
+
+    sbs::physics::collision::bounding_volume_t const bounding_volumes[] = {
+        sbs::physics::collision::bounding_volume_t::sphere,
+        sbs::physics::collision::bounding_volume_t::aabb};
+    for (auto const bounding_volume : bounding_volumes)
+    {
+        char const* const label =
+            bounding_volume == sbs::physics::collision::bounding_volume_t::aabb ? "aabb" : "sphere";
+        beam1.bvh().use_bounding_volume(bounding_volume);
+        beam2.bvh().use_bounding_volume(bounding_volume);
+
+        counting_contact_handler_t sdf_handler{};
+        beam1.bvh().collide(floor, sdf_handler);
+        std::size_t const sdf_leaves = beam1.bvh().visited_leaf_count();
+        double const sdf_time        = microseconds_per_call(iterations, [&]() {
+            counting_contact_handler_t handler{};
+            beam1.bvh().collide(floor, handler);
+        });
+        std::printf(
+            "%-8s %-12s %16zu %12zu %14.2f\n",
+            label,
+            "beam-plane",
+            sdf_leaves,
+            sdf_handler.count,
+            sdf_time);
+
+        counting_contact_handler_t bvh_handler{};
+        beam1.bvh().collide(beam2.bvh(), bvh_handler);
+        std::size_t const bvh_leaves = beam1.bvh().visited_leaf_count();
+        double const bvh_time        = microseconds_per_call(iterations, [&]() {
+            counting_contact_handler_t handler{};
+            beam1.bvh().collide(beam2.bvh(), handler);
+        });
+        std::printf(
+            "%-8s %-12s %16zu %12zu %14.2f\n",
+            label,
+            "beam-beam",
+            bvh_leaves,
+            bvh_handler.count,
+            bvh_time);
+    }
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <Discregrid/cubic_lagrange_discrete_grid.hpp>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <sbs/physics/collision/mesh_distance.h>
+#include <sbs/physics/collision/sdf_model.h>
+#include <sbs/physics/collision/sparse_sdf.h>
+#include <utility>
+#include <vector>
+
+/**
+ * Compares colliders of closed triangle meshes of increasing size: a cubic Lagrange grid sdf, a
+ * sparse narrow band sdf and direct closest point queries against the mesh's triangles. Reports
+ * the build time, the memory footprint, the time per signed distance query near the surface and
+ * the largest deviation from the exact signed distance.
+ */
+
+namespace {
+
+using vertices_type = std::vector<Eigen::Vector3d>;
+using faces_type    = std::vector<std::array<unsigned int, 3>>;
+
+/**
+ * Unit sphere obtained by subdividing an octahedron, with 8 * 4^subdivisions triangles
+ */
+void get_sphere_mesh(unsigned int subdivisions, vertices_type& vertices, faces_type& faces)
+{
+    vertices = {
+        Eigen::Vector3d::UnitX(),
+        -Eigen::Vector3d::UnitX(),
+        Eigen::Vector3d::UnitY(),
+        -Eigen::Vector3d::UnitY(),
+        Eigen::Vector3d::UnitZ(),
+        -Eigen::Vector3d::UnitZ()};
+    faces.clear();
+    for (unsigned int x = 0u; x < 2u; ++x)
+    {
+        for (unsigned int y = 2u; y < 4u; ++y)
+        {
+            for (unsigned int z = 4u; z < 6u; ++z)
+            {
+                // the face is counter-clockwise seen from outside if an even number of axes
+                // are negative
+                bool const is_ccw = ((x + y + z) % 2u) == 0u;
+                faces.push_back(is_ccw ? std::array<unsigned int, 3>{x, y, z} :
+                                         std::array<unsigned int, 3>{x, z, y});
+            }
+        }
+    }
+
+    for (unsigned int s = 0u; s < subdivisions; ++s)
+    {
+        std::map<std::pair<unsigned int, unsigned int>, unsigned int> midpoints{};
+        auto const midpoint = [&](unsigned int a, unsigned int b) {
+            auto const key = std::make_pair(std::min(a, b), std::max(a, b));
+            auto const it  = midpoints.find(key);
+            if (it != midpoints.end())
+                return it->second;
+
+            auto const m = static_cast<unsigned int>(vertices.size());
+            vertices.push_back((vertices[a] + vertices[b]).normalized());
+            midpoints.emplace(key, m);
+            return m;
+        };
+
+        faces_type subdivided{};
+        subdivided.reserve(4u * faces.size());
+        for (auto const& [a, b, c] : faces)
+        {
+            unsigned int const ab = midpoint(a, b);
+            unsigned int const bc = midpoint(b, c);
+            unsigned int const ca = midpoint(c, a);
+            subdivided.push_back({a, ab, ca});
+            subdivided.push_back({ab, b, bc});
+            subdivided.push_back({ca, bc, c});
+            subdivided.push_back({ab, bc, ca});
+        }
+        faces = std::move(subdivided);
+    }
+}
+
+template <class Func>
+double milliseconds(Func&& f)
+{
+    auto const begin = std::chrono::steady_clock::now();
+    f();
+    auto const end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+void report(
+    char const* collider,
+    std::size_t triangle_count,
+    double build_ms,
+    sbs::physics::collision::sdf_model_t const& sdf,
+    std::vector<Eigen::Vector3d> const& points,
+    std::vector<double> const& exact)
+{
+    std::vector<double> signed_distances{};
+    std::vector<Eigen::Vector3d> gradients{};
+    double const query_ms =
+        milliseconds([&]() { sdf.evaluate(points, signed_distances, gradients); });
+
+    double max_error = 0.;
+    for (std::size_t i = 0u; i < points.size(); ++i)
+        max_error = std::max(max_error, std::abs(signed_distances[i] - exact[i]));
+
+    std::printf(
+        "%-8s %10zu %12.2f %14zu %12.3f %12.2e\n",
+        collider,
+        triangle_count,
+        build_ms,
+        sdf.memory_footprint(),
+        1000. * query_ms / static_cast<double>(points.size()),
+        max_error);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t constexpr query_count = 10000u;
+
+    std::printf(
+        "%-8s %10s %12s %14s %12s %12s\n",
+        "collider",
+        "triangles",
+        "build ms",
+        "bytes",
+        "us/query",
+        "max error");
+
+    Eigen::AlignedBox3d const domain{
+        Eigen::Vector3d::Constant(-1.2),
+        Eigen::Vector3d::Constant(1.2)};
+    std::array<unsigned int, 3u> const resolution{32u, 32u, 32u};
+    double const cell_size = domain.sizes().x() / 128.;
+
+    for (unsigned int const subdivisions : {3u, 5u, 7u})
+    {
+        vertices_type vertices{};
+        faces_type faces{};
+        get_sphere_mesh(subdivisions, vertices, faces);
+
+        // query points within a band around the surface, where contacts are generated
+        std::mt19937 generator{1234u};
+        std::normal_distribution<double> direction{0., 1.};
+        std::uniform_real_distribution<double> radius{0.9, 1.1};
+        std::vector<Eigen::Vector3d> points(query_count);
+        for (Eigen::Vector3d& p : points)
+        {
+            Eigen::Vector3d const d{
+                direction(generator),
+                direction(generator),
+                direction(generator)};
+            p = radius(generator) * d.normalized();
+        }
+
+        std::shared_ptr<sbs::physics::collision::mesh_distance_t const> mesh_distance{};
+        double const mesh_ms = milliseconds([&]() {
+            mesh_distance =
+                std::make_shared<sbs::physics::collision::mesh_distance_t const>(vertices, faces);
+        });
+        sbs::physics::collision::sdf_model_t const mesh{mesh_distance};
+
+        std::vector<double> exact(points.size());
+        mesh_distance->signed_distance(points.data(), points.size(), exact.data());
+
+        auto grid = std::make_shared<Discregrid::CubicLagrangeDiscreteGrid>(domain, resolution);
+        double const grid_ms = milliseconds([&]() { mesh_distance->add_to(*grid); });
+        sbs::physics::collision::sdf_model_t const grid_sdf{
+            std::shared_ptr<Discregrid::CubicLagrangeDiscreteGrid const>(grid)};
+
+        std::shared_ptr<sbs::physics::collision::sparse_sdf_t const> sparse{};
+        double const sparse_ms = milliseconds([&]() {
+            sparse = std::make_shared<sbs::physics::collision::sparse_sdf_t const>(
+                domain,
+                cell_size,
+                4. * cell_size,
+                0.5,
+                [&](Eigen::Vector3d const& p) { return mesh_distance->signed_distance(p); });
+        });
+        sbs::physics::collision::sdf_model_t const sparse_sdf{sparse};
+
+        // the grid and the sparse sdf are built from the mesh's hierarchy, whose time is included
+        report("grid", faces.size(), mesh_ms + grid_ms, grid_sdf, points, exact);
+        report("sparse", faces.size(), mesh_ms + sparse_ms, sparse_sdf, points, exact);
+        report("mesh", faces.size(), mesh_ms, mesh, points, exact);
+    }
+
+    return 0;
+}
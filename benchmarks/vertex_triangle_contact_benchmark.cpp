@@ -0,0 +1,121 @@
+#include <chrono>
+#include <cstdio>
+#include <sbs/geometry/get_simple_bar_model.h>
+#include <sbs/physics/collision/bvh_model.h>
+#include <sbs/physics/collision/contact.h>
+#include <sbs/physics/simulation.h>
+#include <sbs/physics/tetrahedral_body.h>
+
+/**
+ * Measures vertex-triangle contact detection between two slabs whose boundary surfaces have about
+ * 50k triangles each, once with the upper slab resting slightly sunk into the lower one and once
+ * with the slabs overlapping by half their thickness, such that most contacts are deeper than the
+ * contact tolerance. Reports the number of leaves whose primitives are tested, the number of
+ * contacts and the time per collide() call. Every call after the first is seeded by the closest
+ * triangles of the previous one, as consecutive frames are.
+ */
+
+namespace {
+
+struct counting_contact_handler_t : public sbs::physics::collision::contact_handler_t
+{
+    virtual void handle(sbs::physics::collision::contact_t const& contact) override { ++count; }
+
+    std::size_t count = 0u;
+};
+
+sbs::physics::tetrahedral_body_t&
+add_slab(sbs::physics::simulation_t& simulation, Eigen::Affine3d const& transform)
+{
+    sbs::common::geometry_t slab_geometry = sbs::geometry::get_simple_bar_model(112u, 7u, 112u);
+    slab_geometry.set_color(255, 255, 0);
+    auto const slab_idx = static_cast<sbs::index_type>(simulation.bodies().size());
+    simulation.add_body();
+    simulation.bodies()[slab_idx] =
+        std::make_unique<sbs::physics::tetrahedral_body_t>(simulation, slab_idx, slab_geometry);
+    sbs::physics::tetrahedral_body_t& slab =
+        *dynamic_cast<sbs::physics::tetrahedral_body_t*>(simulation.bodies()[slab_idx].get());
+    slab.transform(transform);
+    slab.update_collision_model();
+    return slab;
+}
+
+template <class Func>
+double microseconds_per_call(std::size_t iterations, Func&& f)
+{
+    auto const begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0u; i < iterations; ++i)
+        f();
+    auto const end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - begin).count() /
+           static_cast<double>(iterations);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t constexpr iterations = 20u;
+
+    sbs::physics::simulation_t simulation{};
+
+    // the lower slab spans [0, 111] x [0, 6] x [0, 111]
+    sbs::physics::tetrahedral_body_t& lower = add_slab(simulation, Eigen::Affine3d::Identity());
+
+    // offsets in x and z keep the slabs' vertices off each other's edges
+    Eigen::Vector3d const resting_offset{0.37, 5.7, 0.41};
+    Eigen::Vector3d const deep_offset{0.37, 3., 0.41};
+    sbs::physics::tetrahedral_body_t& upper =
+        add_slab(simulation, Eigen::Affine3d{Eigen::Translation3d(resting_offset)});
+
+    std::printf(
+        "%zu surface triangles per slab, contact tolerance %.3f\n",
+        upper.surface_mesh().triangle_count(),
+        lower.bvh().contact_tolerance());
+    std::printf(
+        "%-8s %-12s %16s %12s %14s\n",
+        "hull",
+        "overlap",
+        "leaves visited",
+        "contacts",
+        "us/collide");
+
+    sbs::physics::collision::bounding_volume_t const bounding_volumes[] = {
+        sbs::physics::collision::bounding_volume_t::sphere,
+        sbs::physics::collision::bounding_volume_t::aabb};
+    for (auto const bounding_volume : bounding_volumes)
+    {
+        char const* const label =
+            bounding_volume == sbs::physics::collision::bounding_volume_t::aabb ? "aabb" : "sphere";
+        lower.bvh().use_bounding_volume(bounding_volume);
+        upper.bvh().use_bounding_volume(bounding_volume);
+
+        for (bool const is_deep : {false, true})
+        {
+            // moves the upper slab between the two overlaps and back
+            Eigen::Vector3d const offset = is_deep ? deep_offset : resting_offset;
+            upper.transform(Eigen::Affine3d{Eigen::Translation3d(offset - resting_offset)});
+            upper.update_collision_model();
+
+            counting_contact_handler_t handler{};
+            lower.bvh().collide(upper.bvh(), handler);
+            std::size_t const leaves = lower.bvh().visited_leaf_count();
+            double const time        = microseconds_per_call(iterations, [&]() {
+                counting_contact_handler_t h{};
+                lower.bvh().collide(upper.bvh(), h);
+            });
+            std::printf(
+                "%-8s %-12s %16zu %12zu %14.2f\n",
+                label,
+                is_deep ? "deep" : "resting",
+                leaves,
+                handler.count,
+                time);
+
+            upper.transform(Eigen::Affine3d{Eigen::Translation3d(resting_offset - offset)});
+            upper.update_collision_model();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <sbs/geometry/get_simple_bar_model.h>
+#include <sbs/physics/collision/bvh_model.h>
+#include <sbs/physics/collision/wide_bvh.h>
+#include <sbs/physics/simulation.h>
+#include <sbs/physics/tetrahedral_body.h>
+#include <vector>
+
+/**
+ * Compares the throughput of box overlap queries against a beam's vertex hierarchy and of ray
+ * queries against its triangle hierarchy, between the binary kd-tree traversed by Discregrid's
+ * traverseBreadthFirst(), the binary kd-tree traversed with a stack of node indices and its
+ * 4-wide collapse. All hierarchies use the same bounding boxes, such that they report the same
+ * leaves.
+ */
+
+namespace {
+
+sbs::physics::tetrahedral_body_t& add_beam(sbs::physics::simulation_t& simulation)
+{
+    sbs::common::geometry_t beam_geometry = sbs::geometry::get_simple_bar_model(8u, 8u, 96u);
+    beam_geometry.set_color(255, 255, 0);
+    auto const beam_idx = static_cast<sbs::index_type>(simulation.bodies().size());
+    simulation.add_body();
+    simulation.bodies()[beam_idx] =
+        std::make_unique<sbs::physics::tetrahedral_body_t>(simulation, beam_idx, beam_geometry);
+    sbs::physics::tetrahedral_body_t& beam =
+        *dynamic_cast<sbs::physics::tetrahedral_body_t*>(simulation.bodies()[beam_idx].get());
+    beam.update_collision_model();
+    return beam;
+}
+
+bool intersects(
+    Eigen::AlignedBox3d const& box,
+    Eigen::Vector3d const& origin,
+    Eigen::Vector3d const& inverse_direction)
+{
+    Eigen::Array3d const t1 = (box.min() - origin).array() * inverse_direction.array();
+    Eigen::Array3d const t2 = (box.max() - origin).array() * inverse_direction.array();
+    return t1.min(t2).maxCoeff() <= t1.max(t2).minCoeff();
+}
+
+/**
+ * Depth first traversal of a binary hierarchy's bounding boxes, counting the visited leaves
+ */
+template <class Tree, class BoxTestFunc>
+std::size_t
+binary_traverse(Tree const& tree, BoxTestFunc const& test, std::vector<unsigned int>& stack)
+{
+    std::size_t leaf_count = 0u;
+    stack.clear();
+    stack.push_back(0u);
+    while (!stack.empty())
+    {
+        unsigned int const node_idx = stack.back();
+        stack.pop_back();
+        if (!test(tree.box(node_idx)))
+            continue;
+
+        auto const& node = tree.node(node_idx);
+        if (node.isLeaf())
+        {
+            ++leaf_count;
+            continue;
+        }
+        stack.push_back(static_cast<unsigned int>(node.children[1]));
+        stack.push_back(static_cast<unsigned int>(node.children[0]));
+    }
+    return leaf_count;
+}
+
+/**
+ * Discregrid's breadth first traversal of a binary hierarchy's bounding boxes, with its queue
+ * and type-erased callbacks, counting the visited leaves
+ */
+template <class Tree, class BoxTestFunc>
+std::size_t discregrid_traverse(Tree const& tree, BoxTestFunc const& test)
+{
+    std::size_t leaf_count = 0u;
+    tree.traverseBreadthFirst(
+        [&](unsigned int node_idx, unsigned int) { return test(tree.box(node_idx)); },
+        [&](unsigned int node_idx, unsigned int) {
+            if (tree.node(node_idx).isLeaf() && test(tree.box(node_idx)))
+                ++leaf_count;
+        });
+    return leaf_count;
+}
+
+template <class Func>
+double queries_per_second(std::size_t query_count, Func&& f)
+{
+    auto const begin = std::chrono::steady_clock::now();
+    for (std::size_t q = 0u; q < query_count; ++q)
+        f(q);
+    auto const end = std::chrono::steady_clock::now();
+    return static_cast<double>(query_count) /
+           std::chrono::duration<double>(end - begin).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t constexpr query_count = 200000u;
+
+    sbs::physics::simulation_t simulation{};
+    sbs::physics::tetrahedral_body_t& beam = add_beam(simulation);
+    beam.bvh().use_bounding_volume(sbs::physics::collision::bounding_volume_t::aabb);
+
+    auto const& vertex_bvh   = beam.bvh();
+    auto const& triangle_bvh = beam.bvh().triangle_bvh();
+    Eigen::AlignedBox3d const bounds = vertex_bvh.wide_bvh().bounds();
+
+    std::mt19937 generator{7u};
+    std::uniform_real_distribution<double> unit{0., 1.};
+    auto const random_point = [&]() {
+        Eigen::Vector3d const t{unit(generator), unit(generator), unit(generator)};
+        return Eigen::Vector3d{bounds.min() + t.cwiseProduct(bounds.sizes())};
+    };
+
+    std::vector<Eigen::AlignedBox3d> boxes(query_count);
+    for (Eigen::AlignedBox3d& box : boxes)
+    {
+        Eigen::Vector3d const center = random_point();
+        Eigen::Vector3d const extent = Eigen::Vector3d::Constant(0.05 * bounds.sizes().minCoeff());
+        box                          = Eigen::AlignedBox3d(center - extent, center + extent);
+    }
+
+    struct ray_t
+    {
+        Eigen::Vector3d origin, direction, inverse_direction;
+    };
+    std::vector<ray_t> rays(query_count);
+    for (ray_t& ray : rays)
+    {
+        ray.origin            = random_point();
+        ray.direction         = (random_point() - ray.origin).normalized();
+        ray.inverse_direction = ray.direction.cwiseInverse();
+    }
+
+    std::printf("%-12s %-10s %12s %16s\n", "query", "tree", "leaves", "queries/s");
+
+    std::size_t discregrid_leaves = 0u;
+    double const discregrid_box_rate = queries_per_second(query_count, [&](std::size_t q) {
+        auto const test = [&](Eigen::AlignedBox3d const& b) { return b.intersects(boxes[q]); };
+        discregrid_leaves += discregrid_traverse(vertex_bvh, test);
+    });
+    std::printf(
+        "%-12s %-10s %12zu %16.0f\n",
+        "box",
+        "discregrid",
+        discregrid_leaves,
+        discregrid_box_rate);
+
+    std::vector<unsigned int> stack{};
+    std::size_t binary_leaves = 0u;
+    double const binary_box_rate = queries_per_second(query_count, [&](std::size_t q) {
+        auto const test = [&](Eigen::AlignedBox3d const& b) { return b.intersects(boxes[q]); };
+        binary_leaves += binary_traverse(vertex_bvh, test, stack);
+    });
+    std::printf("%-12s %-10s %12zu %16.0f\n", "box", "binary", binary_leaves, binary_box_rate);
+
+    std::size_t wide_leaves = 0u;
+    double const wide_box_rate = queries_per_second(query_count, [&](std::size_t q) {
+        auto const on_leaf = [&](std::uint32_t, std::uint32_t) { ++wide_leaves; };
+        vertex_bvh.wide_bvh().query(boxes[q], on_leaf);
+    });
+    std::printf("%-12s %-10s %12zu %16.0f\n", "box", "wide", wide_leaves, wide_box_rate);
+
+    discregrid_leaves = 0u;
+    double const discregrid_ray_rate = queries_per_second(query_count, [&](std::size_t q) {
+        auto const test = [&](Eigen::AlignedBox3d const& b) {
+            return intersects(b, rays[q].origin, rays[q].inverse_direction);
+        };
+        discregrid_leaves += discregrid_traverse(triangle_bvh, test);
+    });
+    std::printf(
+        "%-12s %-10s %12zu %16.0f\n",
+        "ray",
+        "discregrid",
+        discregrid_leaves,
+        discregrid_ray_rate);
+
+    binary_leaves = 0u;
+    double const binary_ray_rate = queries_per_second(query_count, [&](std::size_t q) {
+        auto const test = [&](Eigen::AlignedBox3d const& b) {
+            return intersects(b, rays[q].origin, rays[q].inverse_direction);
+        };
+        binary_leaves += binary_traverse(triangle_bvh, test, stack);
+    });
+    std::printf("%-12s %-10s %12zu %16.0f\n", "ray", "binary", binary_leaves, binary_ray_rate);
+
+    wide_leaves = 0u;
+    double constexpr infinity  = std::numeric_limits<double>::infinity();
+    double const wide_ray_rate = queries_per_second(query_count, [&](std::size_t q) {
+        triangle_bvh.wide_bvh().raycast(
+            rays[q].origin,
+            rays[q].direction,
+            -infinity,
+            infinity,
+            [&](std::uint32_t, std::uint32_t) { ++wide_leaves; });
+    });
+    std::printf("%-12s %-10s %12zu %16.0f\n", "ray", "wide", wide_leaves, wide_ray_rate);
+
+    return 0;
+}
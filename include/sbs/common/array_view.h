@@ -0,0 +1,39 @@
+#ifndef SBS_COMMON_ARRAY_VIEW_H
+#define SBS_COMMON_ARRAY_VIEW_H
+
+#include <cstddef>
+#include <vector>
+
+namespace sbs {
+namespace common {
+
+/**
+ * @brief Read-only view of a contiguous array owned elsewhere, such as by a memory mapped file.
+ * The view is only valid for as long as the array it refers to.
+ */
+template <class T>
+class array_view_t
+{
+  public:
+    array_view_t() = default;
+    array_view_t(T const* data, std::size_t size) : data_(data), size_(size) {}
+    array_view_t(std::vector<T> const& v) : data_(v.data()), size_(v.size()) {}
+
+    T const* data() const { return data_; }
+    T const* begin() const { return data_; }
+    T const* end() const { return data_ + size_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0u; }
+    T const& operator[](std::size_t i) const { return data_[i]; }
+    T const& front() const { return data_[0u]; }
+    T const& back() const { return data_[size_ - 1u]; }
+
+  private:
+    T const* data_    = nullptr;
+    std::size_t size_ = 0u;
+};
+
+} // namespace common
+} // namespace sbs
+
+#endif // SBS_COMMON_ARRAY_VIEW_H
@@ -0,0 +1,311 @@
+#ifndef SBS_COMMON_FLAT_HASH_MAP_H
+#define SBS_COMMON_FLAT_HASH_MAP_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace sbs {
+namespace common {
+
+/**
+ * @brief Finalizer of MurmurHash3, which spreads keys differing in few bits over all 64 bits
+ */
+inline std::uint64_t mix_bits(std::uint64_t h)
+{
+    h ^= h >> 33u;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33u;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33u;
+    return h;
+}
+
+/**
+ * @brief Hash of packed integer keys and of fixed size arrays of 32-bit indices
+ */
+struct flat_hash_t
+{
+    std::size_t operator()(std::uint64_t key) const
+    {
+        return static_cast<std::size_t>(mix_bits(key));
+    }
+
+    template <std::size_t N>
+    std::size_t operator()(std::array<std::uint32_t, N> const& key) const
+    {
+        std::uint64_t h = 0u;
+        for (std::uint32_t const k : key)
+            h = mix_bits(h ^ k) + 0x9e3779b97f4a7c15ull;
+        return static_cast<std::size_t>(h);
+    }
+};
+
+/**
+ * @brief Open addressing hash map with linear probing, storing its entries contiguously.
+ *
+ * Lookups touch a few adjacent slots instead of chasing tree or bucket nodes. Erasure shifts the
+ * following entries of the probe sequence back, such that no tombstones accumulate. Iteration
+ * order is unspecified and changes when the map grows. Pointers to values are invalidated by
+ * insertions and erasures.
+ */
+template <class Key, class Value, class Hash = flat_hash_t>
+class flat_hash_map_t
+{
+  public:
+    using value_type = std::pair<Key, Value>;
+
+    class const_iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename flat_hash_map_t::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = value_type const*;
+        using reference         = value_type const&;
+
+        const_iterator() = default;
+        const_iterator(flat_hash_map_t const* map, std::size_t slot) : map_(map), slot_(slot)
+        {
+            skip_empty_slots();
+        }
+
+        reference operator*() const { return map_->slots_[slot_]; }
+        pointer operator->() const { return &map_->slots_[slot_]; }
+
+        const_iterator& operator++()
+        {
+            ++slot_;
+            skip_empty_slots();
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator const previous = *this;
+            ++(*this);
+            return previous;
+        }
+
+        bool operator==(const_iterator const& other) const { return slot_ == other.slot_; }
+        bool operator!=(const_iterator const& other) const { return slot_ != other.slot_; }
+
+      private:
+        void skip_empty_slots()
+        {
+            while (slot_ < map_->slots_.size() && !map_->occupied_[slot_])
+                ++slot_;
+        }
+
+        flat_hash_map_t const* map_ = nullptr;
+        std::size_t slot_           = 0u;
+    };
+
+    flat_hash_map_t() = default;
+
+    /**
+     * @return The value mapped to key, or nullptr if key is not in the map
+     */
+    Value const* find(Key const& key) const;
+    Value* find(Key const& key);
+    bool contains(Key const& key) const;
+
+    /**
+     * @brief Maps key to value, replacing its previous value if key was already in the map
+     * @return True if key was inserted, false if its value was replaced
+     */
+    bool insert_or_assign(Key const& key, Value const& value);
+
+    /**
+     * @return True if key was in the map
+     */
+    bool erase(Key const& key);
+
+    /**
+     * @brief Grows the table such that count entries fit without rehashing
+     */
+    void reserve(std::size_t count);
+    void clear();
+
+    std::size_t size() const;
+    bool empty() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+  private:
+    /**
+     * @brief Index of key's slot, or of the empty slot terminating key's probe sequence
+     */
+    std::size_t slot_of(Key const& key) const;
+    std::size_t home_slot_of(Key const& key) const;
+    void rehash(std::size_t slot_count);
+
+    std::vector<value_type> slots_{};     ///< Power of two number of slots
+    std::vector<std::uint8_t> occupied_{}; ///< 1 for slots holding an entry, 0 otherwise
+    std::size_t size_ = 0u;                ///< Number of entries
+};
+
+template <class Key, class Value, class Hash>
+inline Value const* flat_hash_map_t<Key, Value, Hash>::find(Key const& key) const
+{
+    if (size_ == 0u)
+        return nullptr;
+
+    std::size_t const s = slot_of(key);
+    return occupied_[s] ? &slots_[s].second : nullptr;
+}
+
+template <class Key, class Value, class Hash>
+inline Value* flat_hash_map_t<Key, Value, Hash>::find(Key const& key)
+{
+    return const_cast<Value*>(static_cast<flat_hash_map_t const*>(this)->find(key));
+}
+
+template <class Key, class Value, class Hash>
+inline bool flat_hash_map_t<Key, Value, Hash>::contains(Key const& key) const
+{
+    return find(key) != nullptr;
+}
+
+template <class Key, class Value, class Hash>
+inline bool
+flat_hash_map_t<Key, Value, Hash>::insert_or_assign(Key const& key, Value const& value)
+{
+    // keeps the load factor at most 3/4
+    if (4u * (size_ + 1u) > 3u * slots_.size())
+        rehash(std::max<std::size_t>(2u * slots_.size(), 16u));
+
+    std::size_t const s = slot_of(key);
+    if (occupied_[s])
+    {
+        slots_[s].second = value;
+        return false;
+    }
+
+    slots_[s]    = value_type{key, value};
+    occupied_[s] = 1u;
+    ++size_;
+    return true;
+}
+
+template <class Key, class Value, class Hash>
+inline bool flat_hash_map_t<Key, Value, Hash>::erase(Key const& key)
+{
+    if (size_ == 0u)
+        return false;
+
+    std::size_t hole = slot_of(key);
+    if (!occupied_[hole])
+        return false;
+
+    // moves back every following entry of the cluster whose home slot does not lie in the
+    // cyclic range (hole, s], such that all entries stay reachable from their home slots
+    std::size_t const mask = slots_.size() - 1u;
+    for (std::size_t s = (hole + 1u) & mask; occupied_[s]; s = (s + 1u) & mask)
+    {
+        std::size_t const home = home_slot_of(slots_[s].first);
+        if (((s - home) & mask) < ((s - hole) & mask))
+            continue;
+
+        slots_[hole] = std::move(slots_[s]);
+        hole         = s;
+    }
+    occupied_[hole] = 0u;
+    --size_;
+    return true;
+}
+
+template <class Key, class Value, class Hash>
+inline void flat_hash_map_t<Key, Value, Hash>::reserve(std::size_t count)
+{
+    std::size_t slot_count = 16u;
+    while (3u * slot_count < 4u * count)
+        slot_count *= 2u;
+
+    if (slot_count > slots_.size())
+        rehash(slot_count);
+}
+
+template <class Key, class Value, class Hash>
+inline void flat_hash_map_t<Key, Value, Hash>::clear()
+{
+    slots_.clear();
+    occupied_.clear();
+    size_ = 0u;
+}
+
+template <class Key, class Value, class Hash>
+inline std::size_t flat_hash_map_t<Key, Value, Hash>::size() const
+{
+    return size_;
+}
+
+template <class Key, class Value, class Hash>
+inline bool flat_hash_map_t<Key, Value, Hash>::empty() const
+{
+    return size_ == 0u;
+}
+
+template <class Key, class Value, class Hash>
+inline typename flat_hash_map_t<Key, Value, Hash>::const_iterator
+flat_hash_map_t<Key, Value, Hash>::begin() const
+{
+    return const_iterator{this, 0u};
+}
+
+template <class Key, class Value, class Hash>
+inline typename flat_hash_map_t<Key, Value, Hash>::const_iterator
+flat_hash_map_t<Key, Value, Hash>::end() const
+{
+    return const_iterator{this, slots_.size()};
+}
+
+template <class Key, class Value, class Hash>
+inline std::size_t flat_hash_map_t<Key, Value, Hash>::slot_of(Key const& key) const
+{
+    std::size_t const mask = slots_.size() - 1u;
+
+    std::size_t s = home_slot_of(key);
+    while (occupied_[s] && !(slots_[s].first == key))
+        s = (s + 1u) & mask;
+    return s;
+}
+
+template <class Key, class Value, class Hash>
+inline std::size_t flat_hash_map_t<Key, Value, Hash>::home_slot_of(Key const& key) const
+{
+    return Hash{}(key) & (slots_.size() - 1u);
+}
+
+template <class Key, class Value, class Hash>
+inline void flat_hash_map_t<Key, Value, Hash>::rehash(std::size_t slot_count)
+{
+    std::vector<value_type> slots(slot_count);
+    std::vector<std::uint8_t> occupied(slot_count, 0u);
+    slots.swap(slots_);
+    occupied.swap(occupied_);
+
+    std::size_t const mask = slot_count - 1u;
+    for (std::size_t i = 0u; i < slots.size(); ++i)
+    {
+        if (!occupied[i])
+            continue;
+
+        std::size_t s = home_slot_of(slots[i].first);
+        while (occupied_[s])
+            s = (s + 1u) & mask;
+
+        slots_[s]    = std::move(slots[i]);
+        occupied_[s] = 1u;
+    }
+}
+
+} // namespace common
+} // namespace sbs
+
+#endif // SBS_COMMON_FLAT_HASH_MAP_H
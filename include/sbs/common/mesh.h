@@ -4,7 +4,10 @@
 #include "node.h"
 
 #include <Eigen/Core>
+#include <Eigen/Geometry>
 #include <array>
+#include <cstdint>
+#include <utility>
 
 namespace sbs {
 namespace common {
@@ -31,6 +34,18 @@ class shared_vertex_surface_mesh_i : public renderable_node_t
     virtual vertex_type vertex(std::size_t vi) const    = 0;
     virtual triangle_type triangle(std::size_t f) const = 0;
 
+    /**
+     * @brief Number of topology edits made to the surface so far. Surfaces which do not track
+     * their edits stay at revision 0.
+     */
+    virtual std::uint64_t topology_revision() const;
+
+    /**
+     * @brief Range [begin, end) of triangles which the topology edits made after the given
+     * revision may have changed. Surfaces which do not track their edits report all triangles.
+     */
+    virtual std::pair<std::size_t, std::size_t> edited_triangles(std::uint64_t revision) const;
+
     virtual void prepare_vertices_for_rendering() = 0;
     virtual void prepare_indices_for_rendering()  = 0;
 };
@@ -49,6 +64,11 @@ class static_mesh_t : public shared_vertex_surface_mesh_i
 
     virtual vertex_type vertex(std::size_t vi) const override;
     virtual triangle_type triangle(std::size_t fi) const override;
+
+    /**
+     * @brief Transforms the mesh's vertex positions and normals, and marks its vertices dirty
+     */
+    void transform(Eigen::Affine3d const& affine);
 };
 
 /**
@@ -1,6 +1,9 @@
 #ifndef SBS_COMMON_NODE_H
 #define SBS_COMMON_NODE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -30,6 +33,14 @@ class renderable_node_t
 
     void mark_vertices_dirty();
     void mark_indices_dirty();
+
+    /**
+     * @brief Marks only the entries [begin, end) of the cpu vertex or index buffer as changed,
+     * which lets the renderer transfer just those entries while the buffer fits its gpu storage.
+     * Ranges marked before the next transfer are merged.
+     */
+    void mark_vertices_dirty(std::size_t begin, std::size_t end);
+    void mark_indices_dirty(std::size_t begin, std::size_t end);
     void mark_should_render_wireframe();
 
     void mark_vertices_clean();
@@ -41,6 +52,11 @@ class renderable_node_t
     bool should_render_triangles() const;
     bool should_render_wireframe() const;
 
+    std::size_t dirty_vertices_begin() const;
+    std::size_t dirty_vertices_end() const;
+    std::size_t dirty_indices_begin() const;
+    std::size_t dirty_indices_end() const;
+
     bool is_environment_body() const;
     bool is_physically_simulated_body() const;
 
@@ -70,6 +86,12 @@ class renderable_node_t
         bool should_transfer_indices  = true;
         bool should_render_triangles  = true;
         bool should_render_wireframe  = false;
+
+        // changed buffer entries [begin, end), all of them by default
+        std::size_t dirty_vertices_begin = 0u;
+        std::size_t dirty_vertices_end   = std::numeric_limits<std::size_t>::max();
+        std::size_t dirty_indices_begin  = 0u;
+        std::size_t dirty_indices_end    = std::numeric_limits<std::size_t>::max();
     } render_state_;
 
     bool is_collideable_;
@@ -0,0 +1,154 @@
+#ifndef SBS_COMMON_PARALLEL_H
+#define SBS_COMMON_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sbs {
+namespace common {
+
+/**
+ * @brief Number of worker threads used by the parallel loops below (at least 1).
+ */
+inline std::size_t thread_count()
+{
+    std::size_t const n = static_cast<std::size_t>(std::thread::hardware_concurrency());
+    return std::max<std::size_t>(n, 1u);
+}
+
+/**
+ * @brief True on a thread while it runs chunks of a parallel loop on the thread pool. Parallel
+ * loops nested in such chunks run serially, since every thread is busy with the enclosing loop.
+ */
+bool is_in_parallel_region();
+
+/**
+ * @brief Persistent worker threads shared by the parallel loops below, such that loops in per
+ * step hot paths do not create and join threads on every call
+ */
+class thread_pool_t
+{
+  public:
+    /**
+     * @brief Function called with a task's context and index
+     */
+    using task_function_type = void (*)(void const* context, std::size_t i);
+
+    explicit thread_pool_t(std::size_t worker_count);
+    thread_pool_t(thread_pool_t const& other) = delete;
+    thread_pool_t& operator=(thread_pool_t const& other) = delete;
+    ~thread_pool_t();
+
+    /**
+     * @brief The pool of thread_count() - 1 workers, which is started on first use
+     */
+    static thread_pool_t& instance();
+
+    std::size_t worker_count() const;
+
+    /**
+     * @brief Calls task(context, i) for every i in [0, task_count) on the workers and the calling
+     * thread, and returns once all calls have returned
+     * @return False, without calling task, if the pool is running the tasks of another call
+     */
+    bool try_run(std::size_t task_count, task_function_type task, void const* context);
+
+  private:
+    struct job_t
+    {
+        task_function_type task;
+        void const* context;
+        std::size_t task_count;
+        std::atomic<std::size_t> next_task;
+        std::size_t finished_task_count; ///< Guarded by mutex_
+        std::size_t active_worker_count; ///< Workers running tasks of this job, guarded by mutex_
+    };
+
+    void work();
+    void run_tasks(job_t& job);
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;         ///< Held by the call whose tasks the pool runs
+    std::mutex mutex_;             ///< Guards the job and the stop flag
+    std::condition_variable wake_; ///< Notifies workers of new jobs or stopping
+    std::condition_variable done_; ///< Notifies the calling thread of finished tasks
+    job_t* job_;                   ///< Job of the running call, if any
+    std::uint64_t generation_;     ///< Incremented for every job
+    bool is_stopping_;             ///< Set on destruction
+};
+
+/**
+ * @brief Splits [0, count) into at most chunk_count contiguous chunks and calls
+ * f(chunk, begin, end) for each of them on the thread pool. Chunk c always covers indices that
+ * precede those of chunk c+1, so per-chunk outputs concatenated in chunk order are deterministic.
+ * Calls nested in the chunks of another parallel loop, or made while the pool is busy, process
+ * their chunks serially on the calling thread.
+ * @param count Number of work items
+ * @param chunk_count Maximum number of chunks
+ * @param f Callable of signature void(std::size_t chunk, std::size_t begin, std::size_t end)
+ * @return The number of chunks that were actually processed
+ */
+template <class Func>
+std::size_t parallel_for_chunks(std::size_t count, std::size_t chunk_count, Func const& f)
+{
+    if (count == 0u)
+        return 0u;
+
+    chunk_count                  = std::max<std::size_t>(std::min(chunk_count, count), 1u);
+    std::size_t const chunk_size = (count + chunk_count - 1u) / chunk_count;
+    chunk_count                  = (count + chunk_size - 1u) / chunk_size;
+
+    auto const run_chunk = [&f, count, chunk_size](std::size_t c) {
+        std::size_t const begin = c * chunk_size;
+        std::size_t const end   = std::min(begin + chunk_size, count);
+        f(c, begin, end);
+    };
+    using run_chunk_type = decltype(run_chunk);
+
+    bool const has_run =
+        chunk_count > 1u && !is_in_parallel_region() &&
+        thread_pool_t::instance().try_run(
+            chunk_count,
+            [](void const* context, std::size_t c) {
+                (*static_cast<run_chunk_type const*>(context))(c);
+            },
+            &run_chunk);
+    if (!has_run)
+    {
+        for (std::size_t c = 0u; c < chunk_count; ++c)
+            run_chunk(c);
+    }
+
+    return chunk_count;
+}
+
+/**
+ * @brief Calls f(i) for every i in [0, count), distributing contiguous ranges of indices over
+ * the available hardware threads. Ranges smaller than grain_size are processed serially.
+ * @param count Number of work items
+ * @param f Callable of signature void(std::size_t i)
+ * @param grain_size Minimum number of work items per thread
+ */
+template <class Func>
+void parallel_for(std::size_t count, Func const& f, std::size_t grain_size = 256u)
+{
+    std::size_t const max_chunks =
+        std::max<std::size_t>(count / std::max<std::size_t>(grain_size, 1u), 1u);
+    std::size_t const chunk_count = std::min(thread_count(), max_chunks);
+
+    parallel_for_chunks(count, chunk_count, [&f](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+            f(i);
+    });
+}
+
+} // namespace common
+} // namespace sbs
+
+#endif // SBS_COMMON_PARALLEL_H
@@ -0,0 +1,34 @@
+#ifndef SBS_GEOMETRY_REORDER_FOR_LOCALITY_H
+#define SBS_GEOMETRY_REORDER_FOR_LOCALITY_H
+
+#include <sbs/aliases.h>
+#include <sbs/common/geometry.h>
+#include <vector>
+
+namespace sbs {
+namespace geometry {
+
+/**
+ * @brief Permutation applied by reorder_for_locality(), mapping original indices to new indices
+ */
+struct locality_permutation_t
+{
+    std::vector<index_type> vertices; ///< New index of every original vertex
+    std::vector<index_type> elements; ///< New index of every original triangle or tetrahedron
+};
+
+/**
+ * @brief Sorts a geometry's vertices along the Morton curve through their positions, and its
+ * triangles or tetrahedra along the Morton curve through their centroids, such that primitives
+ * close in space are also close in memory. Particles, tetrahedra, surface maps and per element
+ * constraints later created from the geometry inherit its order. Per vertex attributes are
+ * permuted along, and elements keep the order of their vertices, hence their orientation.
+ * @param geometry The geometry to reorder
+ * @return The applied permutation, which maps indices chosen on the original geometry
+ */
+locality_permutation_t reorder_for_locality(common::geometry_t& geometry);
+
+} // namespace geometry
+} // namespace sbs
+
+#endif // SBS_GEOMETRY_REORDER_FOR_LOCALITY_H
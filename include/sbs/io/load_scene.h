@@ -3,9 +3,12 @@
 
 #include "sbs/common/scene.h"
 #include "sbs/common/geometry.h"
+#include "sbs/geometry/reorder_for_locality.h"
+#include "sbs/io/topology_snapshot.h"
 
 #include <filesystem>
 #include <functional>
+#include <optional>
 #include <string>
 
 namespace sbs {
@@ -25,6 +28,10 @@ struct physics_body_info : scene_body_info
     {
         double vx, vy, vz;
     } velocity;
+    geometry::locality_permutation_t
+        locality_permutation; ///< Applied to geometry if the scene asks for reorder_for_locality
+    std::optional<topology_snapshot_t>
+        topology_snapshot; ///< Fully built topology of geometry if the scene names a matching one
 };
 
 } // namespace scene
@@ -0,0 +1,116 @@
+#ifndef SBS_IO_TOPOLOGY_SNAPSHOT_H
+#define SBS_IO_TOPOLOGY_SNAPSHOT_H
+
+/**
+ * @file
+ * @ingroup io
+ */
+
+#include "sbs/common/array_view.h"
+#include "sbs/physics/tetrahedral_mesh_boundary.h"
+#include "sbs/physics/topology.h"
+
+#include <Eigen/Core>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <vector>
+
+namespace sbs {
+namespace io {
+
+/**
+ * @ingroup io-topology-snapshot
+ * @brief
+ * Version of the topology snapshot format written by write_topology_snapshot(). Snapshots of
+ * other versions are rejected by read_topology_snapshot().
+ */
+std::uint32_t constexpr topology_snapshot_version = 1u;
+
+/**
+ * @ingroup io-topology-snapshot
+ * @brief
+ * Fully built topology of a tetrahedral body, its boundary surface and its rest positions.
+ *
+ * On disk, a snapshot is a little endian image made of a 48 bytes header, holding a magic
+ * string, the version, the section count, the file size, an FNV-1a checksum of all 8 byte words
+ * after the header and the vertex count, followed by a table of sections and the sections
+ * themselves. Every section is a flat array starting at a multiple of 8 bytes, such that a memory
+ * mapped snapshot can be read in place.
+ */
+struct topology_snapshot_t
+{
+    physics::tetrahedron_set_arrays_t topology;
+    physics::boundary_surface_arrays_t boundary;
+    std::vector<Eigen::Vector3d> rest_positions;
+};
+
+/**
+ * @ingroup io-topology-snapshot
+ * @brief
+ * Views of the arrays of a topology snapshot read in place from its image in memory, which must
+ * outlive the views
+ */
+struct topology_snapshot_view_t
+{
+    physics::tetrahedron_set_array_views_t topology;
+    physics::boundary_surface_array_views_t boundary;
+    common::array_view_t<Eigen::Vector3d> rest_positions;
+};
+
+/**
+ * @ingroup io-topology-snapshot
+ * @brief
+ * Takes a snapshot of a boundary surface's tetrahedral mesh, which must not hold removed
+ * primitives, and of its rest positions
+ */
+topology_snapshot_t make_topology_snapshot(
+    physics::tetrahedral_mesh_boundary_t const& boundary,
+    std::vector<Eigen::Vector3d> const& rest_positions);
+
+/**
+ * @ingroup io-topology-snapshot
+ * @brief
+ */
+void write_topology_snapshot(
+    std::filesystem::path const& filepath,
+    topology_snapshot_t const& snapshot);
+
+/**
+ * @ingroup io-topology-snapshot
+ * @brief
+ */
+void write_topology_snapshot(std::ostream& os, topology_snapshot_t const& snapshot);
+
+/**
+ * @ingroup io-topology-snapshot
+ * @brief
+ */
+std::optional<topology_snapshot_t> read_topology_snapshot(std::filesystem::path const& path);
+
+/**
+ * @ingroup io-topology-snapshot
+ * @brief
+ * Reads a snapshot with one allocation for the file image and one per array
+ */
+std::optional<topology_snapshot_t> read_topology_snapshot(std::istream& is);
+
+/**
+ * @ingroup io-topology-snapshot
+ * @brief
+ * Reads a snapshot in place from its image in memory, such as a memory mapped file, without
+ * copying its arrays
+ * @param data The snapshot's first byte, aligned to 8 bytes
+ * @param size The snapshot's size in bytes
+ * @return Views of the snapshot's arrays into data, or nothing if data is misaligned or if the
+ * snapshot's header, checksum or indices are invalid
+ */
+std::optional<topology_snapshot_view_t>
+read_topology_snapshot(std::byte const* data, std::size_t size);
+
+} // namespace io
+} // namespace sbs
+
+#endif // SBS_IO_TOPOLOGY_SNAPSHOT_H
@@ -30,6 +30,12 @@ class body_t
     virtual void update_physical_model()                        = 0;
     virtual void transform(Eigen::Affine3d const& affine)       = 0;
 
+    /**
+     * @brief Moves kinematic bodies along their velocities for dt at the end of a substep.
+     * Simulated bodies are moved by the solver instead.
+     */
+    virtual void advance(scalar_type dt) {}
+
     index_type id() const;
     index_type& id();
 
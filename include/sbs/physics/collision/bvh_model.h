@@ -3,8 +3,17 @@
 
 #include <Discregrid/acceleration/bounding_sphere.hpp>
 #include <Discregrid/acceleration/kd_tree.hpp>
+#include <Eigen/Geometry>
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <sbs/aliases.h>
 #include <sbs/physics/collision/collision_model.h>
+#include <sbs/physics/collision/spatial_hash_self_collision.h>
+#include <sbs/physics/collision/wide_bvh.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace sbs {
 namespace common {
@@ -17,9 +26,105 @@ class contact_handler_t;
 namespace physics {
 
 class simulation_t;
+class tetrahedral_mesh_boundary_t;
 
 namespace collision {
 
+/**
+ * @brief Bottom-up refit order of a kd-tree's nodes. Nodes are grouped by depth, deepest level
+ * first, such that the nodes of a level only depend on hulls of already refitted levels and can
+ * be refitted in parallel.
+ */
+struct bvh_refit_schedule_t
+{
+    std::vector<unsigned int> nodes;        ///< Node indices sorted by decreasing depth
+    std::vector<std::size_t> level_offsets; ///< Offsets of each depth level in nodes
+};
+
+/**
+ * @brief Bounding sphere hierarchy over the triangles of a surface mesh. Used as the target of
+ * vertex-triangle contact queries between deformable bodies.
+ */
+class triangle_bvh_t : public Discregrid::KDTree<Discregrid::BoundingSphere>
+{
+  public:
+    using triangle_type = std::array<std::uint32_t, 3u>;
+
+    triangle_bvh_t();
+    triangle_bvh_t(common::shared_vertex_surface_mesh_i const* surface);
+
+    triangle_bvh_t(triangle_bvh_t const& other) = default;
+    triangle_bvh_t(triangle_bvh_t&& other)      = default;
+    triangle_bvh_t& operator=(triangle_bvh_t const& other) = default;
+    triangle_bvh_t& operator=(triangle_bvh_t&& other) = default;
+
+    bool empty() const;
+
+    /**
+     * @brief Vertex indices of the surface's triangle fi as of the last update(), read without
+     * going through the surface's interface
+     */
+    triangle_type const& triangle(std::size_t fi) const;
+    std::size_t triangle_count() const;
+
+    /**
+     * @brief Refits the hierarchy's hulls to the surface's current vertex positions, and rebuilds
+     * the hierarchy if its quality() exceeds rebuild_threshold() after the refit. Only the
+     * triangles edited since the previous update are read from the surface again.
+     * @param positions The surface's vertex positions
+     */
+    void update(std::vector<Eigen::Vector3d> const& positions);
+
+    /**
+     * @brief Sum of the squared radii of the hierarchy's hulls, normalized by the root's squared
+     * radius, relative to the same value right after the last rebuild. Grows as refitting
+     * degrades the hierarchy, but not under uniform scaling.
+     */
+    scalar_type quality() const;
+    scalar_type rebuild_threshold() const;
+    scalar_type& rebuild_threshold();
+
+    /**
+     * @brief Selects the hulls used to prune traversals. Bounding boxes, when selected, are
+     * maintained in addition to the bounding spheres from the next update() on.
+     */
+    void use_bounding_volume(bounding_volume_t bounding_volume);
+    bounding_volume_t bounding_volume() const;
+
+    /**
+     * @brief Bounding box of the node node_idx. Only valid if bounding boxes are in use.
+     */
+    Eigen::AlignedBox3d const& box(unsigned int node_idx) const;
+
+    /**
+     * @brief 4-wide collapse of the hierarchy, whose entities are triangle indices. Only
+     * maintained if bounding boxes are in use.
+     */
+    wide_bvh_t const& wide_bvh() const;
+
+  protected:
+    using kd_tree_type = Discregrid::KDTree<Discregrid::BoundingSphere>;
+
+    virtual Eigen::Vector3d entityPosition(unsigned int i) const override final;
+    virtual void computeHull(unsigned int b, unsigned int n, Discregrid::BoundingSphere& hull)
+        const override final;
+
+    void rebuild(std::vector<Eigen::Vector3d> const& positions);
+    void refit(std::vector<Eigen::Vector3d> const& positions);
+
+  private:
+    common::shared_vertex_surface_mesh_i const* surface_;
+    std::vector<triangle_type> triangles_; ///< Copy of the surface's triangles
+    std::uint64_t topology_revision_;      ///< Surface revision triangles_ was copied at
+    bvh_refit_schedule_t refit_schedule_;
+    scalar_type cost_;         ///< Current normalized sum of the hulls' squared radii
+    scalar_type rebuilt_cost_; ///< cost_ right after the last rebuild
+    scalar_type rebuild_threshold_;
+    bounding_volume_t bounding_volume_;
+    std::vector<Eigen::AlignedBox3d> boxes_; ///< Per node bounding boxes, if in use
+    wide_bvh_t wide_bvh_;                    ///< Wide collapse, if boxes are in use
+};
+
 class point_bvh_model_t : public collision_model_t,
                           public Discregrid::KDTree<Discregrid::BoundingSphere>
 {
@@ -36,6 +141,92 @@ class point_bvh_model_t : public collision_model_t,
     virtual primitive_type_t primitive_type() const override;
     virtual void collide(collision_model_t& other, contact_handler_t& handler) override;
     virtual void update(simulation_t const& simulation) override;
+    virtual void self_collide(contact_handler_t& handler) override;
+
+    triangle_bvh_t const& triangle_bvh() const;
+
+    /**
+     * @brief Sum of the squared radii of the vertex hierarchy's hulls, normalized by the root's
+     * squared radius, relative to the same value right after the last rebuild. Grows as
+     * refitting degrades the hierarchy, but not under uniform scaling.
+     */
+    scalar_type quality() const;
+
+    /**
+     * @brief Value of quality() above which update() rebuilds the vertex hierarchy from scratch
+     * instead of only refitting it. Defaults to 2.
+     */
+    scalar_type rebuild_threshold() const;
+    scalar_type& rebuild_threshold();
+
+    /**
+     * @brief Selects the hulls used to prune collision queries against this model. Bounding
+     * spheres are always maintained, since they drive the hierarchy's construction. Bounding
+     * boxes fit elongated bodies much more tightly, at the cost of refitting a second set of
+     * hulls on every update.
+     */
+    void use_bounding_volume(bounding_volume_t bounding_volume);
+    bounding_volume_t bounding_volume() const;
+
+    /**
+     * @brief Bounding box of the node node_idx. Only valid if bounding boxes are in use.
+     */
+    Eigen::AlignedBox3d const& box(unsigned int node_idx) const;
+
+    /**
+     * @brief 4-wide collapse of the vertex hierarchy, whose entities are vertex indices. Only
+     * maintained if bounding boxes are in use, in which case it drives collision queries against
+     * sdf models.
+     */
+    wide_bvh_t const& wide_bvh() const;
+
+    /**
+     * @brief Number of leaves, or pairs of leaves for collisions with other bvh models, whose
+     * primitives were tested by the last call to collide().
+     */
+    std::size_t visited_leaf_count() const;
+
+    /**
+     * @brief Maximum distance between a vertex of another body outside of this model's surface
+     * and the surface for which vertex-triangle pairs are tested. Vertices inside of the surface
+     * are in contact at any depth. Defaults to the surface's mean edge length.
+     */
+    scalar_type contact_tolerance() const;
+    scalar_type& contact_tolerance();
+
+    /**
+     * @brief Enables detection of contacts between this model's surface and itself. The given
+     * boundary must be the surface this model was built from. update() rebuilds the self
+     * collision's adjacency after topology edits of the boundary.
+     * @param boundary The tetrahedral mesh boundary whose tetrahedra are used to ignore
+     * vertex-triangle pairs belonging to the same elements
+     */
+    void enable_self_collision(tetrahedral_mesh_boundary_t const* boundary);
+    void disable_self_collision();
+
+    /**
+     * @brief Enables swept contacts against sdf models. Every vertex's motion between the last
+     * two updates is traced through the sdf, and vertices that crossed its zero level set
+     * without ending up inside of it, i.e. that tunneled through thin geometry, are reported
+     * with a contact at their time of impact.
+     */
+    void enable_continuous_collision_detection();
+    void disable_continuous_collision_detection();
+    bool continuous_collision_detection() const;
+
+    /**
+     * @brief Enables skipping sdf evaluations by temporal coherence, which is the default. The
+     * signed distance of every vertex evaluated against an sdf model is remembered, and the
+     * vertex is not evaluated again against that model until its accumulated displacement over
+     * the following updates exceeds it. This relies on signed distances being 1-Lipschitz. The
+     * remembered distances are discarded when the sdf model's transform changes.
+     */
+    void enable_temporal_coherence();
+    void disable_temporal_coherence();
+    bool temporal_coherence() const;
+
+    std::optional<spatial_hash_self_collision_t> const& self_collision() const;
+    std::optional<spatial_hash_self_collision_t>& self_collision();
 
   protected:
     using kd_tree_type = Discregrid::KDTree<Discregrid::BoundingSphere>;
@@ -44,8 +235,95 @@ class point_bvh_model_t : public collision_model_t,
     virtual void computeHull(unsigned int b, unsigned int n, Discregrid::BoundingSphere& hull)
         const override final;
 
+    /**
+     * @brief Sets this model's englobing volume to the bounding box of the vertices
+     */
+    void update_volume();
+
+    void rebuild();
+
+    /**
+     * @brief Recomputes the hulls bottom-up from positions_, merging child hulls instead of
+     * computing enclosing spheres of the nodes' vertices. Neither allocates nor creates threads.
+     */
+    void refit();
+
+    /**
+     * @brief Reports contacts between this model's vertices and the other model's surface
+     * triangles. Only vertices within the other model's volume can lie inside of its surface,
+     * which is decided by their closest triangles at any depth. The closest triangle of each
+     * vertex found by the previous query against the same model bounds the search for the
+     * current ones, such that vertices which moved little only visit the leaves around it.
+     * @return The number of triangle leaves whose triangles were tested
+     */
+    std::size_t
+    collide_vertices_with_triangles(point_bvh_model_t const& other, contact_handler_t& handler);
+
   private:
+    /**
+     * @brief Per vertex lower bounds on the distance to an sdf model, expressed as the value of
+     * travelled_ up to which the vertex cannot have reached the sdf's zero level set
+     */
+    struct separation_bounds_t
+    {
+        Eigen::Affine3d sdf_transform; ///< Transform of the sdf model when the bounds were set
+        std::vector<scalar_type> expiries;
+    };
+
+    /**
+     * @brief Vertices last queried against an sdf model and the order in which the sdf grouped
+     * them by grid cell, which is reused as long as the same vertices are queried
+     */
+    struct sdf_query_order_t
+    {
+        std::vector<index_type> vertices;
+        std::vector<std::size_t> grid_order;
+    };
+
+    struct vertex_triangle_candidate_t
+    {
+        index_type fi;
+        scalar_type squared_distance;
+        Eigen::Vector3d closest_point;
+        Eigen::Vector3d barycentric_coordinates;
+    };
+
     common::shared_vertex_surface_mesh_i const* surface_;
+    std::vector<Eigen::Vector3d> positions_;          ///< Vertex positions gathered on update
+    std::vector<Eigen::Vector3d> previous_positions_; ///< positions_ of the previous update
+    std::uint64_t topology_revision_;                 ///< Surface revision of the last update
+    bvh_refit_schedule_t refit_schedule_;
+    scalar_type cost_;         ///< Current normalized sum of the hulls' squared radii
+    scalar_type rebuilt_cost_; ///< cost_ right after the last rebuild
+    scalar_type rebuild_threshold_;
+    bounding_volume_t bounding_volume_;
+    std::vector<Eigen::AlignedBox3d> boxes_; ///< Per node bounding boxes, if in use
+    wide_bvh_t wide_bvh_;                    ///< Wide collapse, if boxes are in use
+    std::size_t visited_leaf_count_;
+    triangle_bvh_t triangle_bvh_;
+    scalar_type contact_tolerance_;
+    std::optional<spatial_hash_self_collision_t> self_collision_;
+    bool continuous_collision_detection_;
+    scalar_type max_displacement_; ///< Longest vertex motion between the last two updates
+    bool temporal_coherence_;
+    std::vector<scalar_type> travelled_; ///< Accumulated displacement of each vertex
+    std::unordered_map<index_type, separation_bounds_t>
+        separation_bounds_; ///< Separation bounds to each sdf model, by model id
+    std::unordered_map<index_type, sdf_query_order_t>
+        sdf_query_orders_; ///< Query order of the vertices against each sdf model, by model id
+
+    std::unordered_map<index_type, std::vector<index_type>>
+        closest_triangles_; ///< Closest triangle of each vertex to each bvh model, by model id
+    std::vector<unsigned int>
+        vertex_nodes_; ///< Traversal stack of the vertices within another model's volume
+    std::vector<std::pair<unsigned int, scalar_type>>
+        triangle_nodes_; ///< Traversal stack of closest triangle searches, with node distances
+    std::vector<vertex_triangle_candidate_t>
+        candidates_; ///< Triangles tested by a closest triangle search, up to its bound
+    std::vector<index_type> sdf_query_vertices_;    ///< Vertices reached by sdf queries
+    std::vector<Eigen::Vector3d> sdf_query_points_; ///< positions_ of sdf_query_vertices_
+    std::vector<scalar_type> sdf_signed_distances_; ///< Signed distances at sdf_query_points_
+    std::vector<Eigen::Vector3d> sdf_gradients_;    ///< Sdf gradients at sdf_query_points_
 };
 
 } // namespace collision
@@ -1,8 +1,12 @@
 #ifndef SBS_PHYSICS_COLLISION_CD_SYSTEM_H
 #define SBS_PHYSICS_COLLISION_CD_SYSTEM_H
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <sbs/physics/collision/contact.h>
+#include <sbs/physics/collision/contact_reduction.h>
 #include <utility>
 #include <vector>
 
@@ -29,21 +33,87 @@ class cd_system_t
     cd_system_t& operator=(cd_system_t const& other) = default;
     cd_system_t& operator=(cd_system_t&& other) = default;
 
+    /**
+     * @brief Finds the candidate pairs of collision models, then runs the narrow phase on them
+     */
     virtual void execute()                                       = 0;
     virtual void update(physics::simulation_t const& simulation) = 0;
 
+    /**
+     * @brief Runs the narrow phase again on the candidate pairs found by the last call to
+     * execute(), against the collision models' current state. Only pairs whose volumes came
+     * within broad_phase_margin() of each other at that time are tested.
+     */
+    void refresh_contacts();
+
     std::vector<collision_model_t*> const& collision_objects() const;
 
+    /**
+     * @brief Pairs of collision models found by the last call to execute()
+     */
+    std::vector<intersection_pair> const& candidate_pairs() const;
+
+    /**
+     * @brief Distance by which the broad phase grows the collision models' volumes, such that its
+     * candidate pairs remain valid while the models move by up to that distance. Defaults to 0.
+     */
+    scalar_type broad_phase_margin() const;
+    scalar_type& broad_phase_margin();
+
     std::unique_ptr<contact_handler_t> const& contact_handler() const;
     std::unique_ptr<contact_handler_t>& contact_handler();
     void use_contact_handler(std::unique_ptr<contact_handler_t> contact_handler);
 
+    /**
+     * @brief Reduces the contacts of every pair of bodies before they reach the contact handler.
+     * See contact_reduction_t.
+     * @param cluster_size Side of the cells in which contacts are clustered
+     * @param max_contacts_per_pair Maximum number of contacts kept per pair of bodies
+     */
+    void enable_contact_reduction(scalar_type cluster_size, std::size_t max_contacts_per_pair);
+    void disable_contact_reduction();
+    std::optional<contact_reduction_t> const& contact_reduction() const;
+
   protected:
     std::vector<collision_model_t*>& collision_objects();
+    std::vector<intersection_pair>& candidate_pairs();
+
+    /**
+     * @brief Collides every pair, then self-collides every collision object, and passes the
+     * resulting contacts to the contact handler in batches.
+     *
+     * Tests run in parallel on per-thread contact buffers. Tests are scheduled in rounds in which
+     * no collision model that collide() mutates takes part more than once, and sdf models, which
+     * are only read, do not constrain the schedule. Contacts are then reduced, if enabled, and
+     * handed over in the order of the pairs, as if all tests had run serially, such that results
+     * are deterministic.
+     */
+    void narrow_phase(std::vector<intersection_pair> const& pairs);
 
   private:
+    /**
+     * @brief A call to collide() or, if b2 is null, to self_collide(), and the ranges of the
+     * contacts it wrote to its thread's buffer
+     */
+    struct narrow_phase_task_t
+    {
+        collision_model_t* b1;
+        collision_model_t* b2;
+        std::uint32_t round;
+        std::uint32_t buffer;
+        std::size_t sdf_contacts_begin;
+        std::size_t sdf_contacts_end;
+        std::size_t triangle_contacts_begin;
+        std::size_t triangle_contacts_end;
+    };
+
     std::vector<collision_model_t*> collision_objects_;
     std::unique_ptr<contact_handler_t> contact_handler_;
+    std::vector<intersection_pair> candidate_pairs_;
+    scalar_type broad_phase_margin_;
+    std::vector<narrow_phase_task_t> tasks_;
+    std::vector<contact_buffer_t> contact_buffers_; ///< One contact buffer per thread
+    std::optional<contact_reduction_t> contact_reduction_;
 };
 
 } // namespace collision
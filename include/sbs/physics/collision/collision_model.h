@@ -37,6 +37,12 @@ class collision_model_t
     virtual void collide(collision_model_t& other, contact_handler_t& handler) = 0;
     virtual void update(simulation_t const& simulation)                        = 0;
 
+    /**
+     * @brief Reports contacts between parts of this model. Models that do not support
+     * self-collision report nothing.
+     */
+    virtual void self_collide(contact_handler_t& handler);
+
     volume_type const& volume() const;
     volume_type& volume();
 
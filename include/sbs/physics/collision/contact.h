@@ -2,7 +2,9 @@
 #define SBS_PHYSICS_COLLISION_CONTACT_H
 
 #include <Eigen/Core>
+#include <cstddef>
 #include <sbs/aliases.h>
+#include <vector>
 
 namespace sbs {
 namespace physics {
@@ -11,7 +13,7 @@ namespace collision {
 class contact_t
 {
   public:
-    enum class type_t { surface_particle_to_sdf };
+    enum class type_t { surface_particle_to_sdf, surface_particle_to_surface_triangle };
 
     contact_t(
         type_t contact_type,
@@ -45,24 +47,120 @@ class surface_mesh_particle_to_sdf_contact_t : public contact_t
         index_type const body2,
         Eigen::Vector3d const& contact_point,
         Eigen::Vector3d const& contact_normal,
-        index_type const vi)
-        : contact_t(contact_type, body1, body2, contact_point, contact_normal), vi_(vi)
+        index_type const vi,
+        Eigen::Vector3d const& sdf_velocity = Eigen::Vector3d::Zero())
+        : contact_t(contact_type, body1, body2, contact_point, contact_normal),
+          vi_(vi),
+          sdf_velocity_(sdf_velocity)
     {
     }
 
     index_type vi() const;
     index_type& vi();
+    Eigen::Vector3d const& sdf_velocity() const;
 
   private:
     index_type vi_;
+    Eigen::Vector3d sdf_velocity_; ///< Velocity of the sdf collider at the contact point
+};
+
+/**
+ * @brief Contact between a surface mesh vertex of body b1 and a surface mesh triangle of body b2.
+ * The contact point is the point of the triangle closest to the vertex and the contact normal is
+ * the triangle's outward normal.
+ */
+class surface_mesh_particle_to_triangle_contact_t : public contact_t
+{
+  public:
+    surface_mesh_particle_to_triangle_contact_t(
+        contact_t::type_t contact_type,
+        index_type const body1,
+        index_type const body2,
+        Eigen::Vector3d const& contact_point,
+        Eigen::Vector3d const& contact_normal,
+        index_type const vi,
+        index_type const fi,
+        Eigen::Vector3d const& barycentric_coordinates)
+        : contact_t(contact_type, body1, body2, contact_point, contact_normal),
+          vi_(vi),
+          fi_(fi),
+          barycentric_coordinates_(barycentric_coordinates)
+    {
+    }
+
+    index_type vi() const;
+    index_type& vi();
+    index_type fi() const;
+    index_type& fi();
+    Eigen::Vector3d const& barycentric_coordinates() const;
+
+  private:
+    index_type vi_;                           ///< Penetrating surface vertex of body b1
+    index_type fi_;                           ///< Penetrated surface triangle of body b2
+    Eigen::Vector3d barycentric_coordinates_; ///< Contact point in the triangle's coordinates
 };
 
 class contact_handler_t
 {
   public:
     virtual void handle(contact_t const& contact) = 0;
+
+    /**
+     * @brief Handles count contiguous contacts at once. All contacts of a batch share the same
+     * bodies b1 and b2, such that per body lookups can be resolved once per batch. Defaults to
+     * calling handle() on every contact.
+     */
+    virtual void
+    handle(surface_mesh_particle_to_sdf_contact_t const* contacts, std::size_t count);
+    virtual void
+    handle(surface_mesh_particle_to_triangle_contact_t const* contacts, std::size_t count);
+
+    virtual ~contact_handler_t() = default;
+};
+
+/**
+ * @brief Contact handler that stores the contacts it is given, by contact type, for later
+ * processing in batches
+ */
+class contact_buffer_t : public contact_handler_t
+{
+  public:
+    using contact_handler_t::handle;
+
+    virtual void handle(contact_t const& contact) override;
+
+    std::vector<surface_mesh_particle_to_sdf_contact_t> const& sdf_contacts() const;
+    std::vector<surface_mesh_particle_to_triangle_contact_t> const& triangle_contacts() const;
+
+    /**
+     * @brief Removes all contacts, keeping the storage
+     */
+    void clear();
+
+  private:
+    std::vector<surface_mesh_particle_to_sdf_contact_t> sdf_contacts_;
+    std::vector<surface_mesh_particle_to_triangle_contact_t> triangle_contacts_;
 };
 
+/**
+ * @brief Calls f(batch, count) for the contacts [begin, end), in order, as batches of consecutive
+ * contacts that share the same bodies b1 and b2
+ */
+template <class ContactType, class Func>
+void for_each_batch(ContactType const* begin, ContactType const* end, Func&& f)
+{
+    while (begin != end)
+    {
+        ContactType const* batch_end = begin + 1;
+        while (batch_end != end && batch_end->b1() == begin->b1() &&
+               batch_end->b2() == begin->b2())
+            ++batch_end;
+
+        f(begin, static_cast<std::size_t>(batch_end - begin));
+        begin = batch_end;
+    }
+}
+
 } // namespace collision
 } // namespace physics
 } // namespace sbs
@@ -0,0 +1,80 @@
+#ifndef SBS_PHYSICS_COLLISION_CONTACT_REDUCTION_H
+#define SBS_PHYSICS_COLLISION_CONTACT_REDUCTION_H
+
+#include <Eigen/Core>
+#include <cstddef>
+#include <cstdint>
+#include <sbs/aliases.h>
+#include <sbs/physics/collision/contact.h>
+#include <vector>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+/**
+ * @brief Reduces the contacts between a pair of bodies to a few representative ones.
+ *
+ * Contacts are clustered in cubic cells of side cluster_size, separately for each of the 6 axis
+ * directions closest to their normals. Every cluster is represented by its contact closest to the
+ * cluster's centroid and weighted by its number of contacts, which measures the surface area it
+ * covers for reasonably uniform meshes. If more than max_contacts clusters remain, the heaviest
+ * cluster is kept first, and then repeatedly the cluster maximizing its weight times its squared
+ * distance to the kept ones, which spreads the kept contacts over the contact area.
+ *
+ * Vertices whose contacts are dropped are not constrained by the solver, such that reduction
+ * trades penetration accuracy for solver cost. It suits resting contact on large flat regions.
+ */
+class contact_reduction_t
+{
+  public:
+    /**
+     * @param cluster_size Side of the clustering cells. If non-positive, contacts are not
+     * clustered and every contact is its own cluster.
+     * @param max_contacts Maximum number of contacts kept per pair of bodies
+     */
+    contact_reduction_t(scalar_type cluster_size, std::size_t max_contacts);
+
+    /**
+     * @brief Reduces count contacts sharing the same bodies b1 and b2. Kept contacts are
+     * returned in their original order, in storage that is reused by the next call.
+     */
+    std::vector<surface_mesh_particle_to_sdf_contact_t> const&
+    reduce(surface_mesh_particle_to_sdf_contact_t const* contacts, std::size_t count);
+    std::vector<surface_mesh_particle_to_triangle_contact_t> const&
+    reduce(surface_mesh_particle_to_triangle_contact_t const* contacts, std::size_t count);
+
+    scalar_type cluster_size() const;
+    std::size_t max_contacts() const;
+
+  private:
+    struct cluster_entry_t
+    {
+        std::uint64_t key;
+        std::uint32_t contact;
+    };
+
+    struct cluster_t
+    {
+        std::uint32_t representative; ///< Contact closest to the cluster's centroid
+        scalar_type weight;
+        scalar_type squared_distance; ///< Squared distance to the closest kept cluster
+    };
+
+    template <class ContactType>
+    void select(ContactType const* contacts, std::size_t count, std::vector<ContactType>& reduced);
+
+    scalar_type cluster_size_;
+    std::size_t max_contacts_;
+    std::vector<cluster_entry_t> entries_;
+    std::vector<cluster_t> clusters_;
+    std::vector<std::uint32_t> kept_;
+    std::vector<surface_mesh_particle_to_sdf_contact_t> sdf_contacts_;
+    std::vector<surface_mesh_particle_to_triangle_contact_t> triangle_contacts_;
+};
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
+
+#endif // SBS_PHYSICS_COLLISION_CONTACT_REDUCTION_H
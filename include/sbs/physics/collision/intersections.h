@@ -3,6 +3,7 @@
 
 #include <Eigen/Core>
 #include <optional>
+#include <utility>
 
 namespace sbs {
 namespace physics {
@@ -40,6 +41,15 @@ std::optional<point_t> intersect(line_segment_t const& segment, triangle_t const
 
 std::optional<point_t> intersect_twoway(line_segment_t const& segment, triangle_t const& triangle);
 
+/**
+ * @brief Computes the point on the triangle closest to p.
+ * @param p The query point
+ * @param triangle The triangle
+ * @return The closest point and its barycentric coordinates with respect to (a, b, c). Zero
+ * coordinates identify the closest feature (vertex, edge or face interior).
+ */
+std::pair<point_t, Eigen::Vector3d> closest_point(point_t const& p, triangle_t const& triangle);
+
 } // namespace collision
 } // namespace physics
 } // namespace sbs
@@ -0,0 +1,101 @@
+#ifndef SBS_PHYSICS_COLLISION_MESH_DISTANCE_H
+#define SBS_PHYSICS_COLLISION_MESH_DISTANCE_H
+
+#include <Discregrid/acceleration/bounding_sphere.hpp>
+#include <Discregrid/acceleration/kd_tree.hpp>
+#include <Discregrid/cubic_lagrange_discrete_grid.hpp>
+#include <array>
+#include <sbs/aliases.h>
+#include <sbs/physics/collision/wide_bvh.h>
+#include <utility>
+#include <vector>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+/**
+ * @brief Signed distance queries against a closed triangle mesh.
+ *
+ * Closest points are found by traversing a 4-wide bounding box hierarchy over the mesh's
+ * triangles, collapsed from Discregrid's binary kd-tree, whose nodes are released once the wide
+ * hierarchy is built. The sign is that of the closest point's angle-weighted pseudo-normal, which
+ * is robust at the mesh's edges and vertices (Baerentzen and Aanaes, 2005). Queries do not mutate
+ * the object, such that they may run concurrently.
+ */
+class mesh_distance_t : public Discregrid::KDTree<Discregrid::BoundingSphere>
+{
+  public:
+    mesh_distance_t(
+        std::vector<Eigen::Vector3d> const& vertices,
+        std::vector<std::array<unsigned int, 3>> const& faces);
+
+    scalar_type signed_distance(Eigen::Vector3d const& p) const;
+
+    /**
+     * @brief Signed distance at p and its gradient, the unit direction from the closest surface
+     * point to p, flipped inside of the mesh. On the surface, the gradient is the closest
+     * feature's pseudo-normal.
+     */
+    std::pair<scalar_type, Eigen::Vector3d> evaluate(Eigen::Vector3d const& p) const;
+
+    Eigen::Vector3d closest_surface_point(Eigen::Vector3d const& p) const;
+    bool contains(Eigen::Vector3d const& p) const;
+
+    /**
+     * @brief Computes the signed distances of count points in parallel
+     */
+    void signed_distance(
+        Eigen::Vector3d const* points,
+        std::size_t count,
+        scalar_type* signed_distances) const;
+
+    /**
+     * @brief Fills a new field of grid with the mesh's signed distance function. The grid's
+     * nodes are evaluated in parallel.
+     * @return The index of the new field
+     */
+    unsigned int add_to(Discregrid::CubicLagrangeDiscreteGrid& grid) const;
+
+    /**
+     * @brief Bounding box of the mesh's vertices
+     */
+    Eigen::AlignedBox3d bounds() const;
+
+    /**
+     * @brief Number of bytes used by the mesh, its normals and its hierarchies
+     */
+    std::size_t memory_footprint() const;
+
+  protected:
+    virtual Eigen::Vector3d entityPosition(unsigned int i) const override final;
+    virtual void computeHull(unsigned int b, unsigned int n, Discregrid::BoundingSphere& hull)
+        const override final;
+
+  private:
+    struct closest_feature_t
+    {
+        scalar_type squared_distance;
+        Eigen::Vector3d point;
+        Eigen::Vector3d const* pseudo_normal; ///< Pseudo-normal of the closest vertex, edge or face
+    };
+
+    /**
+     * @brief Closest point of the mesh to p. The squared distance is infinite if the mesh is
+     * empty.
+     */
+    closest_feature_t closest_feature(Eigen::Vector3d const& p) const;
+
+    std::vector<Eigen::Vector3d> vertices_;
+    std::vector<std::array<unsigned int, 3>> faces_;
+    std::vector<Eigen::Vector3d> face_normals_;   ///< Unit normals of the faces
+    std::vector<Eigen::Vector3d> edge_normals_;   ///< Pseudo-normal of edge e of face f at 3f + e
+    std::vector<Eigen::Vector3d> vertex_normals_; ///< Angle-weighted pseudo-normals
+    wide_bvh_t bvh_;
+};
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
+
+#endif // SBS_PHYSICS_COLLISION_MESH_DISTANCE_H
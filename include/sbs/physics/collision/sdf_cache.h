@@ -0,0 +1,76 @@
+#ifndef SBS_PHYSICS_COLLISION_SDF_CACHE_H
+#define SBS_PHYSICS_COLLISION_SDF_CACHE_H
+
+#include <Discregrid/cubic_lagrange_discrete_grid.hpp>
+#include <Eigen/Geometry>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+/**
+ * @brief Persistent on-disk cache of signed distance grids computed from triangle meshes.
+ *
+ * Grids are stored in Discregrid's binary format, one file per key in the cache's directory, and
+ * are keyed by a hash of the mesh, the grid's domain and its resolution. Each file ends with a
+ * footer holding a magic string, the cache's version, the key, the resolution, the size of the
+ * grid's payload and an FNV-1a checksum of it, all of which are validated before a grid is read.
+ * Files are written to a temporary file first and then renamed, such that an interrupted store
+ * never leaves a partial grid behind. Grids loaded or stored through the cache are shared in
+ * memory for as long as they are in use, such that environment bodies of the same geometry
+ * instance a single grid.
+ */
+class sdf_cache_t
+{
+  public:
+    sdf_cache_t(std::filesystem::path const& directory);
+
+    /**
+     * @brief 64-bit FNV-1a hash of the inputs of a signed distance grid computation
+     */
+    static std::uint64_t key(
+        std::vector<Eigen::Vector3d> const& vertices,
+        std::vector<std::array<unsigned int, 3>> const& faces,
+        Eigen::AlignedBox3d const& domain,
+        std::array<unsigned int, 3u> const& resolution);
+
+    /**
+     * @brief Loads the grid stored under key, or shares it if it is already in use.
+     * @return The grid, or nullptr if no grid of the given resolution is stored under key, or if
+     * its file is truncated, corrupted or was written by another version of the cache
+     */
+    std::shared_ptr<Discregrid::CubicLagrangeDiscreteGrid const>
+    load(std::uint64_t key, std::array<unsigned int, 3u> const& resolution) const;
+
+    /**
+     * @brief Stores grid under key, creating the cache's directory if needed. The grid is shared
+     * with later loads of key even if it could not be written.
+     * @return true if the grid and its footer were written completely
+     */
+    bool store(
+        std::uint64_t key,
+        std::shared_ptr<Discregrid::CubicLagrangeDiscreteGrid const> const& grid) const;
+
+    std::filesystem::path path(std::uint64_t key) const;
+    std::filesystem::path const& directory() const;
+
+  private:
+    using grid_type = Discregrid::CubicLagrangeDiscreteGrid;
+
+    std::filesystem::path directory_;
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<std::uint64_t, std::weak_ptr<grid_type const>> grids_; ///< In use
+};
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
+
+#endif // SBS_PHYSICS_COLLISION_SDF_CACHE_H
@@ -2,16 +2,29 @@
 #define SBS_PHYSICS_COLLISION_SDF_MODEL_H
 
 #include <Discregrid/cubic_lagrange_discrete_grid.hpp>
+#include <memory>
+#include <optional>
 #include <sbs/aliases.h>
 #include <sbs/physics/collision/collision_model.h>
+#include <sbs/physics/collision/sparse_sdf.h>
 #include <utility>
+#include <vector>
 
 namespace sbs {
 namespace physics {
 namespace collision {
 
 class contact_handler_t;
+class mesh_distance_t;
 
+/**
+ * @brief Collision model of a signed distance function.
+ *
+ * Sampled sdfs (grids) are immutable assets shared by all copies of a model, such that many
+ * instances of the same geometry, each placed with its own transform, store their sdf once. The
+ * signed distance to a closed triangle mesh can also be queried exactly, without sampling it,
+ * by closest point queries against the mesh's triangle hierarchy.
+ */
 class sdf_model_t : public collision_model_t
 {
   public:
@@ -20,7 +33,16 @@ class sdf_model_t : public collision_model_t
 
     sdf_model_t(Eigen::AlignedBox3d const& domain, std::array<unsigned int, 3u> const& resolution);
     sdf_model_t(Discregrid::CubicLagrangeDiscreteGrid const& sdf);
+    sdf_model_t(std::shared_ptr<Discregrid::CubicLagrangeDiscreteGrid const> const& sdf);
     sdf_model_t(analytic_sdf_type const& analytic_sdf, Eigen::AlignedBox3d const& volume);
+    sdf_model_t(sparse_sdf_t const& sdf);
+    sdf_model_t(std::shared_ptr<sparse_sdf_t const> const& sdf);
+
+    /**
+     * @brief Queries the signed distance to mesh directly. The volume is the mesh's padded
+     * bounding box.
+     */
+    sdf_model_t(std::shared_ptr<mesh_distance_t const> const& mesh);
 
     sdf_model_t(sdf_model_t const& other) = default;
     sdf_model_t(sdf_model_t&& other)      = default;
@@ -35,12 +57,160 @@ class sdf_model_t : public collision_model_t
 
     static sdf_model_t
     from_plane(Eigen::Hyperplane<scalar_type, 3> const& plane, Eigen::AlignedBox3d const& volume);
+    static sdf_model_t from_sphere(
+        Eigen::Vector3d const& center,
+        scalar_type radius,
+        Eigen::AlignedBox3d const& volume);
+    static sdf_model_t from_box(Eigen::AlignedBox3d const& box, Eigen::AlignedBox3d const& volume);
+    static sdf_model_t from_mesh(
+        std::vector<Eigen::Vector3d> const& vertices,
+        std::vector<std::array<unsigned int, 3>> const& faces);
+
+    /**
+     * @brief Rigid transformation, possibly uniformly scaled, from the sdf's local frame, in which
+     * it was sampled or defined, to world space. Query points are moved to the local frame before
+     * evaluation, and gradients back to world space, such that a moving collider never needs to
+     * be resampled.
+     */
+    Eigen::Affine3d const& transform() const;
+
+    /**
+     * @brief Sets the local to world transformation, which must be rigid up to a uniform scaling.
+     * The volume() is the world space bounding box of the volume the sdf had when it was first
+     * transformed.
+     */
+    void set_transform(Eigen::Affine3d const& transform);
+
+    /**
+     * @brief Copy of the model, sharing its sdf, placed at transform and at rest
+     */
+    sdf_model_t instance(Eigen::Affine3d const& transform) const;
+
+    /**
+     * @brief World space velocity of the local frame's origin
+     */
+    Eigen::Vector3d const& linear_velocity() const;
+    Eigen::Vector3d& linear_velocity();
+
+    /**
+     * @brief World space angular velocity about the local frame's origin
+     */
+    Eigen::Vector3d const& angular_velocity() const;
+    Eigen::Vector3d& angular_velocity();
+
+    /**
+     * @brief World space velocity of the collider's material point at p
+     */
+    Eigen::Vector3d velocity(Eigen::Vector3d const& p) const;
+
+    /**
+     * @brief Moves the collider along its linear and angular velocities for dt
+     */
+    void advance(scalar_type dt);
 
     std::pair<scalar_type, Eigen::Vector3d> evaluate(Eigen::Vector3d const& p) const;
 
+    /**
+     * @brief Closest point to p at which the sdf is defined. Grid and sparse sdfs evaluate to a
+     * huge distance outside of their domain, while the other sdfs are defined everywhere. Since
+     * domains are convex, no point of the domain is farther from the returned point than from p.
+     */
+    Eigen::Vector3d closest_point_in_domain(Eigen::Vector3d const& p) const;
+
+    /**
+     * @brief Evaluates the signed distance and its gradient at count points at once.
+     *
+     * Plane, sphere and box sdfs are evaluated in tight loops without going through the
+     * type-erased analytic function. Points queried against a grid sdf are grouped by grid cell,
+     * such that consecutive interpolations read the same cell's coefficients, and large batches
+     * are interpolated in parallel. Results are written in the order of the points.
+     * @param points The query points
+     * @param count Number of query points
+     * @param signed_distances Output array of count signed distances
+     * @param gradients Output array of count gradients
+     */
+    void evaluate(
+        Eigen::Vector3d const* points,
+        std::size_t count,
+        scalar_type* signed_distances,
+        Eigen::Vector3d* gradients) const;
+    void evaluate(
+        std::vector<Eigen::Vector3d> const& points,
+        std::vector<scalar_type>& signed_distances,
+        std::vector<Eigen::Vector3d>& gradients) const;
+
+    /**
+     * @brief Evaluates the signed distance and its gradient at many points, reusing the grouping
+     * of the points by grid cell across calls.
+     *
+     * Any order of the points gives the same results, such that callers querying the same points
+     * over several steps only sort them once, while the points move little.
+     * @param grid_order Order in which the points are interpolated on grid sdfs. It is computed
+     * if its size differs from the number of points and reused otherwise, such that callers clear
+     * it when the query points change.
+     */
+    void evaluate(
+        std::vector<Eigen::Vector3d> const& points,
+        std::vector<scalar_type>& signed_distances,
+        std::vector<Eigen::Vector3d>& gradients,
+        std::vector<std::size_t>& grid_order) const;
+
+    /**
+     * @brief Number of bytes used by the sdf. Storage shared by instances is split evenly among
+     * them. Discregrid does not expose its storage, such that the footprint of cubic Lagrange
+     * grids is computed from their resolution.
+     */
+    std::size_t memory_footprint() const;
+
+    /**
+     * @brief Finds the first point of the segment p0 -> p1 that reaches the sdf's zero level set,
+     * by sphere tracing (conservative advancement). Only the part of the segment inside of the
+     * sdf's volume is traced, and tracing stops once the signed distance falls below a thousandth
+     * of the segment's length.
+     * @return The time of impact t in [0, 1] of the hit point p0 + t * (p1 - p0), if any
+     */
+    std::optional<scalar_type> sphere_trace(Eigen::Vector3d const& p0, Eigen::Vector3d const& p1)
+        const;
+
   private:
-    Discregrid::CubicLagrangeDiscreteGrid sdf_;
+    enum class shape_type_t { grid, function, plane, sphere, box, sparse, mesh };
+
+    std::pair<scalar_type, Eigen::Vector3d> evaluate_local(Eigen::Vector3d const& p) const;
+    void evaluate(
+        Eigen::Vector3d const* points,
+        std::size_t count,
+        scalar_type* signed_distances,
+        Eigen::Vector3d* gradients,
+        std::vector<std::size_t>* grid_order) const;
+    void evaluate_local(
+        Eigen::Vector3d const* points,
+        std::size_t count,
+        scalar_type* signed_distances,
+        Eigen::Vector3d* gradients,
+        std::vector<std::size_t>* grid_order) const;
+    void evaluate_grid(
+        Eigen::Vector3d const* points,
+        std::size_t count,
+        scalar_type* signed_distances,
+        Eigen::Vector3d* gradients,
+        std::vector<std::size_t>* grid_order) const;
+
+    std::shared_ptr<Discregrid::CubicLagrangeDiscreteGrid const> sdf_;
+    std::shared_ptr<sparse_sdf_t const> sparse_sdf_;
+    std::shared_ptr<mesh_distance_t const> mesh_;
     analytic_sdf_type analytic_sdf_;
+    shape_type_t shape_type_;
+    Eigen::Hyperplane<scalar_type, 3> plane_; ///< Plane of plane sdfs
+    Eigen::Vector3d center_;                  ///< Center of sphere and box sdfs
+    Eigen::Vector3d half_extents_;            ///< Half extents of box sdfs
+    scalar_type radius_;                      ///< Radius of sphere sdfs
+    Eigen::Affine3d transform_;               ///< Local to world transformation
+    Eigen::Affine3d inverse_transform_;       ///< World to local transformation
+    scalar_type scale_;                       ///< Uniform scaling of transform_
+    bool is_transformed_;                     ///< Whether transform_ is not the identity
+    Eigen::AlignedBox3d local_volume_;        ///< Volume in the local frame
+    Eigen::Vector3d linear_velocity_;
+    Eigen::Vector3d angular_velocity_;
 };
 
 } // namespace collision
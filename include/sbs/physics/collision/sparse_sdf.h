@@ -0,0 +1,84 @@
+#ifndef SBS_PHYSICS_COLLISION_SPARSE_SDF_H
+#define SBS_PHYSICS_COLLISION_SPARSE_SDF_H
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <sbs/aliases.h>
+#include <utility>
+#include <vector>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+/**
+ * @brief Narrow band signed distance grid stored as a sparse map of bricks.
+ *
+ * The domain is divided into bricks of brick_size^3 cells. Only bricks that come within the narrow
+ * band of the surface store their (brick_size + 1)^3 samples, as floats. Everywhere else, the
+ * distance is interpolated from a coarse grid sampled at the bricks' corners, whose values are
+ * clamped to the far field distance. Distances and gradients are trilinearly interpolated.
+ */
+class sparse_sdf_t
+{
+  public:
+    static std::uint32_t constexpr brick_size = 8u; ///< Cells per brick side
+
+    /**
+     * @brief Signed distance function sampled when building the grid. Called concurrently.
+     */
+    using distance_function_type = std::function<scalar_type(Eigen::Vector3d const&)>;
+
+    sparse_sdf_t();
+
+    /**
+     * @brief Samples distance over domain.
+     * @param domain The domain, whose upper corner is rounded up to a whole number of bricks
+     * @param cell_size Edge length of the bricks' cells
+     * @param narrow_band Bricks containing points closer than narrow_band to the surface store
+     * their samples
+     * @param far_field Coarse distances are clamped to [-far_field, far_field]
+     * @param distance The signed distance function
+     */
+    sparse_sdf_t(
+        Eigen::AlignedBox3d const& domain,
+        scalar_type cell_size,
+        scalar_type narrow_band,
+        scalar_type far_field,
+        distance_function_type const& distance);
+
+    /**
+     * @brief Signed distance and its gradient at p. Outside of the domain, the distance is the
+     * largest scalar and the gradient is zero.
+     */
+    std::pair<scalar_type, Eigen::Vector3d> evaluate(Eigen::Vector3d const& p) const;
+
+    Eigen::AlignedBox3d const& domain() const;
+    scalar_type cell_size() const;
+    std::size_t brick_count() const;
+
+    /**
+     * @brief Number of bytes used by the grid's storage
+     */
+    std::size_t memory_footprint() const;
+
+  private:
+    std::size_t brick_index(std::array<std::uint32_t, 3u> const& b) const;
+    std::size_t coarse_index(std::array<std::uint32_t, 3u> const& n) const;
+
+    Eigen::AlignedBox3d domain_;
+    scalar_type cell_size_;
+    std::array<std::uint32_t, 3u> brick_resolution_; ///< Number of bricks along each axis
+    std::vector<float> coarse_samples_;              ///< Clamped distances at the bricks' corners
+    std::vector<std::int32_t> bricks_;               ///< Index of each brick's samples, or -1
+    std::vector<float> brick_samples_;               ///< Samples of the stored bricks, x fastest
+};
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
+
+#endif // SBS_PHYSICS_COLLISION_SPARSE_SDF_H
@@ -0,0 +1,80 @@
+#ifndef SBS_PHYSICS_COLLISION_SPATIAL_HASH_CD_SYSTEM_H
+#define SBS_PHYSICS_COLLISION_SPATIAL_HASH_CD_SYSTEM_H
+
+#include <Eigen/Geometry>
+#include <cstdint>
+#include <sbs/aliases.h>
+#include <sbs/physics/collision/cd_system.h>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+/**
+ * @brief Broad phase collision detection system using a hierarchical spatial hash over the
+ * collision models' englobing volumes.
+ *
+ * Every collision model is inserted in the grid level whose cell size is the smallest power of 2
+ * multiple of the base cell size that is at least as large as the model's volume, such that it
+ * overlaps at most 8 cells. A model then queries its own level and all coarser levels, which
+ * finds every overlapping pair exactly once without visiting the many fine cells a large
+ * environment model would span. Models whose volume is not finite or lies too far from the origin
+ * to be hashed, such as unbounded planes, are kept out of the grid and tested against every other
+ * model. Hashing and pair queries are performed in parallel, as is the narrow phase, whose
+ * contacts reach the contact handler in the order of the sorted candidate pairs, the same order in
+ * which brute_force_cd_system_t reports them.
+ */
+class spatial_hash_cd_system_t : public cd_system_t
+{
+  public:
+    /**
+     * @param collision_objects The collision models to test against each other
+     * @param cell_size Base (finest) cell size of the grid. If non-positive, the median extent
+     * of the collision models' volumes is used, recomputed on every update.
+     */
+    spatial_hash_cd_system_t(
+        std::vector<collision_model_t*> const& collision_objects,
+        scalar_type cell_size = 0.);
+
+    /**
+     * @brief Finds the pairs of collision models whose englobing volumes, grown by
+     * broad_phase_margin(), overlap. Pairs are ordered by the models' position in
+     * collision_objects(). Then runs the narrow phase on them. The grid built by the last update()
+     * is reused unless broad_phase_margin() grew since, in which case it is rebuilt.
+     */
+    virtual void execute() override;
+    virtual void update(simulation_t const& simulation) override;
+
+    scalar_type cell_size() const;
+
+  protected:
+    void rebuild_grid();
+    void find_candidate_pairs();
+
+  private:
+    using key_type = std::uint64_t;
+
+    struct cell_entry_t
+    {
+        key_type key;
+        index_type object;
+    };
+
+    scalar_type user_cell_size_;
+    scalar_type cell_size_;
+    scalar_type grid_margin_; ///< Broad phase margin the grid was built with
+    bool is_grid_dirty_;
+
+    std::vector<Eigen::AlignedBox3d> volumes_;   ///< Snapshot of the models' englobing volumes
+    std::vector<std::uint32_t> levels_;          ///< Grid level of each model
+    std::vector<std::uint32_t> occupied_levels_; ///< Sorted distinct levels in use
+    std::vector<index_type> unhashed_objects_;   ///< Models tested against every other model
+    std::vector<std::uint32_t> bucket_offsets_;  ///< Prefix sums of entries per bucket
+    std::vector<cell_entry_t> entries_;          ///< Cell entries sorted by bucket
+};
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
+
+#endif // SBS_PHYSICS_COLLISION_SPATIAL_HASH_CD_SYSTEM_H
@@ -0,0 +1,99 @@
+#ifndef SBS_PHYSICS_COLLISION_SPATIAL_HASH_SELF_COLLISION_H
+#define SBS_PHYSICS_COLLISION_SPATIAL_HASH_SELF_COLLISION_H
+
+#include <Eigen/Core>
+#include <cstdint>
+#include <sbs/aliases.h>
+#include <vector>
+
+namespace sbs {
+namespace physics {
+
+// Forward declares
+class tetrahedral_mesh_boundary_t;
+
+namespace collision {
+
+// Forward declares
+class contact_handler_t;
+
+/**
+ * @brief Self-collision detection between the boundary vertices and boundary triangles of a
+ * single tetrahedral body, using a per-step spatial hash in the style of Teschner et al. 2003.
+ *
+ * Every step, the boundary triangles' bounding boxes, enlarged by the collision thickness, are
+ * hashed into a uniform grid whose cells are as large as the mean boundary edge length, or larger
+ * when strongly stretched triangles would span too many cells. Each boundary vertex then only
+ * tests the triangles hashed in its own cell. Vertex-triangle pairs whose vertices share a
+ * tetrahedron are never reported, such that the rest configuration and the normal deformation of
+ * the mesh's elements do not produce contacts.
+ */
+class spatial_hash_self_collision_t
+{
+  public:
+    spatial_hash_self_collision_t();
+    spatial_hash_self_collision_t(tetrahedral_mesh_boundary_t const* boundary);
+
+    /**
+     * @brief Reports every boundary vertex that penetrates a non-adjacent boundary triangle of the
+     * same body by at most thickness() as a surface_particle_to_surface_triangle contact whose
+     * two bodies are the given body.
+     * @param id Index of the body owning the boundary
+     * @param handler The contact handler receiving the contacts
+     */
+    void collide(index_type id, contact_handler_t& handler);
+
+    /**
+     * @brief Recomputes the tetrahedral adjacency of the boundary vertices. Must be called when
+     * the underlying tetrahedral mesh's topology changes, which point_bvh_model_t::update() does.
+     */
+    void rebuild_adjacency();
+
+    /**
+     * @brief Maximum penetration depth of a vertex through a triangle for which a contact is
+     * reported. Defaults to half the boundary's mean edge length.
+     */
+    scalar_type thickness() const;
+    scalar_type& thickness();
+
+    scalar_type cell_size() const;
+    scalar_type& cell_size();
+
+  protected:
+    void rebuild_grid();
+    bool are_adjacent(index_type vi, index_type fi) const;
+
+  private:
+    struct cell_entry_t
+    {
+        std::int64_t cell[3];
+        index_type fi;
+    };
+
+    struct self_contact_t
+    {
+        index_type vi;
+        index_type fi;
+        Eigen::Vector3d point;
+        Eigen::Vector3d normal;
+        Eigen::Vector3d barycentric_coordinates;
+    };
+
+    tetrahedral_mesh_boundary_t const* boundary_;
+    scalar_type thickness_;
+    scalar_type cell_size_;
+    scalar_type grid_cell_size_; ///< Cell size of the last grid, coarsened for large triangles
+
+    std::vector<index_type> adjacency_offsets_; ///< Offsets of each boundary vertex's neighbours
+    std::vector<index_type> adjacency_; ///< Sorted tet vertices sharing a tet with the vertex
+    std::vector<std::uint32_t> bucket_offsets_; ///< Prefix sums of entries per bucket
+    std::vector<cell_entry_t> entries_;         ///< Triangle cell entries sorted by bucket
+    std::vector<scalar_type> chunk_extents_;    ///< Largest triangle extent found per chunk
+    std::vector<std::vector<self_contact_t>> chunk_contacts_; ///< Contacts found per chunk
+};
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
+
+#endif // SBS_PHYSICS_COLLISION_SPATIAL_HASH_SELF_COLLISION_H
@@ -0,0 +1,243 @@
+#ifndef SBS_PHYSICS_COLLISION_WIDE_BVH_H
+#define SBS_PHYSICS_COLLISION_WIDE_BVH_H
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <sbs/aliases.h>
+#include <sbs/common/parallel.h>
+#include <vector>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+/**
+ * @brief 4-wide bounding box hierarchy collapsed from a binary hierarchy.
+ *
+ * Every node stores the bounds of its (up to 4) children in structure of arrays layout, such that
+ * a query tests all children of a node at once with packet (SIMD) arithmetic. Traversals use an
+ * explicit fixed-size stack instead of a queue, and query-specific child tests are inlined
+ * function objects rather than type-erased callbacks. Hierarchies too deep for the fixed-size
+ * stack, as built from degenerate inputs, are traversed with a heap allocated stack instead.
+ *
+ * Leaves reference contiguous ranges [begin, begin + count) of the entity list the hierarchy was
+ * built from, in the same order as the binary hierarchy's leaves.
+ */
+class wide_bvh_t
+{
+  public:
+    static std::size_t constexpr width          = 4u;
+    static std::size_t constexpr max_stack_size = 64u;
+    static std::int32_t constexpr empty_child   = std::numeric_limits<std::int32_t>::min();
+
+    struct node_t
+    {
+        Eigen::Array4d min_x, min_y, min_z; ///< Lower corners of the children's bounds
+        Eigen::Array4d max_x, max_y, max_z; ///< Upper corners of the children's bounds
+        std::array<std::int32_t, width>
+            children; ///< Child node index, or ~(leaf index) for leaf children
+        std::uint32_t child_count; ///< Children occupy the first child_count lanes
+    };
+
+    struct leaf_t
+    {
+        std::uint32_t begin;
+        std::uint32_t count;
+    };
+
+    wide_bvh_t() = default;
+
+    /**
+     * @brief Collapses a binary hierarchy into a 4-wide one and computes its bounds.
+     * @param binary_nodes Nodes of the binary hierarchy, root first. Nodes must provide
+     * children[2], begin, n and isLeaf(), like Discregrid::KDTree nodes.
+     * @param entities The binary hierarchy's entity list, which leaves' ranges refer to
+     * @param leaf_box Callable of signature void(std::uint32_t begin, std::uint32_t count,
+     * Eigen::AlignedBox3d& box) computing the bounds of the entities [begin, begin + count)
+     */
+    template <class BinaryNode, class LeafBoxFunc>
+    void build(
+        std::vector<BinaryNode> const& binary_nodes,
+        std::vector<unsigned int> const& entities,
+        LeafBoxFunc const& leaf_box);
+
+    /**
+     * @brief Recomputes the hierarchy's bounds, leaves in parallel, then internal nodes
+     * bottom-up. Does not allocate once the hierarchy has been built.
+     */
+    template <class LeafBoxFunc>
+    void refit(LeafBoxFunc const& leaf_box);
+
+    /**
+     * @brief Visits the hierarchy depth first.
+     * @param child_mask Callable of signature unsigned int(node_t const& node) returning the bit
+     * mask of the node's children to visit
+     * @param on_leaf Callable of signature void(std::uint32_t begin, std::uint32_t count) called
+     * for every visited leaf
+     */
+    template <class ChildMaskFunc, class LeafFunc>
+    void traverse(ChildMaskFunc const& child_mask, LeafFunc const& on_leaf) const;
+
+    /**
+     * @brief Visits the leaves whose bounds overlap box
+     */
+    template <class LeafFunc>
+    void query(Eigen::AlignedBox3d const& box, LeafFunc const& on_leaf) const;
+
+    /**
+     * @brief Visits the leaves whose bounds are hit by the ray origin + t * direction for
+     * t in [t_min, t_max]
+     */
+    template <class LeafFunc>
+    void raycast(
+        Eigen::Vector3d const& origin,
+        Eigen::Vector3d const& direction,
+        scalar_type t_min,
+        scalar_type t_max,
+        LeafFunc const& on_leaf) const;
+
+    static unsigned int overlap_mask(node_t const& node, Eigen::AlignedBox3d const& box);
+    static unsigned int ray_mask(
+        node_t const& node,
+        Eigen::Vector3d const& origin,
+        Eigen::Vector3d const& inverse_direction,
+        scalar_type t_min,
+        scalar_type t_max);
+
+    bool empty() const;
+    std::size_t node_count() const;
+    std::size_t leaf_count() const;
+    unsigned int entity(std::size_t i) const;
+    Eigen::AlignedBox3d bounds() const;
+    std::vector<node_t> const& nodes() const;
+    std::vector<leaf_t> const& leaves() const;
+
+    /**
+     * @brief Number of bytes used by the hierarchy's storage
+     */
+    std::size_t memory_footprint() const;
+
+  protected:
+    struct binary_node_t
+    {
+        std::int32_t children[2];
+        std::uint32_t begin;
+        std::uint32_t count;
+    };
+
+    void collapse(std::vector<binary_node_t> const& binary_nodes);
+    void refit_internal_nodes();
+
+  private:
+    std::vector<node_t> nodes_;                   ///< Nodes, parents before their children
+    std::vector<leaf_t> leaves_;                  ///< Entity ranges of the leaves
+    std::vector<unsigned int> entities_;          ///< Entities in binary leaf order
+    std::vector<Eigen::AlignedBox3d> leaf_boxes_; ///< Bounds of the leaves
+    std::size_t stack_capacity_ = 0u;             ///< Traversal stack entries needed at most
+};
+
+template <class BinaryNode, class LeafBoxFunc>
+inline void wide_bvh_t::build(
+    std::vector<BinaryNode> const& binary_nodes,
+    std::vector<unsigned int> const& entities,
+    LeafBoxFunc const& leaf_box)
+{
+    std::vector<binary_node_t> nodes(binary_nodes.size());
+    for (std::size_t i = 0u; i < binary_nodes.size(); ++i)
+    {
+        BinaryNode const& node = binary_nodes[i];
+        nodes[i].children[0]   = node.isLeaf() ? -1 : static_cast<std::int32_t>(node.children[0]);
+        nodes[i].children[1]   = node.isLeaf() ? -1 : static_cast<std::int32_t>(node.children[1]);
+        nodes[i].begin         = static_cast<std::uint32_t>(node.begin);
+        nodes[i].count         = static_cast<std::uint32_t>(node.n);
+    }
+    entities_.assign(entities.begin(), entities.end());
+
+    collapse(nodes);
+    refit(leaf_box);
+}
+
+template <class LeafBoxFunc>
+inline void wide_bvh_t::refit(LeafBoxFunc const& leaf_box)
+{
+    leaf_boxes_.resize(leaves_.size());
+    common::parallel_for(
+        leaves_.size(),
+        [&](std::size_t l) { leaf_box(leaves_[l].begin, leaves_[l].count, leaf_boxes_[l]); },
+        64u);
+
+    refit_internal_nodes();
+}
+
+template <class ChildMaskFunc, class LeafFunc>
+inline void wide_bvh_t::traverse(ChildMaskFunc const& child_mask, LeafFunc const& on_leaf) const
+{
+    if (nodes_.empty())
+        return;
+
+    std::array<std::int32_t, max_stack_size> fixed_stack;
+    std::vector<std::int32_t> heap_stack{};
+    std::int32_t* stack = fixed_stack.data();
+    if (stack_capacity_ > max_stack_size)
+    {
+        heap_stack.resize(stack_capacity_);
+        stack = heap_stack.data();
+    }
+
+    std::size_t stack_size = 0u;
+    stack[stack_size++]    = 0;
+    while (stack_size > 0u)
+    {
+        node_t const& node = nodes_[static_cast<std::size_t>(stack[--stack_size])];
+
+        unsigned int const mask = child_mask(node) & ((1u << node.child_count) - 1u);
+        for (std::uint32_t k = 0u; k < node.child_count; ++k)
+        {
+            if ((mask & (1u << k)) == 0u)
+                continue;
+
+            std::int32_t const child = node.children[k];
+            if (child >= 0)
+            {
+                assert(stack_size < stack_capacity_);
+                stack[stack_size++] = child;
+                continue;
+            }
+
+            leaf_t const& leaf = leaves_[static_cast<std::size_t>(~child)];
+            on_leaf(leaf.begin, leaf.count);
+        }
+    }
+}
+
+template <class LeafFunc>
+inline void wide_bvh_t::query(Eigen::AlignedBox3d const& box, LeafFunc const& on_leaf) const
+{
+    traverse([&box](node_t const& node) { return overlap_mask(node, box); }, on_leaf);
+}
+
+template <class LeafFunc>
+inline void wide_bvh_t::raycast(
+    Eigen::Vector3d const& origin,
+    Eigen::Vector3d const& direction,
+    scalar_type t_min,
+    scalar_type t_max,
+    LeafFunc const& on_leaf) const
+{
+    Eigen::Vector3d const inverse_direction = direction.cwiseInverse();
+    traverse(
+        [&](node_t const& node) {
+            return ray_mask(node, origin, inverse_direction, t_min, t_max);
+        },
+        on_leaf);
+}
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
+
+#endif // SBS_PHYSICS_COLLISION_WIDE_BVH_H
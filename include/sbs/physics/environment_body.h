@@ -13,16 +13,59 @@ struct geometry_t;
 
 namespace physics {
 
+namespace collision {
+class sdf_cache_t;
+} // namespace collision
+
 class environment_body_t : public body_t
 {
   public:
+    /**
+     * @brief Computes the signed distance grid of the geometry's triangle mesh.
+     *
+     * If an sdf cache is given, a grid previously computed from the same mesh, domain and
+     * resolution is loaded from it instead of being recomputed, and newly computed grids are
+     * stored in it.
+     */
+    environment_body_t(
+        simulation_t& simulation,
+        index_type id,
+        common::geometry_t const& geometry,
+        Eigen::AlignedBox3d const& domain,
+        std::array<unsigned int, 3u> const& resolution = {10, 10, 10},
+        collision::sdf_cache_t const* sdf_cache        = nullptr);
+
+    /**
+     * @brief Samples the signed distance function of the geometry's triangle mesh into a sparse
+     * narrow band grid of float samples.
+     * @param cell_size Edge length of the grid's cells
+     * @param narrow_band Distance to the mesh within which the grid stores fine samples
+     * @param far_field Distance at which coarse samples are clamped
+     */
     environment_body_t(
         simulation_t& simulation,
         index_type id,
         common::geometry_t const& geometry,
         Eigen::AlignedBox3d const& domain,
-        std::array<unsigned int, 3u> const& resolution = {10, 10, 10});
+        scalar_type cell_size,
+        scalar_type narrow_band,
+        scalar_type far_field);
+
+    /**
+     * @brief Collides against the geometry's triangle mesh directly, by closest point queries
+     * against a hierarchy of its triangles, without sampling its signed distance function. This
+     * builds much faster and uses less memory than a grid for large meshes, at the cost of
+     * slower queries. The mesh must be closed.
+     */
+    environment_body_t(
+        simulation_t& simulation,
+        index_type id,
+        common::geometry_t const& geometry);
 
+    /**
+     * @brief Instances sdf_model, whose sampled sdf is shared rather than copied. The body is
+     * placed with transform().
+     */
     environment_body_t(
         simulation_t& simulation,
         index_type id,
@@ -38,7 +81,13 @@ class environment_body_t : public body_t
     virtual void update_physical_model() override;
     virtual void transform(Eigen::Affine3d const& affine) override;
 
+    /**
+     * @brief Moves the body along its collider's linear and angular velocities for dt
+     */
+    virtual void advance(scalar_type dt) override;
+
     collision::sdf_model_t const& sdf() const;
+    collision::sdf_model_t& sdf();
 
   private:
     common::static_mesh_t visual_model_;
@@ -30,6 +30,30 @@ class tetrahedral_body_t : public body_t
         index_type id,
         std::vector<Eigen::Vector3d> const& positions,
         tetrahedron_set_t const& topology);
+
+    /**
+     * @brief Creates the body from a fully built topology and its boundary surface, such as those
+     * of a topology snapshot, without extracting the boundary surface. positions must hold one
+     * position per vertex of topology.
+     */
+    tetrahedral_body_t(
+        simulation_t& simulation,
+        index_type id,
+        std::vector<Eigen::Vector3d> const& positions,
+        tetrahedron_set_t topology,
+        boundary_surface_arrays_t boundary);
+
+    /**
+     * @brief Creates the body from views of a fully built topology's arrays, its boundary surface
+     * and its positions, such as those of a memory mapped topology snapshot. positions must hold
+     * one position per vertex of topology.
+     */
+    tetrahedral_body_t(
+        simulation_t& simulation,
+        index_type id,
+        common::array_view_t<Eigen::Vector3d> positions,
+        tetrahedron_set_array_views_t const& topology,
+        boundary_surface_array_views_t const& boundary);
     tetrahedral_body_t(simulation_t& simulation, index_type id, common::geometry_t const& geometry);
 
     virtual visual_model_type const& visual_model() const override;
@@ -1,17 +1,40 @@
 #ifndef SBS_PHYSICS_TETRAHEDRAL_MESH_BOUNDARY_H
 #define SBS_PHYSICS_TETRAHEDRAL_MESH_BOUNDARY_H
 
+#include <Eigen/Core>
+#include <array>
+#include <cstdint>
 #include <optional>
 #include <sbs/aliases.h>
+#include <sbs/common/array_view.h>
 #include <sbs/common/mesh.h>
 #include <sbs/common/node.h>
+#include <sbs/physics/topology.h>
 #include <vector>
 
 namespace sbs {
 namespace physics {
 
-// Forward declares
-class tetrahedron_set_t;
+/**
+ * @brief Flat arrays of a boundary surface, from which it is restored without extraction
+ */
+struct boundary_surface_arrays_t
+{
+    std::vector<index_type> vertex_index_map;   ///< Tet vertex index of every surface vertex
+    std::vector<index_type> triangle_index_map; ///< Tet triangle index of every surface triangle
+    std::vector<index_type> triangle_vertices;  ///< 3 surface vertex indices per triangle
+};
+
+/**
+ * @brief Views of the flat arrays of a boundary surface, see boundary_surface_arrays_t, owned
+ * elsewhere, such as by a memory mapped topology snapshot
+ */
+struct boundary_surface_array_views_t
+{
+    common::array_view_t<index_type> vertex_index_map;
+    common::array_view_t<index_type> triangle_index_map;
+    common::array_view_t<index_type> triangle_vertices;
+};
 
 /**
  * @brief Surface mesh representation of a tetrahedral mesh's boundary surface.
@@ -25,6 +48,20 @@ class tetrahedral_mesh_boundary_t : public common::shared_vertex_surface_mesh_i
     tetrahedral_mesh_boundary_t() = default;
     tetrahedral_mesh_boundary_t(tetrahedron_set_t* mesh);
 
+    /**
+     * @brief Restores the boundary surface of mesh from arrays previously returned by arrays(),
+     * instead of extracting it. Vertex attributes are left to the owning body.
+     */
+    tetrahedral_mesh_boundary_t(tetrahedron_set_t* mesh, boundary_surface_arrays_t arrays);
+
+    /**
+     * @brief Restores the boundary surface of mesh from views of arrays previously returned by
+     * arrays(), which are copied
+     */
+    tetrahedral_mesh_boundary_t(
+        tetrahedron_set_t* mesh,
+        boundary_surface_array_views_t const& arrays);
+
     tetrahedral_mesh_boundary_t(tetrahedral_mesh_boundary_t const& other) = default;
     tetrahedral_mesh_boundary_t(tetrahedral_mesh_boundary_t&& other)      = default;
     tetrahedral_mesh_boundary_t& operator=(tetrahedral_mesh_boundary_t const& other) = default;
@@ -36,6 +73,19 @@ class tetrahedral_mesh_boundary_t : public common::shared_vertex_surface_mesh_i
     virtual shared_vertex_surface_mesh_i::vertex_type vertex(std::size_t vi) const override;
     virtual shared_vertex_surface_mesh_i::triangle_type triangle(std::size_t f) const override;
 
+    /**
+     * @brief Counts extract_boundary_surface(), add_tetrahedron(), remove_tetrahedron() and
+     * mutable_triangle() calls as one topology edit each
+     */
+    virtual std::uint64_t topology_revision() const override;
+
+    /**
+     * @brief Only the ranges of the latest topology edits are kept, older revisions get all
+     * triangles
+     */
+    virtual std::pair<std::size_t, std::size_t>
+    edited_triangles(std::uint64_t revision) const override;
+
     virtual void prepare_vertices_for_rendering() override;
     virtual void prepare_indices_for_rendering() override;
 
@@ -68,12 +118,32 @@ class tetrahedral_mesh_boundary_t : public common::shared_vertex_surface_mesh_i
     index_type from_surface_triangle(std::size_t fi) const;
 
     /**
-     * @brief Recompute the tetrahedral mesh's boundary surface mesh
+     * @brief Recompute the tetrahedral mesh's boundary surface mesh. Required after the
+     * tetrahedral mesh was modified other than through add_tetrahedron() and
+     * remove_tetrahedron(), or after its garbage was collected.
      */
     void extract_boundary_surface();
 
+    /**
+     * @brief Adds a tetrahedron to the tetrahedral mesh and updates the boundary surface around
+     * its faces only. Surface vertices and triangles which stay on the boundary keep their
+     * indices, new ones are appended and removed ones are replaced by the last ones. Only the
+     * changed ranges of the render buffers are marked dirty.
+     * @return The index of the added tetrahedron
+     */
+    index_type add_tetrahedron(tetrahedron_t const& tetrahedron);
+
+    /**
+     * @brief Removes the tetrahedron ti from the tetrahedral mesh and updates the boundary surface
+     * around its faces only, like add_tetrahedron().
+     * @return The removed tetrahedron
+     */
+    tetrahedron_t remove_tetrahedron(index_type ti);
+
     void compute_normals();
 
+    boundary_surface_arrays_t arrays() const;
+
     tetrahedron_set_t const* tetrahedral_mesh() const;
     tetrahedron_set_t* tetrahedral_mesh();
 
@@ -83,6 +153,39 @@ class tetrahedral_mesh_boundary_t : public common::shared_vertex_surface_mesh_i
     void prepare_vertices_for_wireframe_rendering();
     void prepare_indices_for_wireframe_rendering();
 
+    /**
+     * @brief Adds, keeps or removes the surface triangles of the tetrahedral mesh's triangles fis
+     * depending on whether they lie on the boundary
+     */
+    void update_boundary_triangles(std::array<index_type, 4u> const& fis);
+
+    /**
+     * @return A half-face of an existing tetrahedron on triangle fi without opposite half-face,
+     * or no_half_face if fi is an interior or removed triangle
+     */
+    index_type boundary_half_face_of(index_type fi) const;
+    void add_surface_triangle(index_type h);
+    void remove_surface_triangle(index_type fi);
+    index_type surface_vertex_of(index_type vi);
+    void remove_surface_vertex_if_unused(index_type vi);
+    void rebuild_vertex_triangles();
+
+    /**
+     * @brief Starts the topology edit of a new revision, which mark_triangles_edited() extends
+     */
+    void begin_topology_edit();
+    void mark_triangles_edited(std::size_t begin, std::size_t end);
+
+    /**
+     * @brief Surface triangles [begin, end) changed by the topology edit of a revision
+     */
+    struct triangle_edit_t
+    {
+        std::uint64_t revision;
+        std::size_t begin;
+        std::size_t end;
+    };
+
     tetrahedron_set_t* mesh_;
     std::vector<index_type>
         vertex_index_map_; ///< Maps from surface vertex indices to tet vertex indices
@@ -91,9 +194,17 @@ class tetrahedral_mesh_boundary_t : public common::shared_vertex_surface_mesh_i
                                           ///< indices
     std::vector<index_type>
         triangle_index_map_; ///< Maps from surface face indices to tet triangle indices
-
-    std::vector<vertex_type> vertices_;    ///< Surface mesh vertices
-    std::vector<triangle_type> triangles_; ///< Surface mesh triangles
+    std::vector<std::optional<index_type>>
+        tet_to_surface_triangle_index_map_; ///< Maps from tet triangle indices to surface face
+                                            ///< indices
+
+    std::vector<vertex_type> vertices_;             ///< Surface mesh vertices
+    std::vector<triangle_type> triangles_;          ///< Surface mesh triangles
+    csr_incidence_t vertex_triangles_;              ///< Surface triangles incident to each vertex
+    bool are_vertex_triangles_outdated_ = false;    ///< True after incremental updates
+    std::vector<Eigen::Vector3d> triangle_normals_; ///< Area weighted surface triangle normals
+    std::uint64_t topology_revision_ = 0u;          ///< Number of topology edits so far
+    std::vector<triangle_edit_t> triangle_edits_;   ///< Triangles changed by the latest edits
 };
 
 } // namespace physics
@@ -28,6 +28,15 @@ class timestep_t
     std::size_t substeps() const;
     std::size_t& substeps();
 
+    /**
+     * @brief If true, the broad phase runs once per step, with a margin covering the particles'
+     * motion over the step, and the narrow phase is run again on its candidate pairs before every
+     * substep, such that collision constraints use up to date contact points and normals.
+     * Defaults to false, in which case contacts are only detected once per step.
+     */
+    bool refresh_contacts_every_substep() const;
+    bool& refresh_contacts_every_substep();
+
     std::unique_ptr<solver_t> const& solver() const;
     std::unique_ptr<solver_t>& solver();
 
@@ -35,6 +44,7 @@ class timestep_t
     scalar_type dt_{0.};
     std::size_t iterations_{0u};
     std::size_t substeps_{0u};
+    bool refresh_contacts_every_substep_{false};
     std::unique_ptr<solver_t> solver_{};
 };
 
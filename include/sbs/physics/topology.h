@@ -2,9 +2,13 @@
 #define SBS_PHYSICS_TOPOLOGY_H
 
 #include <array>
-#include <map>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
 #include <sbs/aliases.h>
-#include <set>
+#include <sbs/common/array_view.h>
+#include <sbs/common/flat_hash_map.h>
 #include <vector>
 
 namespace sbs {
@@ -51,6 +55,12 @@ class edge_t
     std::vector<index_type>& incident_tetrahedron_indices();
     std::uint8_t id_of_vertex(index_type vi) const;
     bool is_reverse_of(edge_t const& other) const;
+
+    /**
+     * @brief Packs the sorted vertex indices, such that both orientations share the same key
+     */
+    std::uint64_t key() const;
+
     bool operator==(edge_t const&) const;
     bool operator<(edge_t const&) const;
 
@@ -82,6 +92,11 @@ class triangle_t
     std::uint8_t id_of_edge(index_type ei) const;
     bool is_reverse_of(triangle_t const& other) const;
 
+    /**
+     * @brief Sorted vertex indices, such that all orientations share the same key
+     */
+    std::array<index_type, 3u> key() const;
+
     bool operator==(triangle_t const& other) const;
     bool operator<(triangle_t const& other) const;
 
@@ -127,6 +142,172 @@ class tetrahedron_t
     std::array<index_type, 4u> faces_; ///< Face indices
 };
 
+/**
+ * @brief Rows in compressed sparse row form whose arrays are owned elsewhere, see csr_incidence_t
+ */
+struct csr_incidence_view_t
+{
+    common::array_view_t<index_type> offsets;
+    common::array_view_t<index_type> entries;
+};
+
+/**
+ * @brief Incidence lists of a number of rows stored contiguously in compressed sparse row form.
+ * The entries of row i are entries()[offsets()[i]] to entries()[offsets()[i + 1] - 1].
+ */
+class csr_incidence_t
+{
+  public:
+    static index_type constexpr no_row = std::numeric_limits<index_type>::max();
+
+    /**
+     * @brief Contiguous range of a row's entries
+     */
+    class row_type
+    {
+      public:
+        row_type(index_type const* begin, index_type const* end) : begin_(begin), end_(end) {}
+
+        index_type const* begin() const { return begin_; }
+        index_type const* end() const { return end_; }
+        std::size_t size() const { return static_cast<std::size_t>(end_ - begin_); }
+        bool empty() const { return begin_ == end_; }
+        index_type operator[](std::size_t i) const { return begin_[i]; }
+
+      private:
+        index_type const* begin_;
+        index_type const* end_;
+    };
+
+    csr_incidence_t() = default;
+
+    /**
+     * @brief Rebuilds the rows from count primitives with arity incidences each. Primitive p is
+     * appended to row incident(p, k) for every k in [0, arity), unless that row is no_row, such
+     * that every row lists its primitives in increasing order.
+     */
+    template <class IncidentFunc>
+    void assign(
+        std::size_t row_count,
+        std::size_t count,
+        std::size_t arity,
+        IncidentFunc const& incident);
+
+    /**
+     * @brief Takes over rows in compressed sparse row form, as returned by offsets() and
+     * entries()
+     */
+    void assign_rows(std::vector<index_type> offsets, std::vector<index_type> entries);
+
+    /**
+     * @brief Copies rows in compressed sparse row form
+     */
+    void assign_rows(csr_incidence_view_t const& rows);
+
+    row_type operator[](std::size_t i) const;
+    std::size_t row_count() const;
+    std::size_t count(std::size_t i) const;
+
+    std::vector<index_type> const& offsets() const;
+    std::vector<index_type> const& entries() const;
+
+  private:
+    std::vector<index_type> offsets_; ///< Row i's entries start at offsets_[i]
+    std::vector<index_type> entries_; ///< Entries of all rows, row after row
+};
+
+template <class IncidentFunc>
+inline void csr_incidence_t::assign(
+    std::size_t row_count,
+    std::size_t count,
+    std::size_t arity,
+    IncidentFunc const& incident)
+{
+    offsets_.assign(row_count + 1u, 0u);
+    for (std::size_t p = 0u; p < count; ++p)
+    {
+        for (std::size_t k = 0u; k < arity; ++k)
+        {
+            index_type const row = incident(p, k);
+            if (row != no_row)
+                ++offsets_[row + 1u];
+        }
+    }
+    std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+
+    entries_.resize(offsets_.back());
+    std::vector<index_type> ends(offsets_.begin(), offsets_.end() - 1);
+    for (std::size_t p = 0u; p < count; ++p)
+    {
+        for (std::size_t k = 0u; k < arity; ++k)
+        {
+            index_type const row = incident(p, k);
+            if (row != no_row)
+                entries_[ends[row]++] = static_cast<index_type>(p);
+        }
+    }
+}
+
+/**
+ * @brief Incidences between all primitives of a tetrahedron set
+ */
+struct topology_incidences_t
+{
+    csr_incidence_t vertex_edges;
+    csr_incidence_t vertex_triangles;
+    csr_incidence_t vertex_tetrahedra;
+    csr_incidence_t edge_triangles;
+    csr_incidence_t edge_tetrahedra;
+    csr_incidence_t triangle_tetrahedra;
+};
+
+/**
+ * @brief Views of the incidences between all primitives of a tetrahedron set
+ */
+struct topology_incidence_views_t
+{
+    csr_incidence_view_t vertex_edges;
+    csr_incidence_view_t vertex_triangles;
+    csr_incidence_view_t vertex_tetrahedra;
+    csr_incidence_view_t edge_triangles;
+    csr_incidence_view_t edge_tetrahedra;
+    csr_incidence_view_t triangle_tetrahedra;
+};
+
+/**
+ * @brief Flat arrays of a tetrahedron set without removed primitives, from which the set is
+ * restored without deduplicating its edges and faces again
+ */
+struct tetrahedron_set_arrays_t
+{
+    std::size_t vertex_count = 0u;
+    std::vector<index_type> edge_vertices;        ///< 2 vertex indices per edge
+    std::vector<index_type> triangle_vertices;    ///< 3 vertex indices per triangle
+    std::vector<index_type> triangle_edges;       ///< 3 edge indices per triangle
+    std::vector<index_type> tetrahedron_vertices; ///< 4 vertex indices per tetrahedron
+    std::vector<index_type> tetrahedron_edges;    ///< 6 edge indices per tetrahedron
+    std::vector<index_type> tetrahedron_faces;    ///< 4 triangle indices per tetrahedron
+    std::vector<index_type> opposite_half_faces;  ///< Opposite half-face of every half-face
+    topology_incidences_t incidences;             ///< Incidences of all primitives
+};
+
+/**
+ * @brief Views of the flat arrays of a tetrahedron set, see tetrahedron_set_arrays_t, owned
+ * elsewhere, such as by a memory mapped topology snapshot
+ */
+struct tetrahedron_set_array_views_t
+{
+    std::size_t vertex_count = 0u;
+    common::array_view_t<index_type> edge_vertices;
+    common::array_view_t<index_type> triangle_vertices;
+    common::array_view_t<index_type> triangle_edges;
+    common::array_view_t<index_type> tetrahedron_vertices;
+    common::array_view_t<index_type> tetrahedron_edges;
+    common::array_view_t<index_type> tetrahedron_faces;
+    common::array_view_t<index_type> opposite_half_faces;
+    topology_incidence_views_t incidences;
+};
+
 class vertex_set_t
 {
   public:
@@ -134,7 +315,6 @@ class vertex_set_t
     template <class VertexIterator>
     vertex_set_t(VertexIterator begin, VertexIterator end);
     vertex_t const& vertex(std::size_t vi) const;
-    vertex_t& vertex(std::size_t vi);
 
     bool contains_vertex(vertex_t const& v) const;
 
@@ -151,6 +331,21 @@ class vertex_set_t
     void remove_vertex_to_tetrahedron_incidency(index_type const vi, index_type ti);
     bool operator==(vertex_set_t const& other) const;
 
+  protected:
+    /**
+     * @brief Mutable access for the set's own modifications, which update revision_. Other code
+     * only reads primitives, such that the incidences cached from them never go stale.
+     */
+    vertex_t& mutable_vertex(std::size_t vi);
+
+    /**
+     * @brief Fills the incidence lists of the primitives if a derived set deferred them. Every
+     * edit of the set's primitives or incidences calls it first.
+     */
+    virtual void build_deferred_incidence_lists() {}
+
+    std::uint64_t revision_ = 1u; ///< Incremented by every modification of the set
+
   private:
     std::vector<vertex_t> vertices_; ///< Vertices of this set
 };
@@ -163,10 +358,11 @@ inline vertex_set_t::vertex_set_t(VertexIterator begin, VertexIterator end) : ve
 class edge_set_t : public vertex_set_t
 {
   public:
+    using edge_map_type = common::flat_hash_map_t<std::uint64_t, index_type>;
+
     edge_set_t() = default;
 
     edge_t const& edge(index_type ei) const;
-    edge_t& edge(index_type ei);
     index_type ei(edge_t const& edge) const;
     index_type add_edge(edge_t const& edge);
     edge_t remove_edge(index_type ei);
@@ -178,10 +374,13 @@ class edge_set_t : public vertex_set_t
     bool is_safe_to_iterate_over_edges() const;
 
     std::vector<edge_t> const& edges() const;
-    std::vector<edge_t>& edges();
 
-    std::map<edge_t, index_type>::const_iterator safe_edges_begin() const;
-    std::map<edge_t, index_type>::const_iterator safe_edges_end() const;
+    /**
+     * @brief Iterates over the (edge key, edge index) pairs of existing edges in unspecified
+     * order, which remains valid while removed edges have not been collected
+     */
+    edge_map_type::const_iterator safe_edges_begin() const;
+    edge_map_type::const_iterator safe_edges_end() const;
 
     void remove_edge_to_triangle_incidency(index_type const ei, index_type fi);
     void remove_edge_to_tetrahedron_incidency(index_type const ei, index_type ti);
@@ -189,9 +388,11 @@ class edge_set_t : public vertex_set_t
     bool operator==(edge_set_t const& other) const;
 
   protected:
-    std::map<edge_t, index_type> edge_map_; ///< Map from edge to edge indices
-    std::set<index_type>
-        edge_garbage_collector_; ///< Set of indices that can be reused for edge creation
+    edge_t& mutable_edge(index_type ei);
+    std::vector<edge_t>& mutable_edges();
+
+    edge_map_type edge_map_;                         ///< Map from edge keys to edge indices
+    std::vector<index_type> edge_garbage_collector_; ///< Min-heap of deleted edges
 
   private:
     std::vector<edge_t> edges_; ///< Edges of this set
@@ -200,13 +401,14 @@ class edge_set_t : public vertex_set_t
 class triangle_set_t : public edge_set_t
 {
   public:
+    using triangle_map_type = common::flat_hash_map_t<std::array<index_type, 3u>, index_type>;
+
     triangle_set_t() = default;
 
     triangle_t const& triangle(index_type fi) const;
-    triangle_t& triangle(index_type fi);
     index_type fi(triangle_t const& triangle) const;
 
-    void add_triangle(triangle_t const& triangle);
+    index_type add_triangle(triangle_t const& triangle);
     triangle_t remove_triangle(index_type fi);
     triangle_t remove_triangle(triangle_t const& triangle);
 
@@ -217,9 +419,13 @@ class triangle_set_t : public edge_set_t
     bool is_safe_to_iterate_over_triangles() const;
 
     std::vector<triangle_t> const& triangles() const;
-    std::vector<triangle_t>& triangles();
-    std::map<triangle_t, index_type>::const_iterator safe_triangles_begin() const;
-    std::map<triangle_t, index_type>::const_iterator safe_triangles_end() const;
+
+    /**
+     * @brief Iterates over the (triangle key, triangle index) pairs of existing triangles in
+     * unspecified order, which remains valid while removed triangles have not been collected
+     */
+    triangle_map_type::const_iterator safe_triangles_begin() const;
+    triangle_map_type::const_iterator safe_triangles_end() const;
 
     void create_vertex_to_triangle_incidency(index_type const fi);
     void create_edge_to_triangle_incidency(index_type const fi);
@@ -227,8 +433,11 @@ class triangle_set_t : public edge_set_t
     bool operator==(triangle_set_t const& other) const;
 
   protected:
-    std::map<triangle_t, index_type> triangle_map_;   ///< Map of triangles to their indices
-    std::set<index_type> triangle_garbage_collector_; ///< Indices of deleted triangles
+    triangle_t& mutable_triangle(index_type fi);
+    std::vector<triangle_t>& mutable_triangles();
+
+    triangle_map_type triangle_map_;                     ///< Map of triangle keys to indices
+    std::vector<index_type> triangle_garbage_collector_; ///< Min-heap of deleted triangles
 
   private:
     std::vector<triangle_t> triangles_; ///< Triangles of this set
@@ -237,12 +446,43 @@ class triangle_set_t : public edge_set_t
 class tetrahedron_set_t : public triangle_set_t
 {
   public:
+    static index_type constexpr no_half_face = std::numeric_limits<index_type>::max();
+
     tetrahedron_set_t() = default;
 
     tetrahedron_t const& tetrahedron(index_type ti) const;
-    tetrahedron_t& tetrahedron(index_type ti);
 
-    void add_tetrahedron(tetrahedron_t const& tetrahedron);
+    index_type add_tetrahedron(tetrahedron_t const& tetrahedron);
+
+    /**
+     * @brief Replaces this set's contents by the tetrahedra of an index buffer holding 4 vertex
+     * indices per tetrahedron. Edges and faces are deduplicated by parallel radix sorts and all
+     * incidences are filled at once. The result is identical to adding the tetrahedra in order
+     * to an empty set with add_tetrahedron().
+     */
+    void assign_tetrahedra(std::vector<index_type> const& indices);
+
+    /**
+     * @brief Flattens this set, which must not hold removed primitives, see collect_garbage()
+     */
+    tetrahedron_set_arrays_t arrays() const;
+
+    /**
+     * @brief Replaces this set's contents by arrays previously returned by arrays(). Primitives,
+     * half-faces and incidences are taken over as they are, and incidences() is served from the
+     * restored incidences. The edge and triangle maps are built concurrently, while the
+     * incidence lists of the primitives are built on the first edit of the set's primitives or
+     * incidences. Until then, the lists of vertex(), edge() and triangle() are empty.
+     */
+    void assign_arrays(tetrahedron_set_arrays_t arrays);
+
+    /**
+     * @brief Replaces this set's contents by views of arrays previously returned by arrays(),
+     * which are read in place and copied once into the set, see
+     * assign_arrays(tetrahedron_set_arrays_t)
+     */
+    void assign_arrays(tetrahedron_set_array_views_t const& arrays);
+
     tetrahedron_t remove_tetrahedron(index_type ti);
 
     std::size_t tetrahedron_count() const;
@@ -251,7 +491,6 @@ class tetrahedron_set_t : public triangle_set_t
     bool is_safe_to_iterate_over_tetrahedra() const;
 
     std::vector<tetrahedron_t> const& tetrahedra() const;
-    std::vector<tetrahedron_t>& tetrahedra();
 
     void create_vertex_to_tetrahedron_incidency(index_type const ti);
     void create_edge_to_tetrahedron_incidency(index_type const ti);
@@ -259,15 +498,72 @@ class tetrahedron_set_t : public triangle_set_t
 
     void collect_garbage();
 
+    /**
+     * @brief Incidences of all primitives in compressed sparse row form, each row in increasing
+     * index order. They are rebuilt on the first call after the set was modified, which is only
+     * possible through its add, remove, assign, clear or garbage collection functions, which
+     * must not run concurrently with that call. Rows of removed primitives are empty.
+     */
+    topology_incidences_t const& incidences() const;
+
+    /**
+     * @brief The half-face 4 * ti + f denotes the local face f of tetrahedron ti, in the order of
+     * its face_indices(). Every half-face is paired with the half-face of the other tetrahedron
+     * sharing its triangle, which is maintained through add, remove, assign and garbage
+     * collection. Faces shared by more than two tetrahedra only pair the first two of them.
+     * @return The half-face opposite to local face f of tetrahedron ti, or no_half_face if that
+     * face lies on the boundary
+     */
+    index_type opposite_half_face(index_type ti, std::uint8_t f) const;
+
+    /**
+     * @return The tetrahedron sharing local face f of tetrahedron ti, if any
+     */
+    std::optional<index_type> neighbor(index_type ti, std::uint8_t f) const;
+    bool is_boundary_face(index_type ti, std::uint8_t f) const;
+
+    /**
+     * @return The opposite half-face of every half-face, including those of removed tetrahedra,
+     * which are no_half_face
+     */
+    std::vector<index_type> const& opposite_half_faces() const;
+
+    /**
+     * @return The half-faces of existing tetrahedra without opposite half-face, in increasing
+     * order
+     */
+    std::vector<index_type> boundary_half_faces() const;
+
     bool operator==(tetrahedron_set_t const& other) const;
 
   protected:
-    std::set<index_type> tetrahedron_garbage_collector_; ///< Indices of deleted tetrahedra
+    tetrahedron_t& mutable_tetrahedron(index_type ti);
+    std::vector<tetrahedron_t>& mutable_tetrahedra();
+
+    std::vector<index_type> tetrahedron_garbage_collector_; ///< Min-heap of deleted tetrahedra
+    std::vector<index_type> opposite_half_faces_;           ///< Opposite half-face of half-faces
+    mutable topology_incidences_t incidences_;               ///< Cache of incidences()
+    mutable std::uint64_t incidences_revision_ = 0u;         ///< revision_ of incidences_
+    bool are_incidence_lists_deferred_ = false;              ///< Set until the first edit
 
   private:
+    /**
+     * @brief Fills the primitives from flat arrays, see assign_arrays()
+     */
+    template <class Arrays>
+    void assign_primitives(Arrays const& arrays);
+
+    /**
+     * @brief Fills the incidence lists of the primitives from incidences_ if assign_arrays()
+     * deferred them
+     */
+    void build_deferred_incidence_lists() override;
+
     void swap_edges(index_type ei, index_type eip);
     void swap_triangles(index_type fi, index_type fip);
     void swap_tetrahedra(index_type ti, index_type tip);
+    void pair_half_face(index_type ti, std::uint8_t f);
+    void unpair_half_face(index_type h);
 
     std::vector<tetrahedron_t> tetrahedra_; ///< Tetrahedra of this set
 };
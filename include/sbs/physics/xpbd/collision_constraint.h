@@ -22,10 +22,20 @@ class collision_constraint_t : public constraint_t
         index_type bi /*penetrating body*/,
         index_type vi /*penetrating vertex*/,
         Eigen::Vector3d const& p, /*contact point*/
-        Eigen::Vector3d const& n /*surface normal of correction*/);
+        Eigen::Vector3d const& n /*surface normal of correction*/,
+        Eigen::Vector3d const& v = Eigen::Vector3d::Zero() /*velocity of the contact point*/);
 
     virtual void project_positions(simulation_t& simulation, scalar_type dt) override;
-    scalar_type evaluate(Eigen::Vector3d const& p) const;
+
+    /**
+     * @brief Signed distance of p to the contact plane at the end of the current substep of
+     * length dt. The plane moves along with the velocity of the contact point from the time the
+     * contact was found, such that contacts reused over several substeps follow their collider.
+     */
+    scalar_type evaluate(Eigen::Vector3d const& p, scalar_type dt) const;
+
+  protected:
+    virtual void prepare_for_projection_impl(simulation_t& simulation) override;
 
   private:
     index_type bi_; ///< Penetrating body
@@ -33,6 +43,10 @@ class collision_constraint_t : public constraint_t
 
     Eigen::Vector3d qs_; ///< Intersection point
     Eigen::Vector3d n_;  ///< Normal at intersection point
+    Eigen::Vector3d vs_; ///< Velocity of the intersection point
+
+    scalar_type elapsed_;   ///< Time from the contact's detection to the current substep
+    scalar_type solved_dt_; ///< Length of the last substep the constraint was projected in
 };
 
 } // namespace xpbd
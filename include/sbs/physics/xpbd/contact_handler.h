@@ -17,6 +17,17 @@ class contact_handler_t : public collision::contact_handler_t
 
     virtual void handle(collision::contact_t const& contact) override;
 
+    /**
+     * @brief Creates a collision constraint per contact, looking up the bodies and their
+     * surfaces once per batch
+     */
+    virtual void handle(
+        collision::surface_mesh_particle_to_sdf_contact_t const* contacts,
+        std::size_t count) override;
+    virtual void handle(
+        collision::surface_mesh_particle_to_triangle_contact_t const* contacts,
+        std::size_t count) override;
+
   private:
     simulation_t& simulation_;
 };
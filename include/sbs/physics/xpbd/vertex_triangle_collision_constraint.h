@@ -0,0 +1,56 @@
+#ifndef SBS_PHYSICS_XPBD_VERTEX_TRIANGLE_COLLISION_CONSTRAINT_H
+#define SBS_PHYSICS_XPBD_VERTEX_TRIANGLE_COLLISION_CONSTRAINT_H
+
+#include <Eigen/Core>
+#include <sbs/physics/constraint.h>
+
+namespace sbs {
+namespace physics {
+
+// Forward declares
+class simulation_t;
+
+namespace xpbd {
+
+/**
+ * @brief Non-penetration constraint between a vertex of one body and a triangle of another.
+ *
+ * C(x, x1, x2, x3) = (x - (u*x1 + v*x2 + w*x3)) . n >= 0,
+ * where (u,v,w) are the barycentric coordinates of the contact point on the triangle and n is the
+ * triangle's outward normal at the time of contact, both held constant during projection.
+ */
+class vertex_triangle_collision_constraint_t : public constraint_t
+{
+  public:
+    vertex_triangle_collision_constraint_t(
+        scalar_type alpha /*compliance*/,
+        scalar_type beta /*damping*/,
+        simulation_t const& simulation,
+        index_type bi /*penetrating body*/,
+        index_type vi /*penetrating vertex*/,
+        index_type bj /*penetrated body*/,
+        index_type v1 /*penetrated triangle's first vertex*/,
+        index_type v2 /*penetrated triangle's second vertex*/,
+        index_type v3 /*penetrated triangle's third vertex*/,
+        Eigen::Vector3d const& barycentric_coordinates /*contact point on the triangle*/,
+        Eigen::Vector3d const& n /*outward normal of the penetrated triangle*/);
+
+    virtual void project_positions(simulation_t& simulation, scalar_type dt) override;
+
+  private:
+    index_type bi_; ///< Penetrating body
+    index_type vi_; ///< Index of penetrating vertex
+    index_type bj_; ///< Penetrated body
+    index_type v1_; ///< Indices of the penetrated triangle's vertices
+    index_type v2_;
+    index_type v3_;
+
+    Eigen::Vector3d barycentric_coordinates_; ///< Contact point on the triangle
+    Eigen::Vector3d n_;                       ///< Normal at contact point
+};
+
+} // namespace xpbd
+} // namespace physics
+} // namespace sbs
+
+#endif // SBS_PHYSICS_XPBD_VERTEX_TRIANGLE_COLLISION_CONSTRAINT_H
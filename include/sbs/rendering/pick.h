@@ -14,6 +14,13 @@ namespace common {
 class shared_vertex_surface_mesh_i;
 
 } // namespace common
+namespace physics {
+namespace collision {
+
+class wide_bvh_t;
+
+} // namespace collision
+} // namespace physics
 } // namespace sbs
 
 struct GLFWwindow;
@@ -31,6 +38,16 @@ class picker_t
         renderer_t const* renderer,
         std::vector<common::shared_vertex_surface_mesh_i*> const& nodes);
 
+    /**
+     * @param bvhs Hierarchy of every node's triangles, such as triangle_bvh_t::wide_bvh(), which
+     * only the triangles hit by the picking ray are tested with. Null or empty hierarchies fall
+     * back to testing all of the node's triangles.
+     */
+    picker_t(
+        renderer_t const* renderer,
+        std::vector<common::shared_vertex_surface_mesh_i*> const& nodes,
+        std::vector<physics::collision::wide_bvh_t const*> const& bvhs);
+
     void mouse_button_pressed_event(GLFWwindow* window, int button, int action, int mods);
     void mouse_moved_event(GLFWwindow* window, double x, double y);
     bool is_picking() const;
@@ -68,6 +85,7 @@ class picker_t
 
     renderer_t const* renderer_;
     std::vector<common::shared_vertex_surface_mesh_i*> nodes_;
+    std::vector<physics::collision::wide_bvh_t const*> bvhs_;
     std::vector<bool> is_node_picked_;
     std::vector<std::uint32_t> picked_vertices_;
     bool is_picking_;
@@ -90,9 +108,28 @@ std::optional<
     std::tuple<std::uint32_t /* hit triangle */, double /* u */, double /* v */, double /* w */>>
 pick(common::ray_t const& ray, common::shared_vertex_surface_mesh_i const& mesh);
 
+/**
+ * Same as pick(ray, mesh), but only tests the triangles of the leaves of bvh hit by the ray. The
+ * entities of bvh must be the triangle indices of mesh.
+ */
+std::optional<
+    std::tuple<std::uint32_t /* hit triangle */, double /* u */, double /* v */, double /* w */>>
+pick(
+    common::ray_t const& ray,
+    common::shared_vertex_surface_mesh_i const& mesh,
+    physics::collision::wide_bvh_t const& bvh);
+
 std::optional<std::uint32_t>
 pick_vertex(common::ray_t const& ray, common::shared_vertex_surface_mesh_i const& mesh);
 
+/**
+ * Same as pick_vertex(ray, mesh), but picks the triangle with pick(ray, mesh, bvh)
+ */
+std::optional<std::uint32_t> pick_vertex(
+    common::ray_t const& ray,
+    common::shared_vertex_surface_mesh_i const& mesh,
+    physics::collision::wide_bvh_t const& bvh);
+
 } // namespace rendering
 } // namespace sbs
 
@@ -2,6 +2,7 @@
 #include <imgui/imgui.h>
 #include <sbs/geometry/get_simple_bar_model.h>
 #include <sbs/geometry/get_simple_plane_model.h>
+#include <sbs/geometry/reorder_for_locality.h>
 #include <sbs/physics/collision/brute_force_cd_system.h>
 #include <sbs/physics/environment_body.h>
 #include <sbs/physics/gauss_seidel_solver.h>
@@ -23,6 +24,8 @@ int main(int argc, char** argv)
 
     sbs::common::geometry_t beam_geometry = sbs::geometry::get_simple_bar_model(4u, 4u, 12u);
     beam_geometry.set_color(255, 255, 0);
+    // particles, tetrahedra and their constraints follow the reordered geometry
+    sbs::geometry::reorder_for_locality(beam_geometry);
     auto const beam_idx = static_cast<sbs::index_type>(simulation.bodies().size());
     simulation.add_body();
     simulation.bodies()[beam_idx] =
@@ -52,6 +55,10 @@ int main(int argc, char** argv)
             E,
             nu));
     }
+    // the beam bends far enough for its surface to fold onto itself
+    beam.bvh().enable_self_collision(&beam.surface_mesh());
+    // bounding boxes also give the beam's triangles a wide hierarchy to pick them with
+    beam.bvh().use_bounding_volume(sbs::physics::collision::bounding_volume_t::aabb);
 
     sbs::common::geometry_t floor_geometry =
         sbs::geometry::get_simple_plane_model({-20., -20.}, {20., 20.}, 0., 1e-2);
@@ -139,7 +146,10 @@ int main(int argc, char** argv)
     surfaces_to_pick.push_back(
         reinterpret_cast<sbs::common::shared_vertex_surface_mesh_i*>(&beam.surface_mesh()));
 
-    sbs::rendering::picker_t fix_picker{&renderer, surfaces_to_pick};
+    std::vector<sbs::physics::collision::wide_bvh_t const*> bvhs_to_pick{};
+    bvhs_to_pick.push_back(&beam.bvh().triangle_bvh().wide_bvh());
+
+    sbs::rendering::picker_t fix_picker{&renderer, surfaces_to_pick, bvhs_to_pick};
     fix_picker.should_picking_start = [](int button, int action, int mods) {
         return (
             button == GLFW_MOUSE_BUTTON_LEFT && mods == GLFW_MOD_CONTROL && action == GLFW_PRESS);
@@ -9,6 +9,17 @@
 namespace sbs {
 namespace common {
 
+std::uint64_t shared_vertex_surface_mesh_i::topology_revision() const
+{
+    return 0u;
+}
+
+std::pair<std::size_t, std::size_t>
+shared_vertex_surface_mesh_i::edited_triangles(std::uint64_t revision) const
+{
+    return {0u, triangle_count()};
+}
+
 static_mesh_t::static_mesh_t(common::geometry_t const& geometry)
 {
     bool const is_triangle_mesh =
@@ -148,6 +159,22 @@ shared_vertex_surface_mesh_i::triangle_type static_mesh_t::triangle(std::size_t
     return t;
 }
 
+void static_mesh_t::transform(Eigen::Affine3d const& affine)
+{
+    std::vector<float> vertex_buffer    = get_cpu_vertex_buffer();
+    Eigen::Matrix3d const normal_matrix = affine.linear().inverse().transpose();
+    for (std::size_t idx = 0u; idx < vertex_buffer.size(); idx += 9u)
+    {
+        Eigen::Map<Eigen::Vector3f> position(vertex_buffer.data() + idx);
+        Eigen::Map<Eigen::Vector3f> normal(vertex_buffer.data() + idx + 3u);
+
+        position = (affine * position.cast<double>()).cast<float>();
+        normal   = (normal_matrix * normal.cast<double>()).normalized().cast<float>();
+    }
+    transfer_vertices_for_rendering(std::move(vertex_buffer));
+    mark_vertices_dirty();
+}
+
 dynamic_surface_mesh::dynamic_surface_mesh(geometry_t const& geometry)
 {
     auto const num_vertices = geometry.positions.size() / 3u;
@@ -1,5 +1,7 @@
 #include "sbs/common/node.h"
 
+#include <algorithm>
+
 namespace sbs {
 namespace common {
 
@@ -61,11 +63,29 @@ unsigned int& renderable_node_t::EBO()
 void renderable_node_t::mark_vertices_dirty()
 {
     render_state_.should_transfer_vertices = true;
+    render_state_.dirty_vertices_begin     = 0u;
+    render_state_.dirty_vertices_end       = std::numeric_limits<std::size_t>::max();
 }
 
 void renderable_node_t::mark_indices_dirty()
 {
     render_state_.should_transfer_indices = true;
+    render_state_.dirty_indices_begin     = 0u;
+    render_state_.dirty_indices_end       = std::numeric_limits<std::size_t>::max();
+}
+
+void renderable_node_t::mark_vertices_dirty(std::size_t begin, std::size_t end)
+{
+    render_state_.should_transfer_vertices = true;
+    render_state_.dirty_vertices_begin     = std::min(render_state_.dirty_vertices_begin, begin);
+    render_state_.dirty_vertices_end       = std::max(render_state_.dirty_vertices_end, end);
+}
+
+void renderable_node_t::mark_indices_dirty(std::size_t begin, std::size_t end)
+{
+    render_state_.should_transfer_indices = true;
+    render_state_.dirty_indices_begin     = std::min(render_state_.dirty_indices_begin, begin);
+    render_state_.dirty_indices_end       = std::max(render_state_.dirty_indices_end, end);
 }
 
 void renderable_node_t::mark_should_render_wireframe()
@@ -77,11 +97,15 @@ void renderable_node_t::mark_should_render_wireframe()
 void renderable_node_t::mark_vertices_clean()
 {
     render_state_.should_transfer_vertices = false;
+    render_state_.dirty_vertices_begin     = std::numeric_limits<std::size_t>::max();
+    render_state_.dirty_vertices_end       = 0u;
 }
 
 void renderable_node_t::mark_indices_clean()
 {
     render_state_.should_transfer_indices = false;
+    render_state_.dirty_indices_begin     = std::numeric_limits<std::size_t>::max();
+    render_state_.dirty_indices_end       = 0u;
 }
 
 void renderable_node_t::mark_should_render_triangles()
@@ -110,6 +134,26 @@ bool renderable_node_t::should_render_wireframe() const
     return render_state_.should_render_wireframe;
 }
 
+std::size_t renderable_node_t::dirty_vertices_begin() const
+{
+    return render_state_.dirty_vertices_begin;
+}
+
+std::size_t renderable_node_t::dirty_vertices_end() const
+{
+    return render_state_.dirty_vertices_end;
+}
+
+std::size_t renderable_node_t::dirty_indices_begin() const
+{
+    return render_state_.dirty_indices_begin;
+}
+
+std::size_t renderable_node_t::dirty_indices_end() const
+{
+    return render_state_.dirty_indices_end;
+}
+
 bool renderable_node_t::is_environment_body() const
 {
     return body_type_ == body_type_t::environment;
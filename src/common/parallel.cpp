@@ -0,0 +1,127 @@
+#include <sbs/common/parallel.h>
+
+namespace sbs {
+namespace common {
+
+namespace {
+
+thread_local bool is_thread_in_parallel_region = false;
+
+} // namespace
+
+bool is_in_parallel_region()
+{
+    return is_thread_in_parallel_region;
+}
+
+thread_pool_t::thread_pool_t(std::size_t worker_count)
+    : workers_{},
+      run_mutex_{},
+      mutex_{},
+      wake_{},
+      done_{},
+      job_(nullptr),
+      generation_(0u),
+      is_stopping_(false)
+{
+    workers_.reserve(worker_count);
+    for (std::size_t i = 0u; i < worker_count; ++i)
+        workers_.emplace_back([this]() { work(); });
+}
+
+thread_pool_t::~thread_pool_t()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        is_stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_)
+        worker.join();
+}
+
+thread_pool_t& thread_pool_t::instance()
+{
+    static thread_pool_t pool{thread_count() - 1u};
+    return pool;
+}
+
+std::size_t thread_pool_t::worker_count() const
+{
+    return workers_.size();
+}
+
+bool thread_pool_t::try_run(std::size_t task_count, task_function_type task, void const* context)
+{
+    std::unique_lock<std::mutex> run_lock{run_mutex_, std::try_to_lock};
+    if (!run_lock.owns_lock())
+        return false;
+
+    job_t job{task, context, task_count, {0u}, 0u, 0u};
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        job_ = &job;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    run_tasks(job);
+
+    // the job lives on this stack frame, so no worker may still hold it when returning
+    std::unique_lock<std::mutex> lock{mutex_};
+    done_.wait(lock, [&job]() {
+        return job.finished_task_count == job.task_count && job.active_worker_count == 0u;
+    });
+    job_ = nullptr;
+    return true;
+}
+
+void thread_pool_t::work()
+{
+    std::uint64_t seen_generation = 0u;
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true)
+    {
+        wake_.wait(lock, [&]() { return is_stopping_ || generation_ != seen_generation; });
+        if (is_stopping_)
+            return;
+
+        seen_generation = generation_;
+        if (job_ == nullptr)
+            continue;
+
+        job_t& job = *job_;
+        ++job.active_worker_count;
+        lock.unlock();
+        run_tasks(job);
+        lock.lock();
+        --job.active_worker_count;
+        if (job.active_worker_count == 0u)
+            done_.notify_all();
+    }
+}
+
+void thread_pool_t::run_tasks(job_t& job)
+{
+    std::size_t finished_task_count = 0u;
+    std::size_t i                   = job.next_task.fetch_add(1u, std::memory_order_relaxed);
+    is_thread_in_parallel_region    = true;
+    while (i < job.task_count)
+    {
+        job.task(job.context, i);
+        ++finished_task_count;
+        i = job.next_task.fetch_add(1u, std::memory_order_relaxed);
+    }
+    is_thread_in_parallel_region = false;
+
+    if (finished_task_count == 0u)
+        return;
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    job.finished_task_count += finished_task_count;
+    if (job.finished_task_count == job.task_count)
+        done_.notify_all();
+}
+
+} // namespace common
+} // namespace sbs
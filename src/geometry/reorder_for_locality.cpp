@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <sbs/geometry/reorder_for_locality.h>
+
+namespace sbs {
+namespace geometry {
+
+namespace {
+
+using point_type = std::array<float, 3u>;
+
+/**
+ * Spreads the lowest 21 bits of x such that two zero bits separate consecutive bits
+ */
+std::uint64_t spread_bits(std::uint64_t x)
+{
+    x &= 0x1fffffull;
+    x = (x | x << 32u) & 0x1f00000000ffffull;
+    x = (x | x << 16u) & 0x1f0000ff0000ffull;
+    x = (x | x << 8u) & 0x100f00f00f00f00full;
+    x = (x | x << 4u) & 0x10c30c30c30c30c3ull;
+    x = (x | x << 2u) & 0x1249249249249249ull;
+    return x;
+}
+
+/**
+ * Indices of the points in the order of the Morton curve through their bounding cube, ties
+ * broken by index
+ */
+std::vector<index_type> morton_order(std::vector<point_type> const& points)
+{
+    point_type min{};
+    point_type max{};
+    min.fill(std::numeric_limits<float>::max());
+    max.fill(std::numeric_limits<float>::lowest());
+    for (point_type const& p : points)
+    {
+        for (std::size_t d = 0u; d < 3u; ++d)
+        {
+            min[d] = std::min(min[d], p[d]);
+            max[d] = std::max(max[d], p[d]);
+        }
+    }
+
+    // a cube keeps the curve's cells isotropic
+    float extent = 0.f;
+    for (std::size_t d = 0u; d < 3u; ++d)
+        extent = std::max(extent, max[d] - min[d]);
+
+    double constexpr max_cell = static_cast<double>((1u << 21u) - 1u);
+    double const scale        = extent > 0.f ? max_cell / static_cast<double>(extent) : 0.;
+
+    std::vector<std::uint64_t> codes(points.size());
+    for (std::size_t i = 0u; i < points.size(); ++i)
+    {
+        std::uint64_t code = 0u;
+        for (std::size_t d = 0u; d < 3u; ++d)
+        {
+            auto const cell = static_cast<std::uint64_t>(
+                std::clamp(static_cast<double>(points[i][d] - min[d]) * scale, 0., max_cell));
+            code |= spread_bits(cell) << d;
+        }
+        codes[i] = code;
+    }
+
+    std::vector<index_type> order(points.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&codes](index_type a, index_type b) {
+        return codes[a] < codes[b];
+    });
+    return order;
+}
+
+/**
+ * Rearranges the blocks of stride consecutive values such that block i becomes original block
+ * order[i]. Values whose count does not match the order's are left untouched.
+ */
+template <class T>
+void permute_blocks(
+    std::vector<T>& values,
+    std::size_t stride,
+    std::vector<index_type> const& order)
+{
+    if (values.size() != stride * order.size())
+        return;
+
+    std::vector<T> permuted(values.size());
+    for (std::size_t i = 0u; i < order.size(); ++i)
+    {
+        std::copy_n(values.begin() + stride * order[i], stride, permuted.begin() + stride * i);
+    }
+    values = std::move(permuted);
+}
+
+/**
+ * Inverse of a permutation from new to original indices
+ */
+std::vector<index_type> invert(std::vector<index_type> const& order)
+{
+    std::vector<index_type> inverse(order.size());
+    for (std::size_t i = 0u; i < order.size(); ++i)
+        inverse[order[i]] = static_cast<index_type>(i);
+    return inverse;
+}
+
+} // namespace
+
+locality_permutation_t reorder_for_locality(common::geometry_t& geometry)
+{
+    std::size_t const vertex_count = geometry.positions.size() / 3u;
+    std::vector<point_type> points(vertex_count);
+    for (std::size_t vi = 0u; vi < vertex_count; ++vi)
+    {
+        points[vi] = {
+            geometry.positions[3u * vi],
+            geometry.positions[3u * vi + 1u],
+            geometry.positions[3u * vi + 2u]};
+    }
+
+    std::vector<index_type> const vertex_order = morton_order(points);
+    locality_permutation_t permutation{};
+    permutation.vertices = invert(vertex_order);
+
+    permute_blocks(geometry.positions, 3u, vertex_order);
+    permute_blocks(geometry.normals, 3u, vertex_order);
+    permute_blocks(geometry.uvs, 2u, vertex_order);
+    permute_blocks(geometry.colors, 3u, vertex_order);
+
+    for (int& vi : geometry.indices)
+        vi = static_cast<int>(permutation.vertices[static_cast<std::size_t>(vi)]);
+
+    std::size_t const arity         = geometry.is_tetrahedral_mesh() ? 4u : 3u;
+    std::size_t const element_count = geometry.indices.size() / arity;
+    std::vector<point_type> centroids(element_count, point_type{});
+    for (std::size_t e = 0u; e < element_count; ++e)
+    {
+        for (std::size_t k = 0u; k < arity; ++k)
+        {
+            auto const vi = static_cast<std::size_t>(geometry.indices[arity * e + k]);
+            for (std::size_t d = 0u; d < 3u; ++d)
+                centroids[e][d] += geometry.positions[3u * vi + d] / static_cast<float>(arity);
+        }
+    }
+
+    std::vector<index_type> const element_order = morton_order(centroids);
+    permutation.elements                        = invert(element_order);
+    permute_blocks(geometry.indices, arity, element_order);
+
+    return permutation;
+}
+
+} // namespace geometry
+} // namespace sbs
@@ -2,6 +2,7 @@
 
 #include "sbs/io/ply.h"
 
+#include <algorithm>
 #include <fstream>
 #include <nlohmann/json.hpp>
 
@@ -333,6 +334,33 @@ common::scene_t load_scene(
         }
 
         scene::physics_body_info pbi;
+        bool const should_reorder_for_locality = object_spec.contains("reorder_for_locality") &&
+                                                 object_spec["reorder_for_locality"].get<bool>();
+        if (should_reorder_for_locality)
+        {
+            pbi.locality_permutation = sbs::geometry::reorder_for_locality(*geometry);
+        }
+        // the snapshot must have been taken of the body's geometry after its reordering
+        if (geometry_spec.contains("topology_snapshot"))
+        {
+            std::filesystem::path const snapshot_path =
+                path.parent_path() / geometry_spec["topology_snapshot"].get<std::string>();
+            std::optional<topology_snapshot_t> snapshot = read_topology_snapshot(snapshot_path);
+
+            // a stale snapshot of an edited or reordered mesh would index out of its positions
+            bool const is_snapshot_of_geometry =
+                snapshot.has_value() &&
+                snapshot->topology.vertex_count == geometry->positions.size() / 3u &&
+                std::equal(
+                    snapshot->topology.tetrahedron_vertices.begin(),
+                    snapshot->topology.tetrahedron_vertices.end(),
+                    geometry->indices.begin(),
+                    geometry->indices.end(),
+                    [](index_type vi, int i) { return vi == static_cast<index_type>(i); });
+            if (is_snapshot_of_geometry)
+                pbi.topology_snapshot = std::move(snapshot);
+        }
+
         pbi.id           = id;
         pbi.geometry     = geometry.value();
         pbi.velocity.vx  = vx;
@@ -14,15 +14,20 @@ brute_force_cd_system_t::brute_force_cd_system_t(
 void brute_force_cd_system_t::execute()
 {
     std::vector<collision_model_t*>& objects = collision_objects();
+    std::vector<intersection_pair>& pairs    = candidate_pairs();
+    pairs.clear();
+    pairs.reserve(objects.size() * objects.size() / 2u);
     for (std::size_t i = 0u; i < objects.size(); ++i)
     {
         collision_model_t* b1 = objects[i];
         for (std::size_t j = i + 1u; j < objects.size(); ++j)
         {
             collision_model_t* b2 = objects[j];
-            b1->collide(*b2, *contact_handler());
+            pairs.push_back({b1, b2});
         }
     }
+
+    narrow_phase(pairs);
 }
 
 void brute_force_cd_system_t::update(simulation_t const& simulation)
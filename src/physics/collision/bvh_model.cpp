@@ -1,15 +1,386 @@
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
 #include <sbs/common/mesh.h>
+#include <sbs/common/parallel.h>
 #include <sbs/physics/collision/bvh_model.h>
 #include <sbs/physics/collision/contact.h>
+#include <sbs/physics/collision/intersections.h>
 #include <sbs/physics/collision/sdf_model.h>
+#include <tuple>
 #include <vector>
 
 namespace sbs {
 namespace physics {
 namespace collision {
 
-point_bvh_model_t::point_bvh_model_t() : kd_tree_type(0), surface_() {}
+namespace {
+
+using kd_tree_node_type = Discregrid::KDTree<Discregrid::BoundingSphere>::Node;
+
+scalar_type constexpr default_rebuild_threshold = 2.;
+
+void make_refit_schedule(
+    std::vector<kd_tree_node_type> const& nodes,
+    bvh_refit_schedule_t& schedule)
+{
+    schedule.nodes.clear();
+    schedule.level_offsets.clear();
+    if (nodes.empty())
+        return;
+
+    // children are always added to the tree after their parent
+    std::vector<unsigned int> depths(nodes.size(), 0u);
+    unsigned int max_depth = 0u;
+    for (std::size_t i = 0u; i < nodes.size(); ++i)
+    {
+        max_depth = std::max(max_depth, depths[i]);
+        if (nodes[i].isLeaf())
+            continue;
+
+        for (int const child : nodes[i].children)
+            depths[static_cast<std::size_t>(child)] = depths[i] + 1u;
+    }
+
+    schedule.level_offsets.assign(max_depth + 2u, 0u);
+    for (std::size_t i = 0u; i < nodes.size(); ++i)
+        ++schedule.level_offsets[max_depth - depths[i] + 1u];
+    for (std::size_t l = 0u; l <= max_depth; ++l)
+        schedule.level_offsets[l + 1u] += schedule.level_offsets[l];
+
+    std::vector<std::size_t> cursors(
+        schedule.level_offsets.begin(),
+        schedule.level_offsets.end() - 1);
+    schedule.nodes.resize(nodes.size());
+    for (std::size_t i = 0u; i < nodes.size(); ++i)
+        schedule.nodes[cursors[max_depth - depths[i]]++] = static_cast<unsigned int>(i);
+}
+
+/**
+ * Smallest sphere enclosing the spheres s1 and s2
+ */
+void merge(
+    Discregrid::BoundingSphere const& s1,
+    Discregrid::BoundingSphere const& s2,
+    Discregrid::BoundingSphere& hull)
+{
+    Eigen::Vector3d const d = s2.x() - s1.x();
+    scalar_type const dn    = d.norm();
+    if (dn + s2.r() <= s1.r())
+    {
+        hull.x() = s1.x();
+        hull.r() = s1.r();
+        return;
+    }
+    if (dn + s1.r() <= s2.r())
+    {
+        hull.x() = s2.x();
+        hull.r() = s2.r();
+        return;
+    }
+
+    scalar_type const r = 0.5 * (dn + s1.r() + s2.r());
+    hull.x()            = s1.x() + d * ((r - s1.r()) / dn);
+    hull.r()            = r;
+}
+
+/**
+ * Smallest box enclosing the boxes b1 and b2
+ */
+void merge(Eigen::AlignedBox3d const& b1, Eigen::AlignedBox3d const& b2, Eigen::AlignedBox3d& hull)
+{
+    hull = b1.merged(b2);
+}
+
+/**
+ * Refits every node's hull bottom-up, one depth level at a time. Leaf hulls are computed by
+ * leaf_hull(node, hull), while internal hulls enclose their children's hulls.
+ */
+template <class HullType, class LeafHullFunc>
+void refit_bottom_up(
+    std::vector<kd_tree_node_type> const& nodes,
+    std::vector<HullType>& hulls,
+    bvh_refit_schedule_t const& schedule,
+    LeafHullFunc const& leaf_hull)
+{
+    for (std::size_t l = 0u; l + 1u < schedule.level_offsets.size(); ++l)
+    {
+        std::size_t const begin = schedule.level_offsets[l];
+        std::size_t const end   = schedule.level_offsets[l + 1u];
+        common::parallel_for(end - begin, [&](std::size_t k) {
+            unsigned int const node_idx   = schedule.nodes[begin + k];
+            kd_tree_node_type const& node = nodes[node_idx];
+            if (node.isLeaf())
+            {
+                leaf_hull(node, hulls[node_idx]);
+                return;
+            }
+            merge(hulls[node.children[0]], hulls[node.children[1]], hulls[node_idx]);
+        });
+    }
+}
+
+/**
+ * Sum of the hulls' squared radii relative to the root's squared radius, which uniform scaling of
+ * the hierarchy leaves unchanged
+ */
+scalar_type normalized_sum_of_squared_radii(std::vector<Discregrid::BoundingSphere> const& hulls)
+{
+    if (hulls.empty() || !(hulls.front().r() > 0.))
+        return 0.;
+
+    scalar_type cost = 0.;
+    for (Discregrid::BoundingSphere const& hull : hulls)
+        cost += hull.r() * hull.r();
+    return cost / (hulls.front().r() * hulls.front().r());
+}
+
+/**
+ * Sphere centered at the points' bounding box center enclosing the points
+ */
+template <class PointFunc>
+void enclose(std::size_t count, PointFunc const& point, Discregrid::BoundingSphere& hull)
+{
+    Eigen::AlignedBox3d box{};
+    for (std::size_t i = 0u; i < count; ++i)
+        box.extend(point(i));
+
+    Eigen::Vector3d const center = box.center();
+    scalar_type squared_radius   = 0.;
+    for (std::size_t i = 0u; i < count; ++i)
+        squared_radius = std::max(squared_radius, (point(i) - center).squaredNorm());
+
+    hull.x() = center;
+    hull.r() = std::sqrt(squared_radius);
+}
+
+/**
+ * Bounding box of the points
+ */
+template <class PointFunc>
+void enclose(std::size_t count, PointFunc const& point, Eigen::AlignedBox3d& hull)
+{
+    hull.setEmpty();
+    for (std::size_t i = 0u; i < count; ++i)
+        hull.extend(point(i));
+}
+
+} // namespace
+
+triangle_bvh_t::triangle_bvh_t()
+    : kd_tree_type(0),
+      surface_(),
+      triangles_{},
+      topology_revision_(0u),
+      refit_schedule_{},
+      cost_(0.),
+      rebuilt_cost_(0.),
+      rebuild_threshold_(default_rebuild_threshold),
+      bounding_volume_(bounding_volume_t::sphere),
+      boxes_{},
+      wide_bvh_{}
+{
+}
+
+triangle_bvh_t::triangle_bvh_t(common::shared_vertex_surface_mesh_i const* surface)
+    : kd_tree_type(surface->triangle_count()),
+      surface_(surface),
+      triangles_{},
+      topology_revision_(0u),
+      refit_schedule_{},
+      cost_(0.),
+      rebuilt_cost_(0.),
+      rebuild_threshold_(default_rebuild_threshold),
+      bounding_volume_(bounding_volume_t::sphere),
+      boxes_{},
+      wide_bvh_{}
+{
+    std::vector<Eigen::Vector3d> positions(surface_->vertex_count());
+    for (std::size_t vi = 0u; vi < positions.size(); ++vi)
+        positions[vi] = surface_->vertex(vi).position;
+
+    rebuild(positions);
+}
+
+bool triangle_bvh_t::empty() const
+{
+    return m_nodes.empty();
+}
+
+triangle_bvh_t::triangle_type const& triangle_bvh_t::triangle(std::size_t fi) const
+{
+    return triangles_[fi];
+}
+
+std::size_t triangle_bvh_t::triangle_count() const
+{
+    return triangles_.size();
+}
+
+void triangle_bvh_t::update(std::vector<Eigen::Vector3d> const& positions)
+{
+    // the hierarchy partitions a fixed list of triangles, which topology edits may resize
+    std::size_t const triangle_count = surface_->triangle_count();
+    if (triangle_count != m_lst.size())
+    {
+        m_lst.resize(triangle_count);
+        rebuild(positions);
+        return;
+    }
+
+    // triangles replaced in place by topology edits only need their hulls refitted
+    auto const [begin, end] = surface_->edited_triangles(topology_revision_);
+    topology_revision_      = surface_->topology_revision();
+    for (std::size_t fi = begin; fi < end; ++fi)
+        triangles_[fi] = surface_->triangle(fi).vertices;
+
+    refit(positions);
+    if (quality() > rebuild_threshold_)
+        rebuild(positions);
+}
+
+scalar_type triangle_bvh_t::quality() const
+{
+    return rebuilt_cost_ > 0. ? cost_ / rebuilt_cost_ : 1.;
+}
+
+scalar_type triangle_bvh_t::rebuild_threshold() const
+{
+    return rebuild_threshold_;
+}
+
+scalar_type& triangle_bvh_t::rebuild_threshold()
+{
+    return rebuild_threshold_;
+}
+
+void triangle_bvh_t::use_bounding_volume(bounding_volume_t bounding_volume)
+{
+    bounding_volume_ = bounding_volume;
+    if (bounding_volume_ != bounding_volume_t::aabb)
+    {
+        boxes_.clear();
+        wide_bvh_ = wide_bvh_t{};
+    }
+}
+
+bounding_volume_t triangle_bvh_t::bounding_volume() const
+{
+    return bounding_volume_;
+}
+
+Eigen::AlignedBox3d const& triangle_bvh_t::box(unsigned int node_idx) const
+{
+    return boxes_[node_idx];
+}
+
+wide_bvh_t const& triangle_bvh_t::wide_bvh() const
+{
+    return wide_bvh_;
+}
+
+void triangle_bvh_t::rebuild(std::vector<Eigen::Vector3d> const& positions)
+{
+    std::size_t const triangle_count = surface_->triangle_count();
+    topology_revision_               = surface_->topology_revision();
+    triangles_.resize(triangle_count);
+    for (std::size_t fi = 0u; fi < triangle_count; ++fi)
+        triangles_[fi] = surface_->triangle(fi).vertices;
+
+    kd_tree_type::construct();
+    make_refit_schedule(m_nodes, refit_schedule_);
+    wide_bvh_ = wide_bvh_t{};
+    refit(positions);
+    rebuilt_cost_ = cost_;
+}
+
+void triangle_bvh_t::refit(std::vector<Eigen::Vector3d> const& positions)
+{
+    auto const range_hull = [&](std::uint32_t begin, std::uint32_t count, auto& hull) {
+        auto const point = [&](std::size_t i) -> Eigen::Vector3d const& {
+            triangle_type const& f = triangles_[m_lst[begin + i / 3u]];
+            return positions[f[i % 3u]];
+        };
+        enclose(3u * count, point, hull);
+    };
+    auto const leaf_hull = [&](kd_tree_node_type const& node, auto& hull) {
+        range_hull(node.begin, node.n, hull);
+    };
+
+    refit_bottom_up(m_nodes, m_hulls, refit_schedule_, leaf_hull);
+    cost_ = normalized_sum_of_squared_radii(m_hulls);
+
+    if (bounding_volume_ == bounding_volume_t::aabb)
+    {
+        boxes_.resize(m_nodes.size());
+        refit_bottom_up(m_nodes, boxes_, refit_schedule_, leaf_hull);
+
+        if (wide_bvh_.empty())
+            wide_bvh_.build(m_nodes, m_lst, range_hull);
+        else
+            wide_bvh_.refit(range_hull);
+    }
+}
+
+Eigen::Vector3d triangle_bvh_t::entityPosition(unsigned int i) const
+{
+    auto const f = surface_->triangle(i);
+    Eigen::Vector3d const centroid =
+        (surface_->vertex(f.vertices[0u]).position + surface_->vertex(f.vertices[1u]).position +
+         surface_->vertex(f.vertices[2u]).position) /
+        3.;
+    return centroid;
+}
+
+void triangle_bvh_t::computeHull(unsigned int b, unsigned int n, Discregrid::BoundingSphere& hull)
+    const
+{
+    auto vertices_of_sphere = std::vector<Eigen::Vector3d>{};
+    vertices_of_sphere.reserve(3u * n);
+    for (unsigned int i = b; i < n + b; ++i)
+    {
+        auto const f = surface_->triangle(m_lst[i]);
+        for (auto const vi : f.vertices)
+            vertices_of_sphere.push_back(surface_->vertex(vi).position);
+    }
+
+    Discregrid::BoundingSphere const s(vertices_of_sphere);
+
+    hull.x() = s.x();
+    hull.r() = s.r();
+}
+
+point_bvh_model_t::point_bvh_model_t()
+    : kd_tree_type(0),
+      surface_(),
+      positions_{},
+      previous_positions_{},
+      topology_revision_(0u),
+      refit_schedule_{},
+      cost_(0.),
+      rebuilt_cost_(0.),
+      rebuild_threshold_(default_rebuild_threshold),
+      bounding_volume_(bounding_volume_t::sphere),
+      boxes_{},
+      wide_bvh_{},
+      visited_leaf_count_(0u),
+      triangle_bvh_(),
+      contact_tolerance_(0.),
+      self_collision_(),
+      continuous_collision_detection_(false),
+      max_displacement_(0.),
+      temporal_coherence_(true),
+      travelled_{},
+      separation_bounds_{},
+      sdf_query_orders_{},
+      closest_triangles_{},
+      sdf_query_vertices_{},
+      sdf_query_points_{},
+      sdf_signed_distances_{},
+      sdf_gradients_{}
+{
+}
 
 model_type_t point_bvh_model_t::model_type() const
 {
@@ -22,14 +393,61 @@ primitive_type_t point_bvh_model_t::primitive_type() const
 }
 
 point_bvh_model_t::point_bvh_model_t(common::shared_vertex_surface_mesh_i const* surface)
-    : Discregrid::KDTree<Discregrid::BoundingSphere>(surface->vertex_count()), surface_(surface)
+    : Discregrid::KDTree<Discregrid::BoundingSphere>(surface->vertex_count()),
+      surface_(surface),
+      positions_(surface->vertex_count()),
+      previous_positions_{},
+      topology_revision_(surface->topology_revision()),
+      refit_schedule_{},
+      cost_(0.),
+      rebuilt_cost_(0.),
+      rebuild_threshold_(default_rebuild_threshold),
+      bounding_volume_(bounding_volume_t::sphere),
+      boxes_{},
+      wide_bvh_{},
+      visited_leaf_count_(0u),
+      triangle_bvh_(surface),
+      contact_tolerance_(0.),
+      self_collision_(),
+      continuous_collision_detection_(false),
+      max_displacement_(0.),
+      temporal_coherence_(true),
+      travelled_{},
+      separation_bounds_{},
+      sdf_query_orders_{},
+      closest_triangles_{},
+      sdf_query_vertices_{},
+      sdf_query_points_{},
+      sdf_signed_distances_{},
+      sdf_gradients_{}
 {
-    kd_tree_type::construct();
+    for (std::size_t vi = 0u; vi < positions_.size(); ++vi)
+        positions_[vi] = surface_->vertex(vi).position;
+
+    rebuild();
+    update_volume();
+
+    std::size_t const triangle_count = surface_->triangle_count();
+    for (std::size_t f = 0u; f < triangle_count; ++f)
+    {
+        auto const triangle = surface_->triangle(f);
+        for (std::size_t e = 0u; e < 3u; ++e)
+        {
+            Eigen::Vector3d const& p1 = surface_->vertex(triangle.vertices[e]).position;
+            Eigen::Vector3d const& p2 = surface_->vertex(triangle.vertices[(e + 1u) % 3u]).position;
+            contact_tolerance_ += (p2 - p1).norm();
+        }
+    }
+    if (triangle_count > 0u)
+        contact_tolerance_ /= static_cast<scalar_type>(3u * triangle_count);
 }
 
 void point_bvh_model_t::collide(collision_model_t& other, contact_handler_t& handler)
 {
     model_type_t const other_model_type = other.model_type();
+    visited_leaf_count_                 = 0u;
+    if (m_nodes.empty())
+        return;
 
     if (other_model_type == model_type_t::sdf)
     {
@@ -44,64 +462,410 @@ void point_bvh_model_t::collide(collision_model_t& other, contact_handler_t& han
             return c;
         };
 
+        // with continuous collision detection, hulls are grown by the vertices' motion
+        scalar_type const sweep = continuous_collision_detection_ ? max_displacement_ : 0.;
+
+        /**
+         * Signed distances are 1-Lipschitz, so no point within r of p can reach the zero level
+         * set if the signed distance at p exceeds r. Points outside of a grid sdf's domain
+         * evaluate to a huge distance, so p is clamped into the domain first, which moves it by
+         * at most the clamping distance.
+         */
+        auto const can_reach_sdf = [&sdf_model](Eigen::Vector3d const& p, scalar_type r) {
+            Eigen::Vector3d const q = sdf_model.closest_point_in_domain(p);
+            return sdf_model.evaluate(q).first - (p - q).norm() <= r;
+        };
+
         auto const is_sphere_colliding_with_sdf =
-            [this, &sdf_model, closest_point_on_aabb](unsigned int node_idx, unsigned int depth) -> bool {
-            Discregrid::BoundingSphere const& s                     = this->hull(node_idx);
-            Eigen::AlignedBox3d const& sdf_englobing_volume         = sdf_model.volume();
+            [this, &sdf_model, closest_point_on_aabb, sweep, can_reach_sdf](
+                unsigned int node_idx,
+                unsigned int depth) -> bool {
+            Discregrid::BoundingSphere const& s             = this->hull(node_idx);
+            Eigen::AlignedBox3d const& sdf_englobing_volume = sdf_model.volume();
+            scalar_type const r                             = s.r() + sweep;
 
-            auto const [sd, grad] = sdf_model.evaluate(s.x());
-            if (sd < 0.)
-                return true;
+            if (!sdf_englobing_volume.isEmpty())
+            {
+                Eigen::Vector3d const closest_point =
+                    closest_point_on_aabb(s.x(), sdf_englobing_volume);
+                if ((s.x() - closest_point).squaredNorm() >= r * r)
+                    return false;
+            }
 
-            Eigen::Vector3d closest_point =
-                closest_point_on_aabb(s.x(), sdf_englobing_volume);
+            return can_reach_sdf(s.x(), r);
+        };
 
-            Eigen::Vector3d const diff = s.x() - closest_point;
-            scalar_type const dist2    = diff.squaredNorm();
-            scalar_type const r2       = s.r() * s.r();
+        std::vector<scalar_type>* expiries = nullptr;
+        if (temporal_coherence_)
+        {
+            separation_bounds_t& bounds = separation_bounds_[sdf_model.id()];
+            if (bounds.expiries.size() != travelled_.size() ||
+                bounds.sdf_transform.matrix() != sdf_model.transform().matrix())
+            {
+                bounds.sdf_transform = sdf_model.transform();
+                bounds.expiries.assign(travelled_.size(), 0.);
+            }
+            expiries = &bounds.expiries;
+        }
 
-            return dist2 < r2;
+        // vertices of the reached leaves are gathered, then evaluated against the sdf at once
+        sdf_query_vertices_.clear();
+        sdf_query_points_.clear();
+        auto const gather_vertex = [this, expiries](index_type vi) {
+            // the vertex has not moved enough to reach the sdf since its last evaluation
+            if (expiries != nullptr && vi < expiries->size() && travelled_[vi] < (*expiries)[vi])
+                return;
+
+            sdf_query_vertices_.push_back(vi);
+            sdf_query_points_.push_back(positions_[vi]);
         };
 
-        auto const contact_callback =
-            [this, &sdf_model, &handler](unsigned int node_idx, unsigned int depth) {
+        if (bounding_volume_ == bounding_volume_t::aabb)
+        {
+            /**
+             * No point of a box can reach the zero level set if the signed distance at the box's
+             * center, clamped into the sdf's domain, exceeds half of its diagonal plus the
+             * clamping distance. The 4 children of a wide node are tested against the sdf's
+             * volume at once.
+             */
+            Eigen::AlignedBox3d sdf_englobing_volume = sdf_model.volume();
+            if (!sdf_englobing_volume.isEmpty())
+            {
+                sdf_englobing_volume.min().array() -= sweep;
+                sdf_englobing_volume.max().array() += sweep;
+            }
+            auto const child_mask = [&](wide_bvh_t::node_t const& node) -> unsigned int {
+                unsigned int const mask = sdf_englobing_volume.isEmpty() ?
+                                              ~0u :
+                                              wide_bvh_t::overlap_mask(node, sdf_englobing_volume);
+                if (mask == 0u)
+                    return mask;
+
+                std::array<Eigen::Vector3d, wide_bvh_t::width> centers{};
+                std::array<scalar_type, wide_bvh_t::width> clamping_distances{};
+                std::array<scalar_type, wide_bvh_t::width> signed_distances{};
+                std::array<Eigen::Vector3d, wide_bvh_t::width> gradients{};
+                for (std::uint32_t k = 0u; k < node.child_count; ++k)
+                {
+                    Eigen::Vector3d const center{
+                        0.5 * (node.min_x[k] + node.max_x[k]),
+                        0.5 * (node.min_y[k] + node.max_y[k]),
+                        0.5 * (node.min_z[k] + node.max_z[k])};
+                    centers[k]            = sdf_model.closest_point_in_domain(center);
+                    clamping_distances[k] = (center - centers[k]).norm();
+                }
+                sdf_model.evaluate(
+                    centers.data(),
+                    node.child_count,
+                    signed_distances.data(),
+                    gradients.data());
+
+                Eigen::Array4d const sd = Eigen::Map<Eigen::Array4d>(signed_distances.data());
+                Eigen::Array4d const dx = node.max_x - node.min_x;
+                Eigen::Array4d const dy = node.max_y - node.min_y;
+                Eigen::Array4d const dz = node.max_z - node.min_z;
+
+                Eigen::Array4d const half_diagonal = 0.5 * (dx * dx + dy * dy + dz * dz).sqrt();
+
+                unsigned int reachable_mask = 0u;
+                for (std::uint32_t k = 0u; k < node.child_count; ++k)
+                {
+                    if (sd[k] - clamping_distances[k] <= half_diagonal[k] + sweep)
+                        reachable_mask |= 1u << k;
+                }
+                return mask & reachable_mask;
+            };
+
+            wide_bvh_.traverse(child_mask, [&](std::uint32_t begin, std::uint32_t count) {
+                ++visited_leaf_count_;
+                for (std::uint32_t i = begin; i < begin + count; ++i)
+                    gather_vertex(wide_bvh_.entity(i));
+            });
+        }
+        else
+        {
+            auto const contact_callback = [this, &gather_vertex, &is_sphere_colliding_with_sdf](
+                                              unsigned int node_idx,
+                                              unsigned int depth) {
                 kd_tree_type::Node const& node = this->node(node_idx);
-                if (!node.isLeaf())
+                // the traversal visits the children of colliding nodes without testing them
+                if (!node.isLeaf() || !is_sphere_colliding_with_sdf(node_idx, depth))
                     return;
 
+                ++visited_leaf_count_;
+
                 for (auto i = node.begin; i < node.begin + node.n; ++i)
-                {
-                    index_type const vi                = m_lst[i];
-                    Eigen::Vector3d const& pi          = surface_->vertex(vi).position;
-                    auto const [signed_distance, grad] = sdf_model.evaluate(pi);
-                    bool const is_vertex_penetrating   = signed_distance < 0.;
-
-                    if (!is_vertex_penetrating)
-                        continue;
-
-                    Eigen::Vector3d const contact_normal = grad.normalized();
-                    Eigen::Vector3d const contact_point =
-                        pi + std::abs(signed_distance) * contact_normal;
-
-                    surface_mesh_particle_to_sdf_contact_t contact(
-                        contact_t::type_t::surface_particle_to_sdf,
-                        this->id(),
-                        sdf_model.id(),
-                        contact_point,
-                        contact_normal,
-                        vi);
-
-                    handler.handle(contact);
-                }
+                    gather_vertex(m_lst[i]);
             };
 
-        traverseBreadthFirst(is_sphere_colliding_with_sdf, contact_callback);
+            traverseBreadthFirst(is_sphere_colliding_with_sdf, contact_callback);
+        }
+
+        // grid sdfs reuse their grouping of the vertices while the same vertices are queried
+        sdf_query_order_t& query_order = sdf_query_orders_[sdf_model.id()];
+        if (query_order.vertices != sdf_query_vertices_)
+        {
+            query_order.vertices = sdf_query_vertices_;
+            query_order.grid_order.clear();
+        }
+        sdf_model.evaluate(
+            sdf_query_points_,
+            sdf_signed_distances_,
+            sdf_gradients_,
+            query_order.grid_order);
+        for (std::size_t q = 0u; q < sdf_query_vertices_.size(); ++q)
+        {
+            index_type const vi                = sdf_query_vertices_[q];
+            scalar_type const signed_distance = sdf_signed_distances_[q];
+            bool const is_vertex_penetrating  = signed_distance < 0.;
+
+            if (expiries != nullptr && vi < expiries->size())
+            {
+                // outside of the sdf's volume, the distance to the volume bounds the distance to
+                // the sdf's surface instead
+                Eigen::AlignedBox3d const& sdf_volume = sdf_model.volume();
+                Eigen::Vector3d const& pi             = sdf_query_points_[q];
+                scalar_type const separation          = sdf_volume.contains(pi) ?
+                                                            signed_distance :
+                                                            sdf_volume.exteriorDistance(pi);
+                (*expiries)[vi] = travelled_[vi] + separation;
+            }
+
+            Eigen::Vector3d contact_point{};
+            Eigen::Vector3d contact_normal{};
+            if (is_vertex_penetrating)
+            {
+                Eigen::Vector3d const& pi = sdf_query_points_[q];
+                contact_normal            = sdf_gradients_[q].normalized();
+                contact_point             = pi + std::abs(signed_distance) * contact_normal;
+            }
+            else
+            {
+                if (!continuous_collision_detection_ || vi >= previous_positions_.size())
+                    continue;
+
+                // vertices that were already touching the sdf did not tunnel through it
+                Eigen::Vector3d const& p0          = previous_positions_[vi];
+                Eigen::Vector3d const& p1          = sdf_query_points_[q];
+                std::optional<scalar_type> const t = sdf_model.sphere_trace(p0, p1);
+                if (!t.has_value() || *t <= 0.)
+                    continue;
+
+                Eigen::Vector3d const toi_point = p0 + *t * (p1 - p0);
+                auto const [toi_signed_distance, toi_gradient] = sdf_model.evaluate(toi_point);
+                contact_normal = toi_gradient.normalized();
+                contact_point  = toi_point - toi_signed_distance * contact_normal;
+            }
+
+            surface_mesh_particle_to_sdf_contact_t contact(
+                contact_t::type_t::surface_particle_to_sdf,
+                this->id(),
+                sdf_model.id(),
+                contact_point,
+                contact_normal,
+                vi,
+                sdf_model.velocity(contact_point));
+
+            handler.handle(contact);
+        }
+    }
+    if (other_model_type == model_type_t::bvh)
+    {
+        point_bvh_model_t& bvh_model = reinterpret_cast<point_bvh_model_t&>(other);
+        if (&bvh_model == this)
+            return;
+
+        visited_leaf_count_ += this->collide_vertices_with_triangles(bvh_model, handler);
+        visited_leaf_count_ += bvh_model.collide_vertices_with_triangles(*this, handler);
     }
 }
 
 void point_bvh_model_t::update(simulation_t const& simulation)
 {
-    kd_tree_type::update();
+    // fetch every vertex once through the surface's interface, refitting only reads positions_
+    previous_positions_.swap(positions_);
+    positions_.resize(surface_->vertex_count());
+    common::parallel_for(positions_.size(), [this](std::size_t vi) {
+        positions_[vi] = surface_->vertex(vi).position;
+    });
+
+    // topology edits add, remove and renumber vertices, whose motion is then unknown
+    bool const is_topology_edited = surface_->topology_revision() != topology_revision_ ||
+                                    previous_positions_.size() != positions_.size();
+    topology_revision_ = surface_->topology_revision();
+    if (is_topology_edited)
+    {
+        previous_positions_ = positions_;
+        separation_bounds_.clear();
+        sdf_query_orders_.clear();
+        closest_triangles_.clear();
+        if (self_collision_.has_value())
+            self_collision_->rebuild_adjacency();
+    }
+
+    if (temporal_coherence_)
+    {
+        travelled_.resize(positions_.size(), 0.);
+        common::parallel_for(positions_.size(), [this](std::size_t vi) {
+            travelled_[vi] += (positions_[vi] - previous_positions_[vi]).norm();
+        });
+    }
+
+    max_displacement_ = 0.;
+    if (continuous_collision_detection_)
+    {
+        for (std::size_t vi = 0u; vi < positions_.size(); ++vi)
+        {
+            scalar_type const displacement = (positions_[vi] - previous_positions_[vi]).norm();
+            max_displacement_              = std::max(max_displacement_, displacement);
+        }
+    }
+
+    // the hierarchy partitions a fixed list of vertices, which topology edits may resize
+    if (positions_.size() != m_lst.size())
+    {
+        m_lst.resize(positions_.size());
+        rebuild();
+    }
+    else
+    {
+        refit();
+        // vertices have moved enough to degrade the hierarchy, and their grouping by grid cell
+        if (quality() > rebuild_threshold_)
+        {
+            rebuild();
+            sdf_query_orders_.clear();
+        }
+    }
+
+    triangle_bvh_.update(positions_);
+    update_volume();
+}
+
+void point_bvh_model_t::self_collide(contact_handler_t& handler)
+{
+    if (!self_collision_.has_value())
+        return;
+
+    self_collision_->collide(id(), handler);
+}
+
+triangle_bvh_t const& point_bvh_model_t::triangle_bvh() const
+{
+    return triangle_bvh_;
+}
+
+scalar_type point_bvh_model_t::quality() const
+{
+    return rebuilt_cost_ > 0. ? cost_ / rebuilt_cost_ : 1.;
+}
+
+scalar_type point_bvh_model_t::rebuild_threshold() const
+{
+    return rebuild_threshold_;
+}
+
+scalar_type& point_bvh_model_t::rebuild_threshold()
+{
+    return rebuild_threshold_;
+}
+
+void point_bvh_model_t::use_bounding_volume(bounding_volume_t bounding_volume)
+{
+    bounding_volume_ = bounding_volume;
+    if (bounding_volume_ != bounding_volume_t::aabb)
+    {
+        boxes_.clear();
+        wide_bvh_ = wide_bvh_t{};
+    }
+
+    triangle_bvh_.use_bounding_volume(bounding_volume);
+    refit();
+    triangle_bvh_.update(positions_);
+    update_volume();
+}
+
+bounding_volume_t point_bvh_model_t::bounding_volume() const
+{
+    return bounding_volume_;
+}
+
+Eigen::AlignedBox3d const& point_bvh_model_t::box(unsigned int node_idx) const
+{
+    return boxes_[node_idx];
+}
+
+wide_bvh_t const& point_bvh_model_t::wide_bvh() const
+{
+    return wide_bvh_;
+}
+
+std::size_t point_bvh_model_t::visited_leaf_count() const
+{
+    return visited_leaf_count_;
+}
+
+scalar_type point_bvh_model_t::contact_tolerance() const
+{
+    return contact_tolerance_;
+}
+
+scalar_type& point_bvh_model_t::contact_tolerance()
+{
+    return contact_tolerance_;
+}
+
+void point_bvh_model_t::enable_self_collision(tetrahedral_mesh_boundary_t const* boundary)
+{
+    self_collision_ = spatial_hash_self_collision_t(boundary);
+}
+
+void point_bvh_model_t::disable_self_collision()
+{
+    self_collision_.reset();
+}
+
+void point_bvh_model_t::enable_continuous_collision_detection()
+{
+    continuous_collision_detection_ = true;
+}
+
+void point_bvh_model_t::disable_continuous_collision_detection()
+{
+    continuous_collision_detection_ = false;
+    max_displacement_               = 0.;
+}
+
+bool point_bvh_model_t::continuous_collision_detection() const
+{
+    return continuous_collision_detection_;
+}
+
+void point_bvh_model_t::enable_temporal_coherence()
+{
+    temporal_coherence_ = true;
+}
+
+void point_bvh_model_t::disable_temporal_coherence()
+{
+    temporal_coherence_ = false;
+    travelled_.clear();
+    separation_bounds_.clear();
+}
+
+bool point_bvh_model_t::temporal_coherence() const
+{
+    return temporal_coherence_;
+}
+
+std::optional<spatial_hash_self_collision_t> const& point_bvh_model_t::self_collision() const
+{
+    return self_collision_;
+}
+
+std::optional<spatial_hash_self_collision_t>& point_bvh_model_t::self_collision()
+{
+    return self_collision_;
 }
 
 Eigen::Vector3d point_bvh_model_t::entityPosition(unsigned int i) const
@@ -125,6 +889,300 @@ void point_bvh_model_t::computeHull(
     hull.r() = s.r();
 }
 
+void point_bvh_model_t::update_volume()
+{
+    if (m_nodes.empty())
+    {
+        volume().setEmpty();
+        return;
+    }
+
+    if (bounding_volume_ == bounding_volume_t::aabb)
+    {
+        volume() = boxes_.front();
+        return;
+    }
+
+    // the box of the root sphere is much looser than the vertices' box for elongated surfaces
+    volume().setEmpty();
+    for (Eigen::Vector3d const& p : positions_)
+        volume().extend(p);
+}
+
+void point_bvh_model_t::rebuild()
+{
+    kd_tree_type::construct();
+    make_refit_schedule(m_nodes, refit_schedule_);
+    wide_bvh_ = wide_bvh_t{};
+    refit();
+    rebuilt_cost_ = cost_;
+}
+
+void point_bvh_model_t::refit()
+{
+    auto const range_hull = [this](std::uint32_t begin, std::uint32_t count, auto& hull) {
+        auto const point = [&](std::size_t i) -> Eigen::Vector3d const& {
+            return positions_[m_lst[begin + i]];
+        };
+        enclose(count, point, hull);
+    };
+    auto const leaf_hull = [&](kd_tree_node_type const& node, auto& hull) {
+        range_hull(node.begin, node.n, hull);
+    };
+
+    refit_bottom_up(m_nodes, m_hulls, refit_schedule_, leaf_hull);
+    cost_ = normalized_sum_of_squared_radii(m_hulls);
+
+    if (bounding_volume_ == bounding_volume_t::aabb)
+    {
+        boxes_.resize(m_nodes.size());
+        refit_bottom_up(m_nodes, boxes_, refit_schedule_, leaf_hull);
+
+        if (wide_bvh_.empty())
+            wide_bvh_.build(m_nodes, m_lst, range_hull);
+        else
+            wide_bvh_.refit(range_hull);
+    }
+}
+
+std::size_t point_bvh_model_t::collide_vertices_with_triangles(
+    point_bvh_model_t const& other,
+    contact_handler_t& handler)
+{
+    triangle_bvh_t const& triangles = other.triangle_bvh_;
+    if (m_nodes.empty() || triangles.empty())
+        return 0u;
+
+    scalar_type const tolerance2 = other.contact_tolerance_ * other.contact_tolerance_;
+    bool const use_boxes         = triangles.bounding_volume() == bounding_volume_t::aabb;
+
+    auto const squared_distance_to_triangle_node = [&](Eigen::Vector3d const& p,
+                                                       unsigned int triangle_node_idx) {
+        if (use_boxes)
+            return triangles.box(triangle_node_idx).squaredExteriorDistance(p);
+
+        Discregrid::BoundingSphere const& s = triangles.hull(triangle_node_idx);
+        scalar_type const d                 = std::max((p - s.x()).norm() - s.r(), 0.);
+        return d * d;
+    };
+
+    // the other model's triangles are read from its cached positions
+    auto const triangle_of = [&](index_type fi) {
+        triangle_bvh_t::triangle_type const& f = triangles.triangle(fi);
+        return triangle_t{
+            other.positions_[f[0u]],
+            other.positions_[f[1u]],
+            other.positions_[f[2u]]};
+    };
+
+    /**
+     * When the closest point lies on an edge or a vertex of the surface, several triangles are at
+     * the same closest distance, up to this bound
+     */
+    auto const tie_squared_distance_of = [&](scalar_type closest_squared_distance) {
+        return closest_squared_distance * (1. + 1e-6) + 1e-12 * tolerance2;
+    };
+
+    auto const add_candidate = [&](Eigen::Vector3d const& pi, index_type fi) {
+        auto const [q, barycentric_coordinates] = closest_point(pi, triangle_of(fi));
+        scalar_type const squared_distance     = (pi - q).squaredNorm();
+        candidates_.push_back({fi, squared_distance, q, barycentric_coordinates});
+        return squared_distance;
+    };
+
+    // the triangle's bounding box is much cheaper to test than its closest point
+    auto const is_triangle_within = [&](Eigen::Vector3d const& pi,
+                                        index_type fi,
+                                        scalar_type squared_distance) {
+        triangle_t const triangle = triangle_of(fi);
+        Eigen::Vector3d const lo  = triangle.a.cwiseMin(triangle.b).cwiseMin(triangle.c);
+        Eigen::Vector3d const hi  = triangle.a.cwiseMax(triangle.b).cwiseMax(triangle.c);
+        return (lo - pi).cwiseMax(pi - hi).cwiseMax(0.).squaredNorm() <= squared_distance;
+    };
+
+    index_type constexpr no_triangle = std::numeric_limits<index_type>::max();
+    std::vector<index_type>& closest_triangles = closest_triangles_[other.id()];
+    closest_triangles.resize(positions_.size(), no_triangle);
+
+    std::size_t visited_leaf_count = 0u;
+    auto const collide_vertex      = [&](index_type vi) {
+        Eigen::Vector3d const& pi = positions_[vi];
+
+        /**
+         * Any triangle bounds the distance to the closest ones. The previous closest triangle is
+         * the tightest bound known, unless the vertex moved far, and is tested first.
+         */
+        candidates_.clear();
+        scalar_type bound2     = std::numeric_limits<scalar_type>::infinity();
+        index_type const seed = closest_triangles[vi];
+        if (seed < triangles.triangle_count())
+            bound2 = tie_squared_distance_of(add_candidate(pi, seed));
+
+        auto const test_leaf = [&](std::uint32_t begin, std::uint32_t count) {
+            ++visited_leaf_count;
+            for (std::uint32_t j = begin; j < begin + count; ++j)
+            {
+                index_type const fi = use_boxes ? triangles.wide_bvh().entity(j) :
+                                                  triangles.entity(j);
+                if (fi == seed || !is_triangle_within(pi, fi, bound2))
+                    continue;
+
+                scalar_type const squared_distance = add_candidate(pi, fi);
+                if (squared_distance > bound2)
+                    candidates_.pop_back();
+                else
+                    bound2 = std::min(bound2, tie_squared_distance_of(squared_distance));
+            }
+        };
+
+        if (use_boxes)
+        {
+            // the 4 children of a wide node are tested against the bound at once
+            auto const child_mask = [&](wide_bvh_t::node_t const& node) -> unsigned int {
+                Eigen::Array4d const dx =
+                    (node.min_x - pi.x()).max(pi.x() - node.max_x).max(0.);
+                Eigen::Array4d const dy =
+                    (node.min_y - pi.y()).max(pi.y() - node.max_y).max(0.);
+                Eigen::Array4d const dz =
+                    (node.min_z - pi.z()).max(pi.z() - node.max_z).max(0.);
+                Eigen::Array4d const squared_distances = dx * dx + dy * dy + dz * dz;
+
+                unsigned int mask = 0u;
+                for (std::uint32_t k = 0u; k < node.child_count; ++k)
+                {
+                    if (squared_distances[k] <= bound2)
+                        mask |= 1u << k;
+                }
+                return mask;
+            };
+            triangles.wide_bvh().traverse(child_mask, test_leaf);
+        }
+        else
+        {
+            // nodes are stacked with their distance, the nearer child on top, which tightens
+            // the bound the soonest
+            triangle_nodes_.clear();
+            triangle_nodes_.push_back({0u, squared_distance_to_triangle_node(pi, 0u)});
+            while (!triangle_nodes_.empty())
+            {
+                auto const [triangle_node_idx, node_squared_distance] = triangle_nodes_.back();
+                triangle_nodes_.pop_back();
+
+                if (node_squared_distance > bound2)
+                    continue;
+
+                kd_tree_type::Node const& triangle_node = triangles.node(triangle_node_idx);
+                if (triangle_node.isLeaf())
+                {
+                    test_leaf(triangle_node.begin, triangle_node.n);
+                    continue;
+                }
+
+                auto const c1           = static_cast<unsigned int>(triangle_node.children[0u]);
+                auto const c2           = static_cast<unsigned int>(triangle_node.children[1u]);
+                scalar_type const d1    = squared_distance_to_triangle_node(pi, c1);
+                scalar_type const d2    = squared_distance_to_triangle_node(pi, c2);
+                bool const is_c1_nearer = d1 <= d2;
+                triangle_nodes_.push_back(is_c1_nearer ? std::make_pair(c2, d2) :
+                                                         std::make_pair(c1, d1));
+                triangle_nodes_.push_back(is_c1_nearer ? std::make_pair(c1, d1) :
+                                                         std::make_pair(c2, d2));
+            }
+        }
+
+        auto const closest = std::min_element(
+            candidates_.begin(),
+            candidates_.end(),
+            [](vertex_triangle_candidate_t const& c1, vertex_triangle_candidate_t const& c2) {
+                return c1.squared_distance < c2.squared_distance;
+            });
+        if (closest == candidates_.end())
+            return;
+
+        closest_triangles[vi] = closest->fi;
+
+        /**
+         * Among the triangles tied at the closest distance, the triangle whose plane is the
+         * farthest from the vertex gives the correct inside/outside classification.
+         */
+        scalar_type const tie_squared_distance = tie_squared_distance_of(closest->squared_distance);
+
+        vertex_triangle_candidate_t const* best = nullptr;
+        Eigen::Vector3d best_normal{};
+        scalar_type best_abs_signed_distance = -1.;
+        for (vertex_triangle_candidate_t const& candidate : candidates_)
+        {
+            if (candidate.squared_distance > tie_squared_distance)
+                continue;
+
+            Eigen::Vector3d const n = triangle_of(candidate.fi).normal();
+
+            scalar_type const abs_signed_distance = std::abs((pi - candidate.closest_point).dot(n));
+            if (abs_signed_distance > best_abs_signed_distance)
+            {
+                best                     = &candidate;
+                best_normal              = n;
+                best_abs_signed_distance = abs_signed_distance;
+            }
+        }
+
+        if (best == nullptr || !best_normal.allFinite())
+            return;
+
+        // surface triangles are oriented such that their normals point outwards
+        bool const is_vertex_penetrating = (pi - best->closest_point).dot(best_normal) < 0.;
+        if (!is_vertex_penetrating)
+            return;
+
+        surface_mesh_particle_to_triangle_contact_t const contact(
+            contact_t::type_t::surface_particle_to_surface_triangle,
+            this->id(),
+            other.id(),
+            best->closest_point,
+            best_normal,
+            vi,
+            best->fi,
+            best->barycentric_coordinates);
+
+        handler.handle(contact);
+    };
+
+    // only vertices within the other surface's bounding box can lie inside of it
+    volume_type const& other_volume = other.volume();
+    vertex_nodes_.clear();
+    vertex_nodes_.push_back(0u);
+    while (!vertex_nodes_.empty())
+    {
+        unsigned int const vertex_node_idx = vertex_nodes_.back();
+        vertex_nodes_.pop_back();
+
+        bool const does_node_overlap_other_volume =
+            bounding_volume_ == bounding_volume_t::aabb
+                ? this->box(vertex_node_idx).intersects(other_volume)
+                : other_volume.squaredExteriorDistance(this->hull(vertex_node_idx).x()) <=
+                      this->hull(vertex_node_idx).r() * this->hull(vertex_node_idx).r();
+        if (!does_node_overlap_other_volume)
+            continue;
+
+        kd_tree_type::Node const& vertex_node = this->node(vertex_node_idx);
+        if (!vertex_node.isLeaf())
+        {
+            for (int const child : vertex_node.children)
+                vertex_nodes_.push_back(static_cast<unsigned int>(child));
+            continue;
+        }
+
+        for (auto i = vertex_node.begin; i < vertex_node.begin + vertex_node.n; ++i)
+        {
+            index_type const vi = m_lst[i];
+            if (other_volume.contains(positions_[vi]))
+                collide_vertex(vi);
+        }
+    }
+
+    return visited_leaf_count;
+}
+
 } // namespace collision
 } // namespace physics
 } // namespace sbs
\ No newline at end of file
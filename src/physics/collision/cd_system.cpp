@@ -1,17 +1,66 @@
+#include <algorithm>
+#include <sbs/common/parallel.h>
 #include <sbs/physics/collision/cd_system.h>
+#include <sbs/physics/collision/collision_model.h>
+#include <unordered_map>
 
 namespace sbs {
 namespace physics {
 namespace collision {
 
+namespace {
+
+template <class ContactType>
+void hand_over(
+    ContactType const* begin,
+    ContactType const* end,
+    std::optional<contact_reduction_t>& contact_reduction,
+    contact_handler_t& handler)
+{
+    for_each_batch(begin, end, [&](ContactType const* batch, std::size_t count) {
+        if (!contact_reduction.has_value())
+        {
+            handler.handle(batch, count);
+            return;
+        }
+
+        std::vector<ContactType> const& reduced = contact_reduction->reduce(batch, count);
+        handler.handle(reduced.data(), reduced.size());
+    });
+}
+
+} // namespace
+
 cd_system_t::cd_system_t(std::vector<collision_model_t*> const& collision_objects)
-    : collision_objects_(collision_objects)
+    : collision_objects_(collision_objects),
+      contact_handler_(),
+      candidate_pairs_(),
+      broad_phase_margin_(0.),
+      tasks_(),
+      contact_buffers_(),
+      contact_reduction_()
+{
+}
+void cd_system_t::refresh_contacts()
 {
+    narrow_phase(candidate_pairs_);
 }
 std::vector<collision_model_t*> const& cd_system_t::collision_objects() const
 {
     return collision_objects_;
 }
+std::vector<cd_system_t::intersection_pair> const& cd_system_t::candidate_pairs() const
+{
+    return candidate_pairs_;
+}
+scalar_type cd_system_t::broad_phase_margin() const
+{
+    return broad_phase_margin_;
+}
+scalar_type& cd_system_t::broad_phase_margin()
+{
+    return broad_phase_margin_;
+}
 
 std::unique_ptr<contact_handler_t> const& cd_system_t::contact_handler() const
 {
@@ -25,10 +74,117 @@ void cd_system_t::use_contact_handler(std::unique_ptr<contact_handler_t> contact
 {
     contact_handler_ = std::move(contact_handler);
 }
+void cd_system_t::enable_contact_reduction(
+    scalar_type cluster_size,
+    std::size_t max_contacts_per_pair)
+{
+    contact_reduction_.emplace(cluster_size, max_contacts_per_pair);
+}
+void cd_system_t::disable_contact_reduction()
+{
+    contact_reduction_.reset();
+}
+std::optional<contact_reduction_t> const& cd_system_t::contact_reduction() const
+{
+    return contact_reduction_;
+}
 std::vector<collision_model_t*>& cd_system_t::collision_objects()
 {
     return collision_objects_;
 }
+std::vector<cd_system_t::intersection_pair>& cd_system_t::candidate_pairs()
+{
+    return candidate_pairs_;
+}
+
+void cd_system_t::narrow_phase(std::vector<intersection_pair> const& pairs)
+{
+    tasks_.clear();
+    tasks_.reserve(pairs.size() + collision_objects_.size());
+    for (auto const& [b1, b2] : pairs)
+        tasks_.push_back({b1, b2, 0u, 0u, 0u, 0u, 0u, 0u});
+    for (collision_model_t* object : collision_objects_)
+        tasks_.push_back({object, nullptr, 0u, 0u, 0u, 0u, 0u, 0u});
+
+    // A task runs in the round following the last round of the models it mutates
+    std::unordered_map<collision_model_t const*, std::uint32_t> next_rounds{};
+    next_rounds.reserve(collision_objects_.size());
+    auto const next_round = [&](collision_model_t const* model) -> std::uint32_t* {
+        if (model == nullptr || model->model_type() == model_type_t::sdf)
+            return nullptr;
+
+        return &next_rounds[model];
+    };
+
+    std::uint32_t round_count = 0u;
+    for (narrow_phase_task_t& task : tasks_)
+    {
+        std::uint32_t* const r1 = next_round(task.b1);
+        std::uint32_t* const r2 = next_round(task.b2);
+        task.round              = std::max(r1 ? *r1 : 0u, r2 ? *r2 : 0u);
+        if (r1)
+            *r1 = task.round + 1u;
+        if (r2)
+            *r2 = task.round + 1u;
+        round_count = std::max(round_count, task.round + 1u);
+    }
+
+    std::vector<std::size_t> schedule(tasks_.size());
+    for (std::size_t t = 0u; t < schedule.size(); ++t)
+        schedule[t] = t;
+    std::stable_sort(schedule.begin(), schedule.end(), [this](std::size_t a, std::size_t b) {
+        return tasks_[a].round < tasks_[b].round;
+    });
+
+    contact_buffers_.resize(common::thread_count());
+    for (contact_buffer_t& buffer : contact_buffers_)
+        buffer.clear();
+
+    auto round_begin = schedule.begin();
+    for (std::uint32_t round = 0u; round < round_count; ++round)
+    {
+        auto const round_end =
+            std::find_if(round_begin, schedule.end(), [this, round](std::size_t t) {
+                return tasks_[t].round != round;
+            });
+        common::parallel_for_chunks(
+            static_cast<std::size_t>(round_end - round_begin),
+            contact_buffers_.size(),
+            [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                contact_buffer_t& buffer = contact_buffers_[chunk];
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    narrow_phase_task_t& task    = tasks_[round_begin[i]];
+                    task.buffer                  = static_cast<std::uint32_t>(chunk);
+                    task.sdf_contacts_begin      = buffer.sdf_contacts().size();
+                    task.triangle_contacts_begin = buffer.triangle_contacts().size();
+                    if (task.b2 != nullptr)
+                        task.b1->collide(*task.b2, buffer);
+                    else
+                        task.b1->self_collide(buffer);
+                    task.sdf_contacts_end      = buffer.sdf_contacts().size();
+                    task.triangle_contacts_end = buffer.triangle_contacts().size();
+                }
+            });
+        round_begin = round_end;
+    }
+
+    contact_handler_t& handler = *contact_handler_;
+    for (narrow_phase_task_t const& task : tasks_)
+    {
+        contact_buffer_t const& buffer = contact_buffers_[task.buffer];
+        hand_over(
+            buffer.sdf_contacts().data() + task.sdf_contacts_begin,
+            buffer.sdf_contacts().data() + task.sdf_contacts_end,
+            contact_reduction_,
+            handler);
+        hand_over(
+            buffer.triangle_contacts().data() + task.triangle_contacts_begin,
+            buffer.triangle_contacts().data() + task.triangle_contacts_end,
+            contact_reduction_,
+            handler);
+    }
+}
 
 } // namespace collision
 } // namespace physics
@@ -4,6 +4,11 @@ namespace sbs {
 namespace physics {
 namespace collision {
 
+void collision_model_t::self_collide(contact_handler_t& handler)
+{
+    // no-op
+}
+
 collision_model_t::volume_type const& collision_model_t::volume() const
 {
     return englobing_volume_;
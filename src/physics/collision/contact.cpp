@@ -35,6 +35,83 @@ index_type& surface_mesh_particle_to_sdf_contact_t::vi()
     return vi_;
 }
 
+Eigen::Vector3d const& surface_mesh_particle_to_sdf_contact_t::sdf_velocity() const
+{
+    return sdf_velocity_;
+}
+
+index_type surface_mesh_particle_to_triangle_contact_t::vi() const
+{
+    return vi_;
+}
+
+index_type& surface_mesh_particle_to_triangle_contact_t::vi()
+{
+    return vi_;
+}
+
+index_type surface_mesh_particle_to_triangle_contact_t::fi() const
+{
+    return fi_;
+}
+
+index_type& surface_mesh_particle_to_triangle_contact_t::fi()
+{
+    return fi_;
+}
+
+Eigen::Vector3d const& surface_mesh_particle_to_triangle_contact_t::barycentric_coordinates() const
+{
+    return barycentric_coordinates_;
+}
+
+void contact_handler_t::handle(
+    surface_mesh_particle_to_sdf_contact_t const* contacts,
+    std::size_t count)
+{
+    for (std::size_t i = 0u; i < count; ++i)
+        handle(contacts[i]);
+}
+
+void contact_handler_t::handle(
+    surface_mesh_particle_to_triangle_contact_t const* contacts,
+    std::size_t count)
+{
+    for (std::size_t i = 0u; i < count; ++i)
+        handle(contacts[i]);
+}
+
+void contact_buffer_t::handle(contact_t const& contact)
+{
+    if (contact.type() == contact_t::type_t::surface_particle_to_sdf)
+    {
+        sdf_contacts_.push_back(
+            static_cast<surface_mesh_particle_to_sdf_contact_t const&>(contact));
+    }
+    if (contact.type() == contact_t::type_t::surface_particle_to_surface_triangle)
+    {
+        triangle_contacts_.push_back(
+            static_cast<surface_mesh_particle_to_triangle_contact_t const&>(contact));
+    }
+}
+
+std::vector<surface_mesh_particle_to_sdf_contact_t> const& contact_buffer_t::sdf_contacts() const
+{
+    return sdf_contacts_;
+}
+
+std::vector<surface_mesh_particle_to_triangle_contact_t> const&
+contact_buffer_t::triangle_contacts() const
+{
+    return triangle_contacts_;
+}
+
+void contact_buffer_t::clear()
+{
+    sdf_contacts_.clear();
+    triangle_contacts_.clear();
+}
+
 } // namespace collision
 } // namespace physics
 } // namespace sbs
\ No newline at end of file
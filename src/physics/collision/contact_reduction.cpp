@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sbs/physics/collision/contact_reduction.h>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+namespace {
+
+/**
+ * Packs the contact's cell coordinates, wrapped to 19 bits each, and the index of the signed axis
+ * closest to its normal. Cells that are more than 2^19 cells apart can share a key.
+ */
+std::uint64_t
+cluster_key(Eigen::Vector3d const& point, Eigen::Vector3d const& normal, scalar_type cluster_size)
+{
+    std::uint64_t constexpr mask = (std::uint64_t{1u} << 19u) - 1u;
+
+    Eigen::Index axis = 0;
+    normal.cwiseAbs().maxCoeff(&axis);
+    std::uint64_t const direction = 2u * static_cast<std::uint64_t>(axis) + (normal(axis) < 0.);
+
+    std::uint64_t key = direction << 57u;
+    if (cluster_size <= 0.)
+        return key;
+
+    for (int d = 0; d < 3; ++d)
+    {
+        auto const cell = static_cast<std::int64_t>(std::floor(point(d) / cluster_size));
+        key |= (static_cast<std::uint64_t>(cell) & mask) << (38u - 19u * static_cast<unsigned>(d));
+    }
+    return key;
+}
+
+} // namespace
+
+contact_reduction_t::contact_reduction_t(scalar_type cluster_size, std::size_t max_contacts)
+    : cluster_size_(cluster_size),
+      max_contacts_(max_contacts),
+      entries_{},
+      clusters_{},
+      kept_{},
+      sdf_contacts_{},
+      triangle_contacts_{}
+{
+}
+
+std::vector<surface_mesh_particle_to_sdf_contact_t> const& contact_reduction_t::reduce(
+    surface_mesh_particle_to_sdf_contact_t const* contacts,
+    std::size_t count)
+{
+    select(contacts, count, sdf_contacts_);
+    return sdf_contacts_;
+}
+
+std::vector<surface_mesh_particle_to_triangle_contact_t> const& contact_reduction_t::reduce(
+    surface_mesh_particle_to_triangle_contact_t const* contacts,
+    std::size_t count)
+{
+    select(contacts, count, triangle_contacts_);
+    return triangle_contacts_;
+}
+
+scalar_type contact_reduction_t::cluster_size() const
+{
+    return cluster_size_;
+}
+
+std::size_t contact_reduction_t::max_contacts() const
+{
+    return max_contacts_;
+}
+
+template <class ContactType>
+void contact_reduction_t::select(
+    ContactType const* contacts,
+    std::size_t count,
+    std::vector<ContactType>& reduced)
+{
+    reduced.clear();
+    if (count == 0u || max_contacts_ == 0u)
+        return;
+
+    entries_.resize(count);
+    for (std::size_t c = 0u; c < count; ++c)
+    {
+        ContactType const& contact = contacts[c];
+        entries_[c] = {
+            cluster_key(contact.point(), contact.normal(), cluster_size_),
+            static_cast<std::uint32_t>(c)};
+    }
+    // contacts are their own clusters if clustering is disabled
+    if (cluster_size_ > 0.)
+    {
+        std::sort(
+            entries_.begin(),
+            entries_.end(),
+            [](cluster_entry_t const& a, cluster_entry_t const& b) {
+                return a.key != b.key ? a.key < b.key : a.contact < b.contact;
+            });
+    }
+
+    clusters_.clear();
+    for (std::size_t begin = 0u; begin < count;)
+    {
+        std::size_t end = begin + 1u;
+        while (cluster_size_ > 0. && end < count && entries_[end].key == entries_[begin].key)
+            ++end;
+
+        Eigen::Vector3d centroid = Eigen::Vector3d::Zero();
+        for (std::size_t e = begin; e < end; ++e)
+            centroid += contacts[entries_[e].contact].point();
+        centroid /= static_cast<scalar_type>(end - begin);
+
+        std::uint32_t representative        = entries_[begin].contact;
+        scalar_type representative_distance = std::numeric_limits<scalar_type>::infinity();
+        for (std::size_t e = begin; e < end; ++e)
+        {
+            std::uint32_t const c = entries_[e].contact;
+            scalar_type const d2  = (contacts[c].point() - centroid).squaredNorm();
+            if (d2 < representative_distance)
+            {
+                representative          = c;
+                representative_distance = d2;
+            }
+        }
+
+        clusters_.push_back(
+            {representative,
+             static_cast<scalar_type>(end - begin),
+             std::numeric_limits<scalar_type>::infinity()});
+        begin = end;
+    }
+
+    kept_.clear();
+    if (clusters_.size() <= max_contacts_)
+    {
+        for (cluster_t const& cluster : clusters_)
+            kept_.push_back(cluster.representative);
+    }
+    else
+    {
+        // the heaviest cluster first, then weighted farthest point sampling
+        auto const heaviest = std::max_element(
+            clusters_.begin(),
+            clusters_.end(),
+            [](cluster_t const& a, cluster_t const& b) { return a.weight < b.weight; });
+        std::size_t next = static_cast<std::size_t>(heaviest - clusters_.begin());
+        while (kept_.size() < max_contacts_)
+        {
+            Eigen::Vector3d const& p = contacts[clusters_[next].representative].point();
+            kept_.push_back(clusters_[next].representative);
+            clusters_[next].weight = 0.;
+
+            scalar_type best_score = -1.;
+            for (std::size_t k = 0u; k < clusters_.size(); ++k)
+            {
+                cluster_t& cluster = clusters_[k];
+                if (cluster.weight == 0.)
+                    continue;
+
+                scalar_type const d2 = (contacts[cluster.representative].point() - p).squaredNorm();
+                cluster.squared_distance = std::min(cluster.squared_distance, d2);
+
+                scalar_type const score = cluster.weight * cluster.squared_distance;
+                if (score > best_score)
+                {
+                    best_score = score;
+                    next       = k;
+                }
+            }
+        }
+    }
+
+    std::sort(kept_.begin(), kept_.end());
+    reduced.reserve(kept_.size());
+    for (std::uint32_t const c : kept_)
+        reduced.push_back(contacts[c]);
+}
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
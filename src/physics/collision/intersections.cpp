@@ -65,6 +65,64 @@ std::optional<point_t> intersect_twoway(line_segment_t const& segment, triangle_
     return intersect(flipped_segment, triangle);
 }
 
+std::pair<point_t, Eigen::Vector3d> closest_point(point_t const& p, triangle_t const& triangle)
+{
+    /**
+     * Ericson, Christer. Real-time collision detection. Crc Press, 2004.
+     * Section 5.1.5, Closest Point on Triangle to Point
+     */
+    point_t const& a = triangle.a;
+    point_t const& b = triangle.b;
+    point_t const& c = triangle.c;
+
+    Eigen::Vector3d const ab = b - a;
+    Eigen::Vector3d const ac = c - a;
+    Eigen::Vector3d const ap = p - a;
+
+    double const d1 = ab.dot(ap);
+    double const d2 = ac.dot(ap);
+    if (d1 <= 0. && d2 <= 0.)
+        return {a, Eigen::Vector3d{1., 0., 0.}};
+
+    Eigen::Vector3d const bp = p - b;
+    double const d3          = ab.dot(bp);
+    double const d4          = ac.dot(bp);
+    if (d3 >= 0. && d4 <= d3)
+        return {b, Eigen::Vector3d{0., 1., 0.}};
+
+    double const vc = d1 * d4 - d3 * d2;
+    if (vc <= 0. && d1 >= 0. && d3 <= 0.)
+    {
+        double const v = d1 / (d1 - d3);
+        return {a + v * ab, Eigen::Vector3d{1. - v, v, 0.}};
+    }
+
+    Eigen::Vector3d const cp = p - c;
+    double const d5          = ab.dot(cp);
+    double const d6          = ac.dot(cp);
+    if (d6 >= 0. && d5 <= d6)
+        return {c, Eigen::Vector3d{0., 0., 1.}};
+
+    double const vb = d5 * d2 - d1 * d6;
+    if (vb <= 0. && d2 >= 0. && d6 <= 0.)
+    {
+        double const w = d2 / (d2 - d6);
+        return {a + w * ac, Eigen::Vector3d{1. - w, 0., w}};
+    }
+
+    double const va = d3 * d6 - d5 * d4;
+    if (va <= 0. && (d4 - d3) >= 0. && (d5 - d6) >= 0.)
+    {
+        double const w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return {b + w * (c - b), Eigen::Vector3d{0., 1. - w, w}};
+    }
+
+    double const denom = 1. / (va + vb + vc);
+    double const v     = vb * denom;
+    double const w     = vc * denom;
+    return {a + ab * v + ac * w, Eigen::Vector3d{1. - v - w, v, w}};
+}
+
 } // namespace collision
 } // namespace physics
 } // namespace sbs
\ No newline at end of file
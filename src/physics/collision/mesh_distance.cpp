@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sbs/common/parallel.h>
+#include <sbs/physics/collision/intersections.h>
+#include <sbs/physics/collision/mesh_distance.h>
+#include <utility>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+namespace {
+
+/**
+ * Layout of the nodes of a Discregrid::CubicLagrangeDiscreteGrid, mirroring its
+ * indexToNodePosition(). The grid's vertices come first, ordered by x, then y, then z, followed by
+ * the 2 nodes at a third and two thirds of every edge along x, then y, then z.
+ */
+class cubic_lagrange_node_layout_t
+{
+  public:
+    explicit cubic_lagrange_node_layout_t(Discregrid::CubicLagrangeDiscreteGrid const& grid)
+        : min_(grid.domain().min()),
+          cell_size_(grid.cellSize()),
+          inv_cell_size_(grid.invCellSize()),
+          n_{grid.resolution()[0], grid.resolution()[1], grid.resolution()[2]},
+          vertex_count_((n_[0] + 1u) * (n_[1] + 1u) * (n_[2] + 1u)),
+          x_edge_count_(n_[0] * (n_[1] + 1u) * (n_[2] + 1u)),
+          y_edge_count_((n_[0] + 1u) * n_[1] * (n_[2] + 1u)),
+          z_edge_count_((n_[0] + 1u) * (n_[1] + 1u) * n_[2])
+    {
+    }
+
+    std::size_t node_count() const
+    {
+        return vertex_count_ + 2u * (x_edge_count_ + y_edge_count_ + z_edge_count_);
+    }
+
+    Eigen::Vector3d position(std::size_t l) const
+    {
+        std::array<std::size_t, 3u> ijk{};
+        std::size_t axis   = 3u;
+        std::size_t offset = 0u;
+        if (l < vertex_count_)
+        {
+            ijk = {
+                l % (n_[0] + 1u),
+                l / (n_[0] + 1u) % (n_[1] + 1u),
+                l / ((n_[0] + 1u) * (n_[1] + 1u))};
+        }
+        else if ((l -= vertex_count_) < 2u * x_edge_count_)
+        {
+            std::size_t const e = l / 2u;
+            ijk                 = {e % n_[0], e / n_[0] % (n_[1] + 1u), e / (n_[0] * (n_[1] + 1u))};
+            axis                = 0u;
+            offset              = l % 2u;
+        }
+        else if ((l -= 2u * x_edge_count_) < 2u * y_edge_count_)
+        {
+            std::size_t const e = l / 2u;
+            ijk                 = {e / (n_[1] * (n_[2] + 1u)), e % n_[1], e / n_[1] % (n_[2] + 1u)};
+            axis                = 1u;
+            offset              = l % 2u;
+        }
+        else
+        {
+            l -= 2u * y_edge_count_;
+            std::size_t const e = l / 2u;
+            ijk                 = {e / n_[2] % (n_[0] + 1u), e / (n_[2] * (n_[0] + 1u)), e % n_[2]};
+            axis                = 2u;
+            offset              = l % 2u;
+        }
+
+        Eigen::Vector3d x{};
+        for (std::size_t a = 0u; a < 3u; ++a)
+            x(a) = min_(a) + cell_size_(a) * static_cast<scalar_type>(ijk[a]);
+        if (axis < 3u)
+            x(axis) += (1. + static_cast<scalar_type>(offset)) / 3. * cell_size_(axis);
+        return x;
+    }
+
+    /**
+     * @brief Inverse of position(), which rounds x to the nearest third of a cell
+     * @return The index of the node at x, or node_count() if there is none
+     */
+    std::size_t index(Eigen::Vector3d const& x) const
+    {
+        std::array<std::size_t, 3u> ijk{};
+        std::array<std::size_t, 3u> thirds{};
+        std::size_t axis = 3u;
+        for (std::size_t a = 0u; a < 3u; ++a)
+        {
+            scalar_type const t = std::round(3. * (x(a) - min_(a)) * inv_cell_size_(a));
+            if (t < 0. || t > 3. * static_cast<scalar_type>(n_[a]))
+                return node_count();
+
+            ijk[a]    = static_cast<std::size_t>(t) / 3u;
+            thirds[a] = static_cast<std::size_t>(t) % 3u;
+            if (thirds[a] == 0u)
+                continue;
+            if (axis < 3u)
+                return node_count();
+            axis = a;
+        }
+
+        if (axis == 3u)
+            return ijk[0] + (n_[0] + 1u) * (ijk[1] + (n_[1] + 1u) * ijk[2]);
+
+        std::size_t const offset = thirds[axis] - 1u;
+        if (axis == 0u)
+            return vertex_count_ + 2u * (ijk[0] + n_[0] * (ijk[1] + (n_[1] + 1u) * ijk[2])) +
+                   offset;
+        if (axis == 1u)
+            return vertex_count_ + 2u * x_edge_count_ +
+                   2u * (ijk[1] + n_[1] * (ijk[2] + (n_[2] + 1u) * ijk[0])) + offset;
+        return vertex_count_ + 2u * (x_edge_count_ + y_edge_count_) +
+               2u * (ijk[2] + n_[2] * (ijk[0] + (n_[0] + 1u) * ijk[1])) + offset;
+    }
+
+  private:
+    Eigen::Vector3d min_;
+    Eigen::Vector3d cell_size_;
+    Eigen::Vector3d inv_cell_size_;
+    std::array<std::size_t, 3u> n_;
+    std::size_t vertex_count_;
+    std::size_t x_edge_count_;
+    std::size_t y_edge_count_;
+    std::size_t z_edge_count_;
+};
+
+} // namespace
+
+mesh_distance_t::mesh_distance_t(
+    std::vector<Eigen::Vector3d> const& vertices,
+    std::vector<std::array<unsigned int, 3>> const& faces)
+    : Discregrid::KDTree<Discregrid::BoundingSphere>(faces.size()),
+      vertices_(vertices),
+      faces_(faces),
+      face_normals_(faces.size(), Eigen::Vector3d::Zero()),
+      edge_normals_(3u * faces.size(), Eigen::Vector3d::Zero()),
+      vertex_normals_(vertices.size(), Eigen::Vector3d::Zero()),
+      bvh_()
+{
+    std::vector<std::pair<std::uint64_t, std::size_t>> edges(3u * faces_.size());
+    for (std::size_t f = 0u; f < faces_.size(); ++f)
+    {
+        std::array<unsigned int, 3> const& face = faces_[f];
+
+        Eigen::Vector3d const& x0 = vertices_[face[0]];
+        Eigen::Vector3d const& x1 = vertices_[face[1]];
+        Eigen::Vector3d const& x2 = vertices_[face[2]];
+        Eigen::Vector3d const n   = (x1 - x0).cross(x2 - x0);
+        scalar_type const norm    = n.norm();
+        if (norm > 0.)
+            face_normals_[f] = n / norm;
+
+        for (std::size_t e = 0u; e < 3u; ++e)
+        {
+            unsigned int const v  = face[e];
+            unsigned int const v1 = face[(e + 1u) % 3u];
+            unsigned int const v2 = face[(e + 2u) % 3u];
+
+            // weight the incident face's normal by the angle of its corner at v
+            Eigen::Vector3d const a = (vertices_[v1] - vertices_[v]).normalized();
+            Eigen::Vector3d const b = (vertices_[v2] - vertices_[v]).normalized();
+            scalar_type const angle = std::acos(std::clamp(a.dot(b), -1., 1.));
+            vertex_normals_[v] += angle * face_normals_[f];
+
+            std::uint64_t const key = (std::uint64_t{std::min(v, v1)} << 32u) | std::max(v, v1);
+            edges[3u * f + e]       = {key, 3u * f + e};
+        }
+    }
+
+    // edges shared by two faces get the sum of both faces' normals
+    std::sort(edges.begin(), edges.end());
+    for (std::size_t begin = 0u; begin < edges.size();)
+    {
+        std::size_t end = begin + 1u;
+        while (end < edges.size() && edges[end].first == edges[begin].first)
+            ++end;
+
+        Eigen::Vector3d n = Eigen::Vector3d::Zero();
+        for (std::size_t i = begin; i < end; ++i)
+            n += face_normals_[edges[i].second / 3u];
+        for (std::size_t i = begin; i < end; ++i)
+            edge_normals_[edges[i].second] = n;
+
+        begin = end;
+    }
+
+    construct();
+    if (m_nodes.empty())
+        return;
+
+    auto const leaf_box = [&](std::uint32_t begin, std::uint32_t count, Eigen::AlignedBox3d& box) {
+        box.setEmpty();
+        for (std::uint32_t i = begin; i < begin + count; ++i)
+            for (unsigned int const v : faces_[m_lst[i]])
+                box.extend(vertices_[v]);
+    };
+    bvh_.build(m_nodes, m_lst, leaf_box);
+
+    // queries only traverse the wide hierarchy, which holds its own copy of the entity list
+    m_lst.clear();
+    m_lst.shrink_to_fit();
+    m_nodes.clear();
+    m_nodes.shrink_to_fit();
+    m_hulls.clear();
+    m_hulls.shrink_to_fit();
+}
+
+mesh_distance_t::closest_feature_t mesh_distance_t::closest_feature(Eigen::Vector3d const& p) const
+{
+    scalar_type best_squared_distance = std::numeric_limits<scalar_type>::infinity();
+    std::size_t best_face             = 0u;
+    Eigen::Vector3d best_point        = p;
+    Eigen::Vector3d best_barycentric  = Eigen::Vector3d::Zero();
+
+    auto const child_mask = [&](wide_bvh_t::node_t const& node) {
+        Eigen::Array4d const dx = (node.min_x - p.x()).max(p.x() - node.max_x).max(0.);
+        Eigen::Array4d const dy = (node.min_y - p.y()).max(p.y() - node.max_y).max(0.);
+        Eigen::Array4d const dz = (node.min_z - p.z()).max(p.z() - node.max_z).max(0.);
+        Eigen::Array4d const d2 = dx.square() + dy.square() + dz.square();
+
+        unsigned int mask = 0u;
+        for (int k = 0; k < 4; ++k)
+            mask |= d2(k) < best_squared_distance ? (1u << k) : 0u;
+        return mask;
+    };
+    auto const on_leaf = [&](std::uint32_t begin, std::uint32_t count) {
+        for (std::uint32_t i = begin; i < begin + count; ++i)
+        {
+            std::size_t const f                     = bvh_.entity(i);
+            std::array<unsigned int, 3> const& face = faces_[f];
+            triangle_t const triangle{vertices_[face[0]], vertices_[face[1]], vertices_[face[2]]};
+
+            auto const [q, barycentric] = closest_point(p, triangle);
+
+            scalar_type const squared_distance = (p - q).squaredNorm();
+            if (squared_distance < best_squared_distance)
+            {
+                best_squared_distance = squared_distance;
+                best_face             = f;
+                best_point            = q;
+                best_barycentric      = barycentric;
+            }
+        }
+    };
+    bvh_.traverse(child_mask, on_leaf);
+
+    if (best_squared_distance == std::numeric_limits<scalar_type>::infinity())
+        return {best_squared_distance, best_point, nullptr};
+
+    // zero barycentric coordinates identify the closest feature
+    std::size_t zero_count = 0u;
+    std::size_t zero_k     = 0u;
+    std::size_t nonzero_k  = 0u;
+    for (std::size_t k = 0u; k < 3u; ++k)
+    {
+        if (best_barycentric(static_cast<Eigen::Index>(k)) == 0.)
+        {
+            ++zero_count;
+            zero_k = k;
+        }
+        else
+        {
+            nonzero_k = k;
+        }
+    }
+
+    Eigen::Vector3d const& pseudo_normal =
+        zero_count == 2u ? vertex_normals_[faces_[best_face][nonzero_k]] :
+        zero_count == 1u ? edge_normals_[3u * best_face + (zero_k + 1u) % 3u] :
+                          face_normals_[best_face];
+
+    return {best_squared_distance, best_point, &pseudo_normal};
+}
+
+scalar_type mesh_distance_t::signed_distance(Eigen::Vector3d const& p) const
+{
+    closest_feature_t const closest = closest_feature(p);
+    if (closest.pseudo_normal == nullptr)
+        return closest.squared_distance;
+
+    scalar_type const distance = std::sqrt(closest.squared_distance);
+    return (p - closest.point).dot(*closest.pseudo_normal) < 0. ? -distance : distance;
+}
+
+std::pair<scalar_type, Eigen::Vector3d> mesh_distance_t::evaluate(Eigen::Vector3d const& p) const
+{
+    closest_feature_t const closest = closest_feature(p);
+    if (closest.pseudo_normal == nullptr)
+        return {closest.squared_distance, Eigen::Vector3d::Zero()};
+
+    Eigen::Vector3d const d    = p - closest.point;
+    scalar_type const distance = std::sqrt(closest.squared_distance);
+    bool const is_inside       = d.dot(*closest.pseudo_normal) < 0.;
+    if (distance == 0.)
+        return {0., closest.pseudo_normal->normalized()};
+
+    Eigen::Vector3d const direction = d / distance;
+    return is_inside ? std::make_pair(-distance, Eigen::Vector3d{-direction}) :
+                       std::make_pair(distance, direction);
+}
+
+Eigen::Vector3d mesh_distance_t::closest_surface_point(Eigen::Vector3d const& p) const
+{
+    return closest_feature(p).point;
+}
+
+bool mesh_distance_t::contains(Eigen::Vector3d const& p) const
+{
+    return signed_distance(p) < 0.;
+}
+
+void mesh_distance_t::signed_distance(
+    Eigen::Vector3d const* points,
+    std::size_t count,
+    scalar_type* signed_distances) const
+{
+    common::parallel_for(
+        count,
+        [&](std::size_t i) { signed_distances[i] = signed_distance(points[i]); },
+        64u);
+}
+
+unsigned int mesh_distance_t::add_to(Discregrid::CubicLagrangeDiscreteGrid& grid) const
+{
+    // Discregrid samples a grid's nodes through a callback which only receives their positions.
+    // All nodes are evaluated in parallel beforehand, and the callback looks their distances up
+    // by the index of the node at the sampled position.
+    cubic_lagrange_node_layout_t const layout{grid};
+    std::vector<Eigen::Vector3d> nodes(layout.node_count());
+    common::parallel_for(nodes.size(), [&](std::size_t l) { nodes[l] = layout.position(l); });
+
+    std::vector<scalar_type> signed_distances(nodes.size());
+    signed_distance(nodes.data(), nodes.size(), signed_distances.data());
+
+    // a node off the expected layout is evaluated on its own
+    scalar_type const max_squared_error = 1e-12 * grid.cellSize().squaredNorm();
+    return grid.addFunction([&](Eigen::Vector3d const& x) -> double {
+        std::size_t const l = layout.index(x);
+        if (l == nodes.size() || (nodes[l] - x).squaredNorm() > max_squared_error)
+            return signed_distance(x);
+
+        return signed_distances[l];
+    });
+}
+
+Eigen::AlignedBox3d mesh_distance_t::bounds() const
+{
+    Eigen::AlignedBox3d box{};
+    for (Eigen::Vector3d const& v : vertices_)
+        box.extend(v);
+    return box;
+}
+
+std::size_t mesh_distance_t::memory_footprint() const
+{
+    std::size_t const kd_tree_footprint = m_lst.capacity() * sizeof(unsigned int) +
+                                          m_nodes.capacity() * sizeof(Node) +
+                                          m_hulls.capacity() * sizeof(Discregrid::BoundingSphere);
+    std::size_t const normal_count =
+        face_normals_.capacity() + edge_normals_.capacity() + vertex_normals_.capacity();
+    return sizeof(*this) + vertices_.capacity() * sizeof(Eigen::Vector3d) +
+           faces_.capacity() * sizeof(std::array<unsigned int, 3>) +
+           normal_count * sizeof(Eigen::Vector3d) + kd_tree_footprint +
+           bvh_.memory_footprint() - sizeof(wide_bvh_t);
+}
+
+Eigen::Vector3d mesh_distance_t::entityPosition(unsigned int i) const
+{
+    std::array<unsigned int, 3> const& face = faces_[i];
+    return (vertices_[face[0]] + vertices_[face[1]] + vertices_[face[2]]) / 3.;
+}
+
+void mesh_distance_t::computeHull(unsigned int b, unsigned int n, Discregrid::BoundingSphere& hull)
+    const
+{
+    Eigen::AlignedBox3d box{};
+    for (unsigned int i = b; i < b + n; ++i)
+        for (unsigned int const v : faces_[m_lst[i]])
+            box.extend(vertices_[v]);
+
+    hull = Discregrid::BoundingSphere(box.center(), 0.5 * box.diagonal().norm());
+}
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <sbs/physics/collision/sdf_cache.h>
+#include <sstream>
+#include <system_error>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+namespace {
+
+/**
+ * Bumped whenever the way cached grids are computed or stored changes, which invalidates existing
+ * caches
+ */
+std::uint64_t constexpr cache_version = 3u;
+
+class fnv1a_hash_t
+{
+  public:
+    template <class T>
+    void add(T const& value)
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (unsigned char const byte : bytes)
+        {
+            hash_ ^= byte;
+            hash_ *= 0x100000001b3ull;
+        }
+    }
+
+    void add_bytes(char const* bytes, std::size_t size)
+    {
+        for (std::size_t i = 0u; i < size; ++i)
+        {
+            hash_ ^= static_cast<unsigned char>(bytes[i]);
+            hash_ *= 0x100000001b3ull;
+        }
+    }
+
+    std::uint64_t value() const { return hash_; }
+
+  private:
+    std::uint64_t hash_ = 0xcbf29ce484222325ull;
+};
+
+/**
+ * Appended to Discregrid's payload, because Discregrid reads grid files from their first byte
+ */
+struct cache_footer_t
+{
+    char magic[8];
+    std::uint64_t version;
+    std::uint64_t key; ///< Hash of the source mesh, domain and resolution
+    std::uint32_t resolution[3];
+    std::uint32_t reserved;
+    std::uint64_t payload_size; ///< Size of Discregrid's payload in bytes
+    std::uint64_t checksum;     ///< FNV-1a hash of Discregrid's payload
+};
+
+static_assert(sizeof(cache_footer_t) == 56u, "cache_footer_t must not be padded");
+
+char constexpr cache_magic[8] = {'S', 'B', 'S', 'S', 'D', 'F', '\0', '\0'};
+
+/**
+ * Hashes the first size bytes of is
+ * @return The hash, or nothing if is holds fewer than size bytes
+ */
+std::optional<std::uint64_t> checksum(std::istream& is, std::uint64_t size)
+{
+    fnv1a_hash_t hash{};
+    char buffer[1u << 16u];
+    while (size > 0u)
+    {
+        auto const count =
+            static_cast<std::streamsize>(std::min<std::uint64_t>(size, sizeof(buffer)));
+        if (!is.read(buffer, count))
+            return {};
+
+        hash.add_bytes(buffer, static_cast<std::size_t>(count));
+        size -= static_cast<std::uint64_t>(count);
+    }
+    return hash.value();
+}
+
+/**
+ * @return true if the file at path holds a complete payload stored under key with the given
+ * resolution
+ */
+bool is_valid_cache_file(
+    std::filesystem::path const& path,
+    std::uint64_t key,
+    std::array<unsigned int, 3u> const& resolution)
+{
+    std::error_code ec{};
+    std::uintmax_t const file_size = std::filesystem::file_size(path, ec);
+    if (ec || file_size <= sizeof(cache_footer_t))
+        return false;
+
+    std::ifstream ifs{path, std::ios::binary};
+    cache_footer_t footer{};
+    ifs.seekg(static_cast<std::streamoff>(file_size - sizeof(cache_footer_t)));
+    if (!ifs.read(reinterpret_cast<char*>(&footer), sizeof(cache_footer_t)))
+        return false;
+
+    bool const is_footer_valid =
+        std::memcmp(footer.magic, cache_magic, sizeof(cache_magic)) == 0 &&
+        footer.version == cache_version && footer.key == key &&
+        footer.resolution[0] == resolution[0] && footer.resolution[1] == resolution[1] &&
+        footer.resolution[2] == resolution[2] &&
+        footer.payload_size == file_size - sizeof(cache_footer_t);
+    if (!is_footer_valid)
+        return false;
+
+    ifs.seekg(0);
+    std::optional<std::uint64_t> const payload_checksum = checksum(ifs, footer.payload_size);
+    return payload_checksum.has_value() && *payload_checksum == footer.checksum;
+}
+
+} // namespace
+
+sdf_cache_t::sdf_cache_t(std::filesystem::path const& directory)
+    : directory_(directory), mutex_(), grids_()
+{
+}
+
+std::uint64_t sdf_cache_t::key(
+    std::vector<Eigen::Vector3d> const& vertices,
+    std::vector<std::array<unsigned int, 3>> const& faces,
+    Eigen::AlignedBox3d const& domain,
+    std::array<unsigned int, 3u> const& resolution)
+{
+    fnv1a_hash_t hash{};
+    hash.add(cache_version);
+    hash.add(static_cast<std::uint64_t>(vertices.size()));
+    for (Eigen::Vector3d const& v : vertices)
+    {
+        hash.add(v.x());
+        hash.add(v.y());
+        hash.add(v.z());
+    }
+    hash.add(static_cast<std::uint64_t>(faces.size()));
+    for (std::array<unsigned int, 3> const& f : faces)
+    {
+        hash.add(f[0]);
+        hash.add(f[1]);
+        hash.add(f[2]);
+    }
+    for (int d = 0; d < 3; ++d)
+    {
+        hash.add(domain.min()(d));
+        hash.add(domain.max()(d));
+        hash.add(resolution[static_cast<std::size_t>(d)]);
+    }
+    return hash.value();
+}
+
+std::shared_ptr<Discregrid::CubicLagrangeDiscreteGrid const>
+sdf_cache_t::load(std::uint64_t key, std::array<unsigned int, 3u> const& resolution) const
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    auto const it = grids_.find(key);
+    if (it != grids_.end())
+    {
+        std::shared_ptr<grid_type const> grid = it->second.lock();
+        if (grid && grid->resolution() == resolution)
+            return grid;
+    }
+
+    std::filesystem::path const grid_path = path(key);
+
+    std::error_code ec{};
+    if (!std::filesystem::is_regular_file(grid_path, ec) ||
+        !is_valid_cache_file(grid_path, key, resolution))
+        return nullptr;
+
+    auto grid = std::make_shared<grid_type const>(grid_path.string());
+    if (grid->resolution() != resolution)
+        return nullptr;
+
+    grids_[key] = grid;
+    return grid;
+}
+
+bool sdf_cache_t::store(std::uint64_t key, std::shared_ptr<grid_type const> const& grid) const
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    grids_[key] = grid;
+
+    std::error_code ec{};
+    std::filesystem::create_directories(directory_, ec);
+    if (ec)
+        return false;
+
+    std::filesystem::path const grid_path = path(key);
+    std::filesystem::path temporary_path  = grid_path;
+    temporary_path += ".tmp";
+
+    auto const discard = [&temporary_path]() {
+        std::error_code remove_ec{};
+        std::filesystem::remove(temporary_path, remove_ec);
+        return false;
+    };
+
+    // Discregrid reports no write errors, so its payload is read back and checked instead
+    grid->save(temporary_path.string());
+    std::uintmax_t const payload_size = std::filesystem::file_size(temporary_path, ec);
+    if (ec || payload_size == 0u)
+        return discard();
+
+    cache_footer_t footer{};
+    std::memcpy(footer.magic, cache_magic, sizeof(cache_magic));
+    footer.version       = cache_version;
+    footer.key           = key;
+    footer.resolution[0] = grid->resolution()[0];
+    footer.resolution[1] = grid->resolution()[1];
+    footer.resolution[2] = grid->resolution()[2];
+    footer.reserved      = 0u;
+    footer.payload_size  = payload_size;
+    {
+        std::ifstream ifs{temporary_path, std::ios::binary};
+        std::optional<std::uint64_t> const payload_checksum = checksum(ifs, payload_size);
+        if (!payload_checksum.has_value())
+            return discard();
+
+        footer.checksum = *payload_checksum;
+    }
+    {
+        std::ofstream ofs{temporary_path, std::ios::binary | std::ios::app};
+        ofs.write(reinterpret_cast<char const*>(&footer), sizeof(cache_footer_t));
+        ofs.close();
+        if (!ofs)
+            return discard();
+    }
+
+    std::filesystem::rename(temporary_path, grid_path, ec);
+    if (ec)
+        return discard();
+
+    return true;
+}
+
+std::filesystem::path sdf_cache_t::path(std::uint64_t key) const
+{
+    std::ostringstream filename{};
+    filename << std::hex << std::setw(16) << std::setfill('0') << key << ".cdf";
+    return directory_ / filename.str();
+}
+
+std::filesystem::path const& sdf_cache_t::directory() const
+{
+    return directory_;
+}
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
@@ -1,25 +1,170 @@
 #include "..\..\..\include\sbs\physics\collision\sdf_model.h"
 
+#include <algorithm>
+#include <cmath>
+#include <sbs/common/parallel.h>
 #include <sbs/physics/collision/bvh_model.h>
 #include <sbs/physics/collision/contact.h>
+#include <sbs/physics/collision/mesh_distance.h>
 #include <sbs/physics/collision/sdf_model.h>
+#include <tuple>
 
 namespace sbs {
 namespace physics {
 namespace collision {
 
+namespace {
+
+std::pair<scalar_type, Eigen::Vector3d>
+sphere_sdf(Eigen::Vector3d const& center, scalar_type radius, Eigen::Vector3d const& p)
+{
+    Eigen::Vector3d const d    = p - center;
+    scalar_type const n        = d.norm();
+    Eigen::Vector3d const grad = n > 0. ? Eigen::Vector3d{d / n} : Eigen::Vector3d::UnitX();
+    return {n - radius, grad};
+}
+
+std::pair<scalar_type, Eigen::Vector3d> box_sdf(
+    Eigen::Vector3d const& center,
+    Eigen::Vector3d const& half_extents,
+    Eigen::Vector3d const& p)
+{
+    Eigen::Vector3d const d     = p - center;
+    Eigen::Vector3d const q     = d.cwiseAbs() - half_extents;
+    Eigen::Vector3d const q_pos = q.cwiseMax(0.);
+    scalar_type const outside   = q_pos.norm();
+    if (outside > 0.)
+        return {outside, d.cwiseSign().cwiseProduct(q_pos) / outside};
+
+    // inside, the closest face is the one along the axis of largest q
+    int const axis = q.x() >= q.y() ? (q.x() >= q.z() ? 0 : 2) : (q.y() >= q.z() ? 1 : 2);
+
+    Eigen::Vector3d grad = Eigen::Vector3d::Zero();
+    grad(axis)           = d(axis) < 0. ? -1. : 1.;
+    return {q(axis), grad};
+}
+
+} // namespace
+
 sdf_model_t::sdf_model_t(
     Eigen::AlignedBox3d const& domain,
     std::array<unsigned int, 3u> const& resolution)
-    : sdf_(domain, resolution)
+    : sdf_(std::make_shared<Discregrid::CubicLagrangeDiscreteGrid const>(domain, resolution)),
+      sparse_sdf_(),
+      mesh_(),
+      analytic_sdf_(),
+      shape_type_(shape_type_t::grid),
+      plane_(),
+      center_(Eigen::Vector3d::Zero()),
+      half_extents_(Eigen::Vector3d::Zero()),
+      radius_(0.),
+      transform_(Eigen::Affine3d::Identity()),
+      inverse_transform_(Eigen::Affine3d::Identity()),
+      scale_(1.),
+      is_transformed_(false),
+      local_volume_(),
+      linear_velocity_(Eigen::Vector3d::Zero()),
+      angular_velocity_(Eigen::Vector3d::Zero())
 {
 }
 
-sdf_model_t::sdf_model_t(Discregrid::CubicLagrangeDiscreteGrid const& sdf) : sdf_(sdf) {}
+sdf_model_t::sdf_model_t(Discregrid::CubicLagrangeDiscreteGrid const& sdf)
+    : sdf_model_t(std::make_shared<Discregrid::CubicLagrangeDiscreteGrid const>(sdf))
+{
+}
+
+sdf_model_t::sdf_model_t(std::shared_ptr<Discregrid::CubicLagrangeDiscreteGrid const> const& sdf)
+    : sdf_(sdf),
+      sparse_sdf_(),
+      mesh_(),
+      analytic_sdf_(),
+      shape_type_(shape_type_t::grid),
+      plane_(),
+      center_(Eigen::Vector3d::Zero()),
+      half_extents_(Eigen::Vector3d::Zero()),
+      radius_(0.),
+      transform_(Eigen::Affine3d::Identity()),
+      inverse_transform_(Eigen::Affine3d::Identity()),
+      scale_(1.),
+      is_transformed_(false),
+      local_volume_(),
+      linear_velocity_(Eigen::Vector3d::Zero()),
+      angular_velocity_(Eigen::Vector3d::Zero())
+{
+}
 
 sdf_model_t::sdf_model_t(analytic_sdf_type const& analytic_sdf, Eigen::AlignedBox3d const& volume)
-    : sdf_(Eigen::AlignedBox3d(), {2, 2, 2} /*dummy values*/), analytic_sdf_(analytic_sdf)
+    : sdf_(),
+      sparse_sdf_(),
+      analytic_sdf_(analytic_sdf),
+      shape_type_(shape_type_t::function),
+      plane_(),
+      center_(Eigen::Vector3d::Zero()),
+      half_extents_(Eigen::Vector3d::Zero()),
+      radius_(0.),
+      transform_(Eigen::Affine3d::Identity()),
+      inverse_transform_(Eigen::Affine3d::Identity()),
+      scale_(1.),
+      is_transformed_(false),
+      local_volume_(),
+      linear_velocity_(Eigen::Vector3d::Zero()),
+      angular_velocity_(Eigen::Vector3d::Zero())
+{
+    this->volume() = volume;
+}
+
+sdf_model_t::sdf_model_t(sparse_sdf_t const& sdf)
+    : sdf_model_t(std::make_shared<sparse_sdf_t const>(sdf))
 {
+}
+
+sdf_model_t::sdf_model_t(std::shared_ptr<sparse_sdf_t const> const& sdf)
+    : sdf_(),
+      sparse_sdf_(sdf),
+      mesh_(),
+      analytic_sdf_(),
+      shape_type_(shape_type_t::sparse),
+      plane_(),
+      center_(Eigen::Vector3d::Zero()),
+      half_extents_(Eigen::Vector3d::Zero()),
+      radius_(0.),
+      transform_(Eigen::Affine3d::Identity()),
+      inverse_transform_(Eigen::Affine3d::Identity()),
+      scale_(1.),
+      is_transformed_(false),
+      local_volume_(),
+      linear_velocity_(Eigen::Vector3d::Zero()),
+      angular_velocity_(Eigen::Vector3d::Zero())
+{
+    this->volume() = sparse_sdf_->domain();
+}
+
+sdf_model_t::sdf_model_t(std::shared_ptr<mesh_distance_t const> const& mesh)
+    : sdf_(),
+      sparse_sdf_(),
+      mesh_(mesh),
+      analytic_sdf_(),
+      shape_type_(shape_type_t::mesh),
+      plane_(),
+      center_(Eigen::Vector3d::Zero()),
+      half_extents_(Eigen::Vector3d::Zero()),
+      radius_(0.),
+      transform_(Eigen::Affine3d::Identity()),
+      inverse_transform_(Eigen::Affine3d::Identity()),
+      scale_(1.),
+      is_transformed_(false),
+      local_volume_(),
+      linear_velocity_(Eigen::Vector3d::Zero()),
+      angular_velocity_(Eigen::Vector3d::Zero())
+{
+    Eigen::AlignedBox3d volume = mesh_->bounds();
+    if (!volume.isEmpty())
+    {
+        Eigen::Vector3d const padding =
+            1.0e-3 * volume.diagonal().norm() * Eigen::Vector3d::Ones();
+        volume.min() -= padding;
+        volume.max() += padding;
+    }
     this->volume() = volume;
 }
 
@@ -60,20 +205,443 @@ sdf_model_t sdf_model_t::from_plane(
         return std::make_pair(sd, grad);
     };
     sdf_model_t sdf{analytic_sdf, volume};
+    sdf.shape_type_ = shape_type_t::plane;
+    sdf.plane_      = plane;
+    return sdf;
+}
+
+sdf_model_t sdf_model_t::from_sphere(
+    Eigen::Vector3d const& center,
+    scalar_type radius,
+    Eigen::AlignedBox3d const& volume)
+{
+    auto const analytic_sdf =
+        [center, radius](Eigen::Vector3d const& pi) -> std::pair<scalar_type, Eigen::Vector3d> {
+        return sphere_sdf(center, radius, pi);
+    };
+    sdf_model_t sdf{analytic_sdf, volume};
+    sdf.shape_type_ = shape_type_t::sphere;
+    sdf.center_     = center;
+    sdf.radius_     = radius;
+    return sdf;
+}
+
+sdf_model_t sdf_model_t::from_box(Eigen::AlignedBox3d const& box, Eigen::AlignedBox3d const& volume)
+{
+    Eigen::Vector3d const center       = box.center();
+    Eigen::Vector3d const half_extents = 0.5 * box.sizes();
+    auto const analytic_sdf =
+        [center,
+         half_extents](Eigen::Vector3d const& pi) -> std::pair<scalar_type, Eigen::Vector3d> {
+        return box_sdf(center, half_extents, pi);
+    };
+    sdf_model_t sdf{analytic_sdf, volume};
+    sdf.shape_type_   = shape_type_t::box;
+    sdf.center_       = center;
+    sdf.half_extents_ = half_extents;
     return sdf;
 }
 
+sdf_model_t sdf_model_t::from_mesh(
+    std::vector<Eigen::Vector3d> const& vertices,
+    std::vector<std::array<unsigned int, 3>> const& faces)
+{
+    return sdf_model_t(std::make_shared<mesh_distance_t const>(vertices, faces));
+}
+
+Eigen::Affine3d const& sdf_model_t::transform() const
+{
+    return transform_;
+}
+
+void sdf_model_t::set_transform(Eigen::Affine3d const& transform)
+{
+    if (!is_transformed_)
+        local_volume_ = volume();
+
+    transform_         = transform;
+    inverse_transform_ = transform.inverse(Eigen::Affine);
+    scale_             = transform.linear().col(0).norm();
+    is_transformed_    = !transform.matrix().isIdentity(0.);
+    if (!local_volume_.isEmpty())
+        volume() = local_volume_.transformed(transform);
+}
+
+sdf_model_t sdf_model_t::instance(Eigen::Affine3d const& transform) const
+{
+    sdf_model_t instance{*this};
+    instance.set_transform(transform);
+    instance.linear_velocity_.setZero();
+    instance.angular_velocity_.setZero();
+    return instance;
+}
+
+Eigen::Vector3d const& sdf_model_t::linear_velocity() const
+{
+    return linear_velocity_;
+}
+
+Eigen::Vector3d& sdf_model_t::linear_velocity()
+{
+    return linear_velocity_;
+}
+
+Eigen::Vector3d const& sdf_model_t::angular_velocity() const
+{
+    return angular_velocity_;
+}
+
+Eigen::Vector3d& sdf_model_t::angular_velocity()
+{
+    return angular_velocity_;
+}
+
+Eigen::Vector3d sdf_model_t::velocity(Eigen::Vector3d const& p) const
+{
+    return linear_velocity_ + angular_velocity_.cross(p - transform_.translation());
+}
+
+void sdf_model_t::advance(scalar_type dt)
+{
+    Eigen::Vector3d const origin = transform_.translation();
+    scalar_type const angle      = angular_velocity_.norm() * dt;
+
+    // rotate about the local frame's origin, then translate
+    Eigen::Affine3d motion = Eigen::Affine3d::Identity();
+    motion.translate(origin + linear_velocity_ * dt);
+    if (angle > 0.)
+        motion.rotate(Eigen::AngleAxisd(angle, angular_velocity_.normalized()));
+    motion.translate(-origin);
+
+    set_transform(motion * transform_);
+}
+
 std::pair<scalar_type, Eigen::Vector3d> sdf_model_t::evaluate(Eigen::Vector3d const& p) const
 {
-    if (analytic_sdf_)
-        return analytic_sdf_(p);
+    if (!is_transformed_)
+        return evaluate_local(p);
+
+    // uniform scaling scales distances, but not the gradient's direction
+    auto const [signed_distance, grad] = evaluate_local(inverse_transform_ * p);
+    return {scale_ * signed_distance, (transform_.linear() / scale_) * grad};
+}
+
+Eigen::Vector3d sdf_model_t::closest_point_in_domain(Eigen::Vector3d const& p) const
+{
+    if (shape_type_ != shape_type_t::grid && shape_type_ != shape_type_t::sparse)
+        return p;
+
+    Eigen::AlignedBox3d const& domain =
+        shape_type_ == shape_type_t::grid ? sdf_->domain() : sparse_sdf_->domain();
+    Eigen::Vector3d const local_p = is_transformed_ ? Eigen::Vector3d{inverse_transform_ * p} : p;
+    Eigen::Vector3d const clamped = local_p.cwiseMax(domain.min()).cwiseMin(domain.max());
+    return is_transformed_ ? Eigen::Vector3d{transform_ * clamped} : clamped;
+}
+
+void sdf_model_t::evaluate(
+    Eigen::Vector3d const* points,
+    std::size_t count,
+    scalar_type* signed_distances,
+    Eigen::Vector3d* gradients) const
+{
+    evaluate(points, count, signed_distances, gradients, nullptr);
+}
+
+void sdf_model_t::evaluate(
+    Eigen::Vector3d const* points,
+    std::size_t count,
+    scalar_type* signed_distances,
+    Eigen::Vector3d* gradients,
+    std::vector<std::size_t>* grid_order) const
+{
+    if (!is_transformed_)
+    {
+        evaluate_local(points, count, signed_distances, gradients, grid_order);
+        return;
+    }
+
+    // small batches, like the children of a wide hierarchy node, are moved without allocating
+    std::size_t constexpr max_stack_count = 64u;
+    std::array<Eigen::Vector3d, max_stack_count> stack_points;
+    std::vector<Eigen::Vector3d> heap_points{};
+    Eigen::Vector3d* local_points = stack_points.data();
+    if (count > max_stack_count)
+    {
+        heap_points.resize(count);
+        local_points = heap_points.data();
+    }
+
+    for (std::size_t i = 0u; i < count; ++i)
+        local_points[i] = inverse_transform_ * points[i];
+
+    evaluate_local(local_points, count, signed_distances, gradients, grid_order);
+
+    Eigen::Matrix3d const rotation = transform_.linear() / scale_;
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        signed_distances[i] *= scale_;
+        gradients[i] = rotation * gradients[i];
+    }
+}
+
+std::pair<scalar_type, Eigen::Vector3d> sdf_model_t::evaluate_local(Eigen::Vector3d const& p) const
+{
+    switch (shape_type_)
+    {
+        case shape_type_t::plane: return {plane_.signedDistance(p), plane_.normal()};
+        case shape_type_t::sphere: return sphere_sdf(center_, radius_, p);
+        case shape_type_t::box: return box_sdf(center_, half_extents_, p);
+        case shape_type_t::function: return analytic_sdf_(p);
+        case shape_type_t::sparse: return sparse_sdf_->evaluate(p);
+        case shape_type_t::mesh: return mesh_->evaluate(p);
+        case shape_type_t::grid: break;
+    }
 
     unsigned int constexpr sdf_idx = 0u;
     Eigen::Vector3d grad{};
-    double const signed_distance = sdf_.interpolate(sdf_idx, p, &grad);
+    double const signed_distance = sdf_->interpolate(sdf_idx, p, &grad);
     return {static_cast<scalar_type>(signed_distance), grad};
 }
 
+void sdf_model_t::evaluate_local(
+    Eigen::Vector3d const* points,
+    std::size_t count,
+    scalar_type* signed_distances,
+    Eigen::Vector3d* gradients,
+    std::vector<std::size_t>* grid_order) const
+{
+    if (count == 0u)
+        return;
+
+    // the analytic shapes' distance functions are inlined into tight loops
+    switch (shape_type_)
+    {
+        case shape_type_t::plane: {
+            Eigen::Vector3d const n = plane_.normal();
+            scalar_type const o     = plane_.offset();
+            for (std::size_t i = 0u; i < count; ++i)
+            {
+                signed_distances[i] = n.dot(points[i]) + o;
+                gradients[i]        = n;
+            }
+            break;
+        }
+        case shape_type_t::sphere: {
+            for (std::size_t i = 0u; i < count; ++i)
+            {
+                std::tie(signed_distances[i], gradients[i]) =
+                    sphere_sdf(center_, radius_, points[i]);
+            }
+            break;
+        }
+        case shape_type_t::box: {
+            for (std::size_t i = 0u; i < count; ++i)
+            {
+                std::tie(signed_distances[i], gradients[i]) =
+                    box_sdf(center_, half_extents_, points[i]);
+            }
+            break;
+        }
+        case shape_type_t::function: {
+            for (std::size_t i = 0u; i < count; ++i)
+                std::tie(signed_distances[i], gradients[i]) = analytic_sdf_(points[i]);
+            break;
+        }
+        case shape_type_t::sparse: {
+            for (std::size_t i = 0u; i < count; ++i)
+                std::tie(signed_distances[i], gradients[i]) = sparse_sdf_->evaluate(points[i]);
+            break;
+        }
+        case shape_type_t::mesh: {
+            // closest point queries are expensive enough to parallelize small batches
+            common::parallel_for(
+                count,
+                [&](std::size_t i) {
+                    std::tie(signed_distances[i], gradients[i]) = mesh_->evaluate(points[i]);
+                },
+                64u);
+            break;
+        }
+        case shape_type_t::grid: {
+            evaluate_grid(points, count, signed_distances, gradients, grid_order);
+            break;
+        }
+    }
+}
+
+void sdf_model_t::evaluate(
+    std::vector<Eigen::Vector3d> const& points,
+    std::vector<scalar_type>& signed_distances,
+    std::vector<Eigen::Vector3d>& gradients) const
+{
+    signed_distances.resize(points.size());
+    gradients.resize(points.size());
+    evaluate(points.data(), points.size(), signed_distances.data(), gradients.data());
+}
+
+void sdf_model_t::evaluate(
+    std::vector<Eigen::Vector3d> const& points,
+    std::vector<scalar_type>& signed_distances,
+    std::vector<Eigen::Vector3d>& gradients,
+    std::vector<std::size_t>& grid_order) const
+{
+    signed_distances.resize(points.size());
+    gradients.resize(points.size());
+    evaluate(
+        points.data(),
+        points.size(),
+        signed_distances.data(),
+        gradients.data(),
+        &grid_order);
+}
+
+std::optional<scalar_type>
+sdf_model_t::sphere_trace(Eigen::Vector3d const& p0, Eigen::Vector3d const& p1) const
+{
+    Eigen::Vector3d const d  = p1 - p0;
+    scalar_type const length = d.norm();
+    if (length <= 0.)
+        return {};
+
+    // clip the segment to the volume, outside of which grid sdfs are undefined
+    scalar_type t     = 0.;
+    scalar_type t_end = 1.;
+    if (!volume().isEmpty())
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            if (d(c) == 0.)
+            {
+                if (p0(c) < volume().min()(c) || p0(c) > volume().max()(c))
+                    return {};
+                continue;
+            }
+            scalar_type const t1 = (volume().min()(c) - p0(c)) / d(c);
+            scalar_type const t2 = (volume().max()(c) - p0(c)) / d(c);
+            t                    = std::max(t, std::min(t1, t2));
+            t_end                = std::min(t_end, std::max(t1, t2));
+        }
+        if (t > t_end)
+            return {};
+    }
+
+    std::size_t constexpr max_step_count = 64u;
+    scalar_type const tolerance          = 1e-3 * length;
+    for (std::size_t step = 0u; step < max_step_count && t <= t_end; ++step)
+    {
+        scalar_type const signed_distance = evaluate(p0 + t * d).first;
+        if (signed_distance < tolerance)
+            return t;
+
+        // no point of the sdf's zero level set is closer than the signed distance
+        t += signed_distance / length;
+    }
+    return {};
+}
+
+std::size_t sdf_model_t::memory_footprint() const
+{
+    std::size_t sdf_footprint = 0u;
+    std::size_t instances     = 1u;
+    if (shape_type_ == shape_type_t::sparse)
+    {
+        sdf_footprint = sparse_sdf_->memory_footprint();
+        instances     = static_cast<std::size_t>(sparse_sdf_.use_count());
+    }
+    if (shape_type_ == shape_type_t::mesh)
+    {
+        sdf_footprint = mesh_->memory_footprint();
+        instances     = static_cast<std::size_t>(mesh_.use_count());
+    }
+    if (shape_type_ == shape_type_t::grid)
+    {
+        // one field of a cubic Lagrange grid stores a double per node, and 32 node indices and a
+        // cell map entry per cell
+        std::size_t const nx         = sdf_->resolution()[0];
+        std::size_t const ny         = sdf_->resolution()[1];
+        std::size_t const nz         = sdf_->resolution()[2];
+        std::size_t const node_count = (3u * nx + 1u) * (3u * ny + 1u) * (3u * nz + 1u);
+        std::size_t const cell_count = nx * ny * nz;
+
+        sdf_footprint = sizeof(Discregrid::CubicLagrangeDiscreteGrid) +
+                        node_count * sizeof(double) + cell_count * 33u * sizeof(unsigned int);
+        instances     = static_cast<std::size_t>(sdf_.use_count());
+    }
+    return sizeof(*this) + sdf_footprint / std::max<std::size_t>(instances, 1u);
+}
+
+void sdf_model_t::evaluate_grid(
+    Eigen::Vector3d const* points,
+    std::size_t count,
+    scalar_type* signed_distances,
+    Eigen::Vector3d* gradients,
+    std::vector<std::size_t>* grid_order) const
+{
+    unsigned int constexpr sdf_idx = 0u;
+
+    auto const interpolate = [&](std::size_t i) {
+        Eigen::Vector3d grad{};
+        double const signed_distance = sdf_->interpolate(sdf_idx, points[i], &grad);
+        signed_distances[i]          = static_cast<scalar_type>(signed_distance);
+        gradients[i]                 = grad;
+    };
+
+    // grouping only pays off once several points share cells
+    std::size_t constexpr min_grouped_count = 64u;
+    if (count < min_grouped_count)
+    {
+        for (std::size_t i = 0u; i < count; ++i)
+            interpolate(i);
+        return;
+    }
+
+    // the caller's order still groups its points by cell, give or take the points that moved
+    if (grid_order != nullptr && grid_order->size() == count)
+    {
+        common::parallel_for(count, [&](std::size_t k) { interpolate((*grid_order)[k]); });
+        return;
+    }
+
+    // sort the points by grid cell, points outside of the domain go last
+    Eigen::AlignedBox3d const& domain              = sdf_->domain();
+    std::array<unsigned int, 3u> const& resolution = sdf_->resolution();
+    Eigen::Vector3d const inverse_cell_size =
+        Eigen::Vector3d{
+            static_cast<scalar_type>(resolution[0]),
+            static_cast<scalar_type>(resolution[1]),
+            static_cast<scalar_type>(resolution[2])}
+            .cwiseQuotient(domain.sizes());
+    std::uint64_t const cell_count =
+        std::uint64_t{resolution[0]} * std::uint64_t{resolution[1]} * std::uint64_t{resolution[2]};
+
+    std::vector<std::pair<std::uint64_t, std::size_t>> order(count);
+    common::parallel_for(count, [&](std::size_t i) {
+        std::uint64_t cell = cell_count;
+        if (domain.contains(points[i]))
+        {
+            std::uint64_t ijk[3];
+            for (int c = 0; c < 3; ++c)
+            {
+                scalar_type const t    = (points[i](c) - domain.min()(c)) * inverse_cell_size(c);
+                std::uint64_t const ic = static_cast<std::uint64_t>(t);
+                ijk[c]                 = std::min<std::uint64_t>(ic, resolution[c] - 1u);
+            }
+            cell = ijk[0] + resolution[0] * (ijk[1] + resolution[1] * ijk[2]);
+        }
+        order[i] = {cell, i};
+    });
+    std::sort(order.begin(), order.end());
+
+    common::parallel_for(count, [&](std::size_t k) { interpolate(order[k].second); });
+
+    if (grid_order != nullptr)
+    {
+        grid_order->resize(count);
+        for (std::size_t k = 0u; k < count; ++k)
+            (*grid_order)[k] = order[k].second;
+    }
+}
+
 } // namespace collision
 } // namespace physics
 } // namespace sbs
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sbs/common/parallel.h>
+#include <sbs/physics/collision/sparse_sdf.h>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+namespace {
+
+std::uint32_t constexpr samples_per_side = sparse_sdf_t::brick_size + 1u;
+std::size_t constexpr samples_per_brick  = samples_per_side * samples_per_side * samples_per_side;
+
+std::array<std::uint32_t, 3u> unflatten(std::size_t i, std::array<std::uint32_t, 3u> const& n)
+{
+    return {
+        static_cast<std::uint32_t>(i % n[0]),
+        static_cast<std::uint32_t>((i / n[0]) % n[1]),
+        static_cast<std::uint32_t>(i / (std::size_t{n[0]} * n[1]))};
+}
+
+Eigen::Vector3d to_vector(std::array<std::uint32_t, 3u> const& n)
+{
+    return {
+        static_cast<scalar_type>(n[0]),
+        static_cast<scalar_type>(n[1]),
+        static_cast<scalar_type>(n[2])};
+}
+
+/**
+ * @brief Splits the coordinates u, measured in cells, into the index of the containing cell among
+ * n cells along each axis and the local coordinates t in [0, 1]^3 inside of that cell
+ */
+std::array<std::uint32_t, 3u>
+split(Eigen::Vector3d const& u, std::array<std::uint32_t, 3u> const& n, Eigen::Vector3d& t)
+{
+    std::array<std::uint32_t, 3u> cell{};
+    for (int c = 0; c < 3; ++c)
+    {
+        std::size_t const ci = static_cast<std::size_t>(c);
+        cell[ci]             = std::min(static_cast<std::uint32_t>(u(c)), n[ci] - 1u);
+        t(c)                 = u(c) - static_cast<scalar_type>(cell[ci]);
+    }
+    return cell;
+}
+
+/**
+ * @brief Trilinear interpolation of the corner values v[x + 2y + 4z] at t in [0, 1]^3, and its
+ * gradient with respect to t
+ */
+std::pair<scalar_type, Eigen::Vector3d>
+trilinear(std::array<scalar_type, 8u> const& v, Eigen::Vector3d const& t)
+{
+    scalar_type const dx00 = v[1] - v[0];
+    scalar_type const dx10 = v[3] - v[2];
+    scalar_type const dx01 = v[5] - v[4];
+    scalar_type const dx11 = v[7] - v[6];
+
+    scalar_type const v00 = v[0] + t.x() * dx00;
+    scalar_type const v10 = v[2] + t.x() * dx10;
+    scalar_type const v01 = v[4] + t.x() * dx01;
+    scalar_type const v11 = v[6] + t.x() * dx11;
+
+    scalar_type const v0 = v00 + t.y() * (v10 - v00);
+    scalar_type const v1 = v01 + t.y() * (v11 - v01);
+
+    scalar_type const dx0 = dx00 + t.y() * (dx10 - dx00);
+    scalar_type const dx1 = dx01 + t.y() * (dx11 - dx01);
+
+    Eigen::Vector3d const grad{
+        dx0 + t.z() * (dx1 - dx0),
+        (v10 - v00) + t.z() * ((v11 - v01) - (v10 - v00)),
+        v1 - v0};
+    return {v0 + t.z() * (v1 - v0), grad};
+}
+
+} // namespace
+
+sparse_sdf_t::sparse_sdf_t()
+    : domain_(),
+      cell_size_(0.),
+      brick_resolution_{0u, 0u, 0u},
+      coarse_samples_{},
+      bricks_{},
+      brick_samples_{}
+{
+}
+
+sparse_sdf_t::sparse_sdf_t(
+    Eigen::AlignedBox3d const& domain,
+    scalar_type cell_size,
+    scalar_type narrow_band,
+    scalar_type far_field,
+    distance_function_type const& distance)
+    : domain_(domain),
+      cell_size_(cell_size),
+      brick_resolution_{0u, 0u, 0u},
+      coarse_samples_{},
+      bricks_{},
+      brick_samples_{}
+{
+    scalar_type const brick_extent = cell_size_ * static_cast<scalar_type>(brick_size);
+    for (int c = 0; c < 3; ++c)
+    {
+        scalar_type const bricks = std::ceil(domain_.sizes()(c) / brick_extent);
+        brick_resolution_[static_cast<std::size_t>(c)] =
+            std::max(static_cast<std::uint32_t>(bricks), 1u);
+    }
+    domain_.max() = domain_.min() + brick_extent * to_vector(brick_resolution_);
+
+    // coarse samples at the bricks' corners
+    std::array<std::uint32_t, 3u> const corners{
+        brick_resolution_[0] + 1u,
+        brick_resolution_[1] + 1u,
+        brick_resolution_[2] + 1u};
+    coarse_samples_.resize(std::size_t{corners[0]} * corners[1] * corners[2]);
+    common::parallel_for(coarse_samples_.size(), [&](std::size_t i) {
+        Eigen::Vector3d const p = domain_.min() + brick_extent * to_vector(unflatten(i, corners));
+        scalar_type const d     = std::clamp(distance(p), -far_field, far_field);
+        coarse_samples_[i]      = static_cast<float>(d);
+    });
+
+    // Signed distance functions are 1-Lipschitz, such that no point of a brick is closer to the
+    // surface than the distance at the brick's center minus its half diagonal.
+    std::size_t const brick_total =
+        std::size_t{brick_resolution_[0]} * brick_resolution_[1] * brick_resolution_[2];
+    std::vector<scalar_type> center_distances(brick_total);
+    common::parallel_for(brick_total, [&](std::size_t i) {
+        Eigen::Vector3d const b      = to_vector(unflatten(i, brick_resolution_));
+        Eigen::Vector3d const center = domain_.min() + brick_extent * (b.array() + 0.5).matrix();
+        center_distances[i]          = distance(center);
+    });
+
+    scalar_type const half_diagonal = 0.5 * std::sqrt(3.) * brick_extent;
+    std::vector<std::size_t> stored_bricks{};
+    bricks_.assign(brick_total, -1);
+    for (std::size_t i = 0u; i < brick_total; ++i)
+    {
+        if (std::abs(center_distances[i]) - half_diagonal > narrow_band)
+            continue;
+
+        bricks_[i] = static_cast<std::int32_t>(stored_bricks.size());
+        stored_bricks.push_back(i);
+    }
+
+    brick_samples_.resize(stored_bricks.size() * samples_per_brick);
+    std::array<std::uint32_t, 3u> const brick_samples{
+        samples_per_side,
+        samples_per_side,
+        samples_per_side};
+    common::parallel_for(
+        stored_bricks.size(),
+        [&](std::size_t k) {
+            Eigen::Vector3d const b = to_vector(unflatten(stored_bricks[k], brick_resolution_));
+            Eigen::Vector3d const brick_min = domain_.min() + brick_extent * b;
+
+            float* samples = brick_samples_.data() + k * samples_per_brick;
+            for (std::size_t s = 0u; s < samples_per_brick; ++s)
+            {
+                Eigen::Vector3d const n = to_vector(unflatten(s, brick_samples));
+                samples[s]              = static_cast<float>(distance(brick_min + cell_size_ * n));
+            }
+        },
+        1u);
+}
+
+std::pair<scalar_type, Eigen::Vector3d> sparse_sdf_t::evaluate(Eigen::Vector3d const& p) const
+{
+    if (!domain_.contains(p))
+        return {std::numeric_limits<scalar_type>::max(), Eigen::Vector3d::Zero()};
+
+    scalar_type const brick_extent = cell_size_ * static_cast<scalar_type>(brick_size);
+
+    Eigen::Vector3d t{};
+    std::array<std::uint32_t, 3u> const b =
+        split((p - domain_.min()) / brick_extent, brick_resolution_, t);
+    std::int32_t const brick = bricks_[brick_index(b)];
+
+    std::array<scalar_type, 8u> v{};
+    if (brick < 0)
+    {
+        for (std::uint32_t k = 0u; k < 8u; ++k)
+        {
+            std::array<std::uint32_t, 3u> const n{
+                b[0] + (k & 1u),
+                b[1] + ((k >> 1u) & 1u),
+                b[2] + ((k >> 2u) & 1u)};
+            v[k] = static_cast<scalar_type>(coarse_samples_[coarse_index(n)]);
+        }
+        auto const [d, grad] = trilinear(v, t);
+        return {d, grad / brick_extent};
+    }
+
+    std::array<std::uint32_t, 3u> constexpr cells{brick_size, brick_size, brick_size};
+    Eigen::Vector3d s{};
+    std::array<std::uint32_t, 3u> const c =
+        split(t * static_cast<scalar_type>(brick_size), cells, s);
+
+    float const* samples =
+        brick_samples_.data() + static_cast<std::size_t>(brick) * samples_per_brick;
+    for (std::uint32_t k = 0u; k < 8u; ++k)
+    {
+        std::size_t const x = c[0] + (k & 1u);
+        std::size_t const y = c[1] + ((k >> 1u) & 1u);
+        std::size_t const z = c[2] + ((k >> 2u) & 1u);
+        v[k] = static_cast<scalar_type>(samples[x + samples_per_side * (y + samples_per_side * z)]);
+    }
+    auto const [d, grad] = trilinear(v, s);
+    return {d, grad / cell_size_};
+}
+
+Eigen::AlignedBox3d const& sparse_sdf_t::domain() const
+{
+    return domain_;
+}
+
+scalar_type sparse_sdf_t::cell_size() const
+{
+    return cell_size_;
+}
+
+std::size_t sparse_sdf_t::brick_count() const
+{
+    return brick_samples_.size() / samples_per_brick;
+}
+
+std::size_t sparse_sdf_t::memory_footprint() const
+{
+    return sizeof(*this) + coarse_samples_.capacity() * sizeof(float) +
+           bricks_.capacity() * sizeof(std::int32_t) + brick_samples_.capacity() * sizeof(float);
+}
+
+std::size_t sparse_sdf_t::brick_index(std::array<std::uint32_t, 3u> const& b) const
+{
+    std::size_t const nx = brick_resolution_[0];
+    std::size_t const ny = brick_resolution_[1];
+    return b[0] + nx * (b[1] + ny * b[2]);
+}
+
+std::size_t sparse_sdf_t::coarse_index(std::array<std::uint32_t, 3u> const& n) const
+{
+    std::size_t const nx = brick_resolution_[0] + 1u;
+    std::size_t const ny = brick_resolution_[1] + 1u;
+    return n[0] + nx * (n[1] + ny * n[2]);
+}
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
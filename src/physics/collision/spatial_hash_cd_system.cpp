@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <sbs/common/parallel.h>
+#include <sbs/physics/collision/collision_model.h>
+#include <sbs/physics/collision/spatial_hash_cd_system.h>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+namespace {
+
+std::uint32_t constexpr max_level = 63u;
+
+/**
+ * Level of the models that are not hashed, because their volume is not finite or lies too far from
+ * the origin, and which are instead tested against every other model
+ */
+std::uint32_t constexpr unhashed_level = max_level + 1u;
+
+/**
+ * Volumes must lie within this many base cells of the origin along every axis to be hashed, which
+ * keeps the integer cell coordinates of every level far from overflowing and bounds the level of
+ * any hashed model below max_level
+ */
+scalar_type constexpr max_cell_coordinate = 1099511627776.; // 2^40
+
+/**
+ * Packs the grid level and the (wrapped) integer cell coordinates in a single key. Cells that are
+ * more than 2^19 cells apart can share a key, which only yields false positives that are later
+ * rejected by the volume overlap test.
+ */
+std::uint64_t cell_key(std::uint32_t level, std::int64_t i, std::int64_t j, std::int64_t k)
+{
+    std::uint64_t constexpr mask = (std::uint64_t{1u} << 19u) - 1u;
+    return (static_cast<std::uint64_t>(level) << 57u) |
+           ((static_cast<std::uint64_t>(i) & mask) << 38u) |
+           ((static_cast<std::uint64_t>(j) & mask) << 19u) |
+           (static_cast<std::uint64_t>(k) & mask);
+}
+
+/**
+ * splitmix64 finalizer, spreads cell keys uniformly over the buckets
+ */
+std::uint64_t mix(std::uint64_t key)
+{
+    key ^= key >> 30u;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27u;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31u;
+    return key;
+}
+
+struct cell_range_t
+{
+    std::int64_t lo[3];
+    std::int64_t hi[3];
+
+    std::size_t count() const
+    {
+        return static_cast<std::size_t>(
+            (hi[0] - lo[0] + 1) * (hi[1] - lo[1] + 1) * (hi[2] - lo[2] + 1));
+    }
+};
+
+bool is_hashable(Eigen::AlignedBox3d const& volume, scalar_type cell_size)
+{
+    // comparisons with NaN are false, such that non-finite volumes are never hashable
+    scalar_type const bound = max_cell_coordinate * cell_size;
+    return (volume.min().array().abs() < bound).all() && (volume.max().array().abs() < bound).all();
+}
+
+cell_range_t cells_overlapping(Eigen::AlignedBox3d const& box, scalar_type h)
+{
+    cell_range_t range{};
+    for (int d = 0; d < 3; ++d)
+    {
+        range.lo[d] = static_cast<std::int64_t>(std::floor(box.min()(d) / h));
+        range.hi[d] = static_cast<std::int64_t>(std::floor(box.max()(d) / h));
+    }
+    return range;
+}
+
+template <class Func>
+void for_each_cell(cell_range_t const& range, Func&& f)
+{
+    for (std::int64_t i = range.lo[0]; i <= range.hi[0]; ++i)
+        for (std::int64_t j = range.lo[1]; j <= range.hi[1]; ++j)
+            for (std::int64_t k = range.lo[2]; k <= range.hi[2]; ++k)
+                f(i, j, k);
+}
+
+} // namespace
+
+spatial_hash_cd_system_t::spatial_hash_cd_system_t(
+    std::vector<collision_model_t*> const& collision_objects,
+    scalar_type cell_size)
+    : cd_system_t(collision_objects),
+      user_cell_size_(cell_size),
+      cell_size_(cell_size),
+      grid_margin_(0.),
+      is_grid_dirty_(true),
+      volumes_{},
+      levels_{},
+      occupied_levels_{},
+      unhashed_objects_{},
+      bucket_offsets_{},
+      entries_{}
+{
+}
+
+void spatial_hash_cd_system_t::execute()
+{
+    // a grid built with a larger margin only yields more candidates, which the narrow phase rejects
+    if (is_grid_dirty_ || broad_phase_margin() > grid_margin_)
+        rebuild_grid();
+
+    find_candidate_pairs();
+    narrow_phase(candidate_pairs());
+}
+
+void spatial_hash_cd_system_t::update(simulation_t const& simulation)
+{
+    rebuild_grid();
+}
+
+scalar_type spatial_hash_cd_system_t::cell_size() const
+{
+    return cell_size_;
+}
+
+void spatial_hash_cd_system_t::rebuild_grid()
+{
+    std::vector<collision_model_t*> const& objects = collision_objects();
+    std::size_t const object_count                 = objects.size();
+
+    grid_margin_ = broad_phase_margin();
+    volumes_.resize(object_count);
+    levels_.resize(object_count);
+    for (std::size_t i = 0u; i < object_count; ++i)
+    {
+        volumes_[i] = objects[i]->volume();
+        if (!volumes_[i].isEmpty())
+        {
+            volumes_[i].min().array() -= grid_margin_;
+            volumes_[i].max().array() += grid_margin_;
+        }
+    }
+
+    // The base cell size defaults to the median extent, such that the many small models of a
+    // scene land in the finest level, while large environment models go to coarser levels.
+    cell_size_ = user_cell_size_;
+    if (cell_size_ <= 0.)
+    {
+        std::vector<scalar_type> extents{};
+        extents.reserve(object_count);
+        for (auto const& volume : volumes_)
+        {
+            scalar_type const extent = volume.sizes().maxCoeff();
+            if (!volume.isEmpty() && std::isfinite(extent))
+                extents.push_back(extent);
+        }
+        if (!extents.empty())
+        {
+            auto const median = extents.begin() + extents.size() / 2u;
+            std::nth_element(extents.begin(), median, extents.end());
+            cell_size_ = *median;
+        }
+        if (!(cell_size_ > 0.))
+            cell_size_ = 1.;
+    }
+
+    std::vector<std::uint32_t> entry_offsets(object_count + 1u, 0u);
+    occupied_levels_.clear();
+    unhashed_objects_.clear();
+    for (std::size_t i = 0u; i < object_count; ++i)
+    {
+        Eigen::AlignedBox3d const& volume = volumes_[i];
+        if (volume.isEmpty())
+        {
+            levels_[i] = 0u;
+            continue;
+        }
+        if (!is_hashable(volume, cell_size_))
+        {
+            levels_[i] = unhashed_level;
+            unhashed_objects_.push_back(static_cast<index_type>(i));
+            continue;
+        }
+
+        scalar_type const extent = volume.sizes().maxCoeff();
+        std::uint32_t level      = 0u;
+        scalar_type h            = cell_size_;
+        while (h < extent && level < max_level)
+        {
+            h *= 2.;
+            ++level;
+        }
+        levels_[i] = level;
+        occupied_levels_.push_back(level);
+
+        // the volume is at most as large as a cell of its level, so it overlaps at most 8 cells
+        std::size_t const cell_count = cells_overlapping(volume, h).count();
+        assert(cell_count <= 8u);
+        entry_offsets[i + 1u] = static_cast<std::uint32_t>(cell_count);
+    }
+    std::sort(occupied_levels_.begin(), occupied_levels_.end());
+    occupied_levels_.erase(
+        std::unique(occupied_levels_.begin(), occupied_levels_.end()),
+        occupied_levels_.end());
+    for (std::size_t i = 0u; i < object_count; ++i)
+    {
+        entry_offsets[i + 1u] += entry_offsets[i];
+    }
+
+    std::size_t const entry_count = entry_offsets.back();
+    std::vector<cell_entry_t> unsorted_entries(entry_count);
+    common::parallel_for(object_count, [&](std::size_t i) {
+        if (volumes_[i].isEmpty() || levels_[i] == unhashed_level)
+            return;
+
+        std::uint32_t const level = levels_[i];
+        scalar_type const h       = std::ldexp(cell_size_, static_cast<int>(level));
+        std::size_t e             = entry_offsets[i];
+        for_each_cell(
+            cells_overlapping(volumes_[i], h),
+            [&](std::int64_t ci, std::int64_t cj, std::int64_t ck) {
+                unsorted_entries[e++] = {cell_key(level, ci, cj, ck), static_cast<index_type>(i)};
+            });
+    });
+
+    // Counting sort of the cell entries into the hash table's buckets
+    std::size_t bucket_count = 1u;
+    while (bucket_count < 2u * entry_count)
+        bucket_count <<= 1u;
+
+    std::vector<std::atomic<std::uint32_t>> bucket_cursors(bucket_count);
+    common::parallel_for(entry_count, [&](std::size_t e) {
+        std::size_t const b = mix(unsorted_entries[e].key) & (bucket_count - 1u);
+        bucket_cursors[b].fetch_add(1u, std::memory_order_relaxed);
+    });
+
+    bucket_offsets_.assign(bucket_count + 1u, 0u);
+    for (std::size_t b = 0u; b < bucket_count; ++b)
+    {
+        std::uint32_t const count = bucket_cursors[b].load(std::memory_order_relaxed);
+        bucket_offsets_[b + 1u]   = bucket_offsets_[b] + count;
+        bucket_cursors[b].store(bucket_offsets_[b], std::memory_order_relaxed);
+    }
+
+    entries_.resize(entry_count);
+    common::parallel_for(entry_count, [&](std::size_t e) {
+        std::size_t const b = mix(unsorted_entries[e].key) & (bucket_count - 1u);
+        std::uint32_t const slot = bucket_cursors[b].fetch_add(1u, std::memory_order_relaxed);
+        entries_[slot]           = unsorted_entries[e];
+    });
+
+    is_grid_dirty_ = false;
+}
+
+void spatial_hash_cd_system_t::find_candidate_pairs()
+{
+    using index_pair_type = std::pair<index_type, index_type>;
+
+    std::vector<collision_model_t*> const& objects = collision_objects();
+    std::size_t const object_count                 = objects.size();
+    std::size_t const bucket_count                 = bucket_offsets_.size() - 1u;
+
+    std::vector<std::vector<index_pair_type>> chunk_pairs(common::thread_count());
+    std::size_t const chunk_count = common::parallel_for_chunks(
+        object_count,
+        chunk_pairs.size(),
+        [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            std::vector<index_pair_type>& pairs = chunk_pairs[chunk];
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                Eigen::AlignedBox3d const& volume = volumes_[i];
+                if (volume.isEmpty() || levels_[i] == unhashed_level)
+                    continue;
+
+                std::uint32_t const level = levels_[i];
+                auto const first_level =
+                    std::lower_bound(occupied_levels_.begin(), occupied_levels_.end(), level);
+                for (auto it = first_level; it != occupied_levels_.end(); ++it)
+                {
+                    std::uint32_t const query_level = *it;
+                    scalar_type const h = std::ldexp(cell_size_, static_cast<int>(query_level));
+                    for_each_cell(
+                        cells_overlapping(volume, h),
+                        [&](std::int64_t ci, std::int64_t cj, std::int64_t ck) {
+                            std::uint64_t const key = cell_key(query_level, ci, cj, ck);
+                            std::size_t const b     = mix(key) & (bucket_count - 1u);
+                            for (std::uint32_t e = bucket_offsets_[b]; e < bucket_offsets_[b + 1u];
+                                 ++e)
+                            {
+                                cell_entry_t const& entry = entries_[e];
+                                if (entry.key != key)
+                                    continue;
+
+                                std::size_t const j = entry.object;
+                                // pairs of the same level are found from both sides
+                                if (j == i || (levels_[j] == level && j < i))
+                                    continue;
+
+                                if (!volume.intersects(volumes_[j]))
+                                    continue;
+
+                                pairs.push_back(
+                                    {static_cast<index_type>(std::min(i, j)),
+                                     static_cast<index_type>(std::max(i, j))});
+                            }
+                        });
+                }
+            }
+        });
+
+    std::vector<index_pair_type> pairs{};
+    for (std::size_t c = 0u; c < chunk_count; ++c)
+    {
+        pairs.insert(pairs.end(), chunk_pairs[c].begin(), chunk_pairs[c].end());
+    }
+    for (index_type const i : unhashed_objects_)
+    {
+        for (std::size_t j = 0u; j < object_count; ++j)
+        {
+            if (j == i || volumes_[j].isEmpty() || !volumes_[i].intersects(volumes_[j]))
+                continue;
+
+            pairs.push_back(
+                {static_cast<index_type>(std::min<std::size_t>(i, j)),
+                 static_cast<index_type>(std::max<std::size_t>(i, j))});
+        }
+    }
+    // A pair of models sharing several cells is reported once per shared cell
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    std::vector<intersection_pair>& candidates = candidate_pairs();
+    candidates.clear();
+    candidates.reserve(pairs.size());
+    for (auto const& [i, j] : pairs)
+    {
+        candidates.push_back({objects[i], objects[j]});
+    }
+}
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
@@ -0,0 +1,348 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <sbs/common/parallel.h>
+#include <sbs/physics/collision/contact.h>
+#include <sbs/physics/collision/intersections.h>
+#include <sbs/physics/collision/spatial_hash_self_collision.h>
+#include <sbs/physics/tetrahedral_mesh_boundary.h>
+#include <sbs/physics/topology.h>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+namespace {
+
+/**
+ * Spatial hash function of Teschner et al. 2003
+ */
+std::size_t spatial_hash(std::int64_t const (&cell)[3], std::size_t bucket_count)
+{
+    std::uint64_t const h = (static_cast<std::uint64_t>(cell[0]) * 73856093u) ^
+                            (static_cast<std::uint64_t>(cell[1]) * 19349663u) ^
+                            (static_cast<std::uint64_t>(cell[2]) * 83492791u);
+    return static_cast<std::size_t>(h % bucket_count);
+}
+
+void cell_of(Eigen::Vector3d const& p, scalar_type h, std::int64_t (&cell)[3])
+{
+    for (int d = 0; d < 3; ++d)
+        cell[d] = static_cast<std::int64_t>(std::floor(p(d) / h));
+}
+
+triangle_t triangle_of(tetrahedral_mesh_boundary_t const& boundary, std::size_t fi)
+{
+    auto const f = boundary.triangle(fi);
+    return triangle_t{
+        boundary.vertex(f.vertices[0u]).position,
+        boundary.vertex(f.vertices[1u]).position,
+        boundary.vertex(f.vertices[2u]).position};
+}
+
+} // namespace
+
+spatial_hash_self_collision_t::spatial_hash_self_collision_t()
+    : boundary_(nullptr),
+      thickness_(0.),
+      cell_size_(0.),
+      grid_cell_size_(0.),
+      adjacency_offsets_{},
+      adjacency_{},
+      bucket_offsets_{},
+      entries_{},
+      chunk_extents_{},
+      chunk_contacts_{}
+{
+}
+
+spatial_hash_self_collision_t::spatial_hash_self_collision_t(
+    tetrahedral_mesh_boundary_t const* boundary)
+    : boundary_(boundary),
+      thickness_(0.),
+      cell_size_(0.),
+      grid_cell_size_(0.),
+      adjacency_offsets_{},
+      adjacency_{},
+      bucket_offsets_{},
+      entries_{},
+      chunk_extents_{},
+      chunk_contacts_{}
+{
+    std::size_t const triangle_count = boundary_->triangle_count();
+    for (std::size_t fi = 0u; fi < triangle_count; ++fi)
+    {
+        auto const f = boundary_->triangle(fi);
+        for (std::size_t e = 0u; e < 3u; ++e)
+        {
+            Eigen::Vector3d const& p1 = boundary_->vertex(f.vertices[e]).position;
+            Eigen::Vector3d const& p2 = boundary_->vertex(f.vertices[(e + 1u) % 3u]).position;
+            cell_size_ += (p2 - p1).norm();
+        }
+    }
+    if (triangle_count > 0u)
+        cell_size_ /= static_cast<scalar_type>(3u * triangle_count);
+
+    thickness_ = 0.5 * cell_size_;
+
+    rebuild_adjacency();
+}
+
+void spatial_hash_self_collision_t::collide(index_type id, contact_handler_t& handler)
+{
+    if (boundary_ == nullptr || !(cell_size_ > 0.))
+        return;
+
+    rebuild_grid();
+
+    std::size_t const vertex_count = boundary_->vertex_count();
+    std::size_t const bucket_count = bucket_offsets_.size() - 1u;
+    scalar_type const thickness2   = thickness_ * thickness_;
+
+    chunk_contacts_.resize(common::thread_count());
+    std::size_t const chunk_count = common::parallel_for_chunks(
+        vertex_count,
+        chunk_contacts_.size(),
+        [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            std::vector<self_contact_t>& contacts = chunk_contacts_[chunk];
+            contacts.clear();
+            for (std::size_t vi = begin; vi < end; ++vi)
+            {
+                Eigen::Vector3d const& p = boundary_->vertex(vi).position;
+
+                std::int64_t cell[3];
+                cell_of(p, grid_cell_size_, cell);
+                std::size_t const b = spatial_hash(cell, bucket_count);
+
+                /**
+                 * Among the triangles at the closest distance, which share an edge or a vertex,
+                 * the one whose plane is the farthest from the vertex classifies it correctly.
+                 */
+                self_contact_t best{};
+                scalar_type best_squared_distance    = thickness2;
+                scalar_type best_abs_signed_distance = -1.;
+                bool has_best                        = false;
+                for (std::uint32_t e = bucket_offsets_[b]; e < bucket_offsets_[b + 1u]; ++e)
+                {
+                    cell_entry_t const& entry = entries_[e];
+                    if (!std::equal(std::begin(cell), std::end(cell), std::begin(entry.cell)))
+                        continue;
+
+                    index_type const fi = entry.fi;
+                    if (are_adjacent(static_cast<index_type>(vi), fi))
+                        continue;
+
+                    triangle_t const triangle = triangle_of(*boundary_, fi);
+                    auto const [q, barycentric_coordinates] = closest_point(p, triangle);
+                    scalar_type const squared_distance     = (p - q).squaredNorm();
+                    scalar_type const tie_squared_distance =
+                        best_squared_distance * (1. + 1e-6) + 1e-12 * thickness2;
+                    if (squared_distance > tie_squared_distance)
+                        continue;
+
+                    Eigen::Vector3d const n = triangle.normal();
+                    if (!n.allFinite())
+                        continue;
+
+                    scalar_type const abs_signed_distance = std::abs((p - q).dot(n));
+                    bool const is_closer = squared_distance < best_squared_distance * (1. - 1e-6);
+                    if (!is_closer && has_best && abs_signed_distance <= best_abs_signed_distance)
+                        continue;
+
+                    best = {static_cast<index_type>(vi), fi, q, n, barycentric_coordinates};
+                    best_squared_distance    = std::min(best_squared_distance, squared_distance);
+                    best_abs_signed_distance = abs_signed_distance;
+                    has_best                 = true;
+                }
+
+                // boundary triangles are oriented such that their normals point outwards
+                if (has_best && (p - best.point).dot(best.normal) < 0.)
+                    contacts.push_back(best);
+            }
+        });
+
+    // chunks cover increasing vertex ranges, so contacts are always handled in the same order
+    for (std::size_t c = 0u; c < chunk_count; ++c)
+    {
+        for (self_contact_t const& self_contact : chunk_contacts_[c])
+        {
+            surface_mesh_particle_to_triangle_contact_t const contact(
+                contact_t::type_t::surface_particle_to_surface_triangle,
+                id,
+                id,
+                self_contact.point,
+                self_contact.normal,
+                self_contact.vi,
+                self_contact.fi,
+                self_contact.barycentric_coordinates);
+
+            handler.handle(contact);
+        }
+    }
+}
+
+void spatial_hash_self_collision_t::rebuild_adjacency()
+{
+    adjacency_offsets_.clear();
+    adjacency_.clear();
+    if (boundary_ == nullptr)
+        return;
+
+    tetrahedron_set_t const* mesh            = boundary_->tetrahedral_mesh();
+    csr_incidence_t const& vertex_tetrahedra = mesh->incidences().vertex_tetrahedra;
+    std::size_t const vertex_count           = boundary_->vertex_count();
+
+    adjacency_offsets_.reserve(vertex_count + 1u);
+    adjacency_offsets_.push_back(0u);
+    for (std::size_t vi = 0u; vi < vertex_count; ++vi)
+    {
+        index_type const tet_vi = boundary_->from_surface_vertex(vi);
+        auto const begin        = adjacency_.size();
+        for (index_type const ti : vertex_tetrahedra[tet_vi])
+        {
+            auto const& vertices = mesh->tetrahedron(ti).vertex_indices();
+            adjacency_.insert(adjacency_.end(), vertices.begin(), vertices.end());
+        }
+        // isolated boundary vertices are still adjacent to the triangles they belong to
+        adjacency_.push_back(tet_vi);
+
+        std::sort(adjacency_.begin() + begin, adjacency_.end());
+        adjacency_.erase(
+            std::unique(adjacency_.begin() + begin, adjacency_.end()),
+            adjacency_.end());
+        adjacency_offsets_.push_back(static_cast<index_type>(adjacency_.size()));
+    }
+}
+
+scalar_type spatial_hash_self_collision_t::thickness() const
+{
+    return thickness_;
+}
+
+scalar_type& spatial_hash_self_collision_t::thickness()
+{
+    return thickness_;
+}
+
+scalar_type spatial_hash_self_collision_t::cell_size() const
+{
+    return cell_size_;
+}
+
+scalar_type& spatial_hash_self_collision_t::cell_size()
+{
+    return cell_size_;
+}
+
+void spatial_hash_self_collision_t::rebuild_grid()
+{
+    std::size_t const triangle_count = boundary_->triangle_count();
+    Eigen::Vector3d const margin     = Eigen::Vector3d::Constant(thickness_);
+
+    auto const bounds_of = [&](std::size_t fi) {
+        triangle_t const triangle = triangle_of(*boundary_, fi);
+        return std::make_pair(
+            Eigen::Vector3d{triangle.a.cwiseMin(triangle.b).cwiseMin(triangle.c) - margin},
+            Eigen::Vector3d{triangle.a.cwiseMax(triangle.b).cwiseMax(triangle.c) + margin});
+    };
+
+    /**
+     * Stretched or inverted triangles can span many more cells than at rest. When the largest
+     * triangle would span more than max_cells_per_axis cells along an axis, the grid is coarsened
+     * for this step, which bounds the number of cells of every triangle.
+     */
+    scalar_type constexpr max_cells_per_axis = 4.;
+    chunk_extents_.assign(common::thread_count(), 0.);
+    std::size_t const chunk_count = common::parallel_for_chunks(
+        triangle_count,
+        chunk_extents_.size(),
+        [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            for (std::size_t fi = begin; fi < end; ++fi)
+            {
+                auto const [min, max] = bounds_of(fi);
+                chunk_extents_[chunk] = std::max(chunk_extents_[chunk], (max - min).maxCoeff());
+            }
+        });
+    scalar_type const max_extent =
+        *std::max_element(chunk_extents_.begin(), chunk_extents_.begin() + chunk_count);
+    assert(std::isfinite(max_extent));
+    grid_cell_size_ = std::max(cell_size_, max_extent / max_cells_per_axis);
+    scalar_type const h = grid_cell_size_;
+
+    auto const cell_range = [&](std::size_t fi, std::int64_t(&lo)[3], std::int64_t(&hi)[3]) {
+        auto const [min, max] = bounds_of(fi);
+        cell_of(min, h, lo);
+        cell_of(max, h, hi);
+    };
+
+    std::vector<std::size_t> entry_offsets(triangle_count + 1u, 0u);
+    common::parallel_for(triangle_count, [&](std::size_t fi) {
+        std::int64_t lo[3], hi[3];
+        cell_range(fi, lo, hi);
+        entry_offsets[fi + 1u] = static_cast<std::size_t>(
+            (hi[0] - lo[0] + 1) * (hi[1] - lo[1] + 1) * (hi[2] - lo[2] + 1));
+    });
+    for (std::size_t fi = 0u; fi < triangle_count; ++fi)
+    {
+        entry_offsets[fi + 1u] += entry_offsets[fi];
+    }
+
+    std::size_t const entry_count = entry_offsets.back();
+    // bucket offsets are 32 bits wide
+    assert(entry_count <= std::numeric_limits<std::uint32_t>::max());
+    std::vector<cell_entry_t> unsorted_entries(entry_count);
+    common::parallel_for(triangle_count, [&](std::size_t fi) {
+        std::int64_t lo[3], hi[3];
+        cell_range(fi, lo, hi);
+        std::size_t e = entry_offsets[fi];
+        for (std::int64_t i = lo[0]; i <= hi[0]; ++i)
+            for (std::int64_t j = lo[1]; j <= hi[1]; ++j)
+                for (std::int64_t k = lo[2]; k <= hi[2]; ++k)
+                    unsorted_entries[e++] = {{i, j, k}, static_cast<index_type>(fi)};
+    });
+
+    // Counting sort of the cell entries into the hash table's buckets
+    std::size_t const bucket_count = 2u * std::max<std::size_t>(entry_count, 1u) + 1u;
+    std::vector<std::atomic<std::uint32_t>> bucket_cursors(bucket_count);
+    common::parallel_for(entry_count, [&](std::size_t e) {
+        std::size_t const b = spatial_hash(unsorted_entries[e].cell, bucket_count);
+        bucket_cursors[b].fetch_add(1u, std::memory_order_relaxed);
+    });
+
+    bucket_offsets_.assign(bucket_count + 1u, 0u);
+    for (std::size_t b = 0u; b < bucket_count; ++b)
+    {
+        std::uint32_t const count = bucket_cursors[b].load(std::memory_order_relaxed);
+        bucket_offsets_[b + 1u]   = bucket_offsets_[b] + count;
+        bucket_cursors[b].store(bucket_offsets_[b], std::memory_order_relaxed);
+    }
+
+    entries_.resize(entry_count);
+    common::parallel_for(entry_count, [&](std::size_t e) {
+        std::size_t const b      = spatial_hash(unsorted_entries[e].cell, bucket_count);
+        std::uint32_t const slot = bucket_cursors[b].fetch_add(1u, std::memory_order_relaxed);
+        entries_[slot]           = unsorted_entries[e];
+    });
+}
+
+bool spatial_hash_self_collision_t::are_adjacent(index_type vi, index_type fi) const
+{
+    auto const begin = adjacency_.begin() + adjacency_offsets_[vi];
+    auto const end   = adjacency_.begin() + adjacency_offsets_[vi + 1u];
+
+    auto const f = boundary_->triangle(fi);
+    for (auto const fvi : f.vertices)
+    {
+        index_type const tet_vi = boundary_->from_surface_vertex(fvi);
+        if (std::binary_search(begin, end, tet_vi))
+            return true;
+    }
+    return false;
+}
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <sbs/physics/collision/wide_bvh.h>
+
+namespace sbs {
+namespace physics {
+namespace collision {
+
+namespace {
+
+template <class Derived>
+unsigned int lane_mask(Eigen::ArrayBase<Derived> const& lanes)
+{
+    unsigned int mask = 0u;
+    for (Eigen::Index k = 0; k < lanes.size(); ++k)
+    {
+        if (lanes(k))
+            mask |= 1u << static_cast<unsigned int>(k);
+    }
+    return mask;
+}
+
+Eigen::AlignedBox3d bounds_of(wide_bvh_t::node_t const& node)
+{
+    // unused lanes hold empty bounds, which do not affect the reduction
+    return Eigen::AlignedBox3d(
+        Eigen::Vector3d{node.min_x.minCoeff(), node.min_y.minCoeff(), node.min_z.minCoeff()},
+        Eigen::Vector3d{node.max_x.maxCoeff(), node.max_y.maxCoeff(), node.max_z.maxCoeff()});
+}
+
+} // namespace
+
+unsigned int wide_bvh_t::overlap_mask(node_t const& node, Eigen::AlignedBox3d const& box)
+{
+    Eigen::Array4d const gap = (node.min_x - box.max().x())
+                                   .max(box.min().x() - node.max_x)
+                                   .max(node.min_y - box.max().y())
+                                   .max(box.min().y() - node.max_y)
+                                   .max(node.min_z - box.max().z())
+                                   .max(box.min().z() - node.max_z);
+    return lane_mask(gap <= 0.);
+}
+
+unsigned int wide_bvh_t::ray_mask(
+    node_t const& node,
+    Eigen::Vector3d const& origin,
+    Eigen::Vector3d const& inverse_direction,
+    scalar_type t_min,
+    scalar_type t_max)
+{
+    // slab test of the ray against the 4 children's bounds at once
+    Eigen::Array4d const tx1 = (node.min_x - origin.x()) * inverse_direction.x();
+    Eigen::Array4d const tx2 = (node.max_x - origin.x()) * inverse_direction.x();
+    Eigen::Array4d const ty1 = (node.min_y - origin.y()) * inverse_direction.y();
+    Eigen::Array4d const ty2 = (node.max_y - origin.y()) * inverse_direction.y();
+    Eigen::Array4d const tz1 = (node.min_z - origin.z()) * inverse_direction.z();
+    Eigen::Array4d const tz2 = (node.max_z - origin.z()) * inverse_direction.z();
+
+    Eigen::Array4d const t_near =
+        tx1.min(tx2).max(ty1.min(ty2)).max(tz1.min(tz2)).max(Eigen::Array4d::Constant(t_min));
+    Eigen::Array4d const t_far =
+        tx1.max(tx2).min(ty1.max(ty2)).min(tz1.max(tz2)).min(Eigen::Array4d::Constant(t_max));
+    return lane_mask(t_near <= t_far);
+}
+
+bool wide_bvh_t::empty() const
+{
+    return nodes_.empty();
+}
+
+std::size_t wide_bvh_t::node_count() const
+{
+    return nodes_.size();
+}
+
+std::size_t wide_bvh_t::leaf_count() const
+{
+    return leaves_.size();
+}
+
+unsigned int wide_bvh_t::entity(std::size_t i) const
+{
+    return entities_[i];
+}
+
+Eigen::AlignedBox3d wide_bvh_t::bounds() const
+{
+    if (nodes_.empty())
+        return Eigen::AlignedBox3d{};
+
+    return bounds_of(nodes_.front());
+}
+
+std::vector<wide_bvh_t::node_t> const& wide_bvh_t::nodes() const
+{
+    return nodes_;
+}
+
+std::vector<wide_bvh_t::leaf_t> const& wide_bvh_t::leaves() const
+{
+    return leaves_;
+}
+
+std::size_t wide_bvh_t::memory_footprint() const
+{
+    return sizeof(*this) + nodes_.capacity() * sizeof(node_t) +
+           leaves_.capacity() * sizeof(leaf_t) + entities_.capacity() * sizeof(unsigned int) +
+           leaf_boxes_.capacity() * sizeof(Eigen::AlignedBox3d);
+}
+
+void wide_bvh_t::collapse(std::vector<binary_node_t> const& binary_nodes)
+{
+    nodes_.clear();
+    leaves_.clear();
+    if (binary_nodes.empty())
+        return;
+
+    auto const is_leaf = [&](std::int32_t b) {
+        return binary_nodes[static_cast<std::size_t>(b)].children[0] < 0;
+    };
+
+    struct pending_node_t
+    {
+        std::int32_t binary_node;
+        std::size_t wide_node;
+        std::size_t depth;
+    };
+
+    // breadth first, such that parents are always stored before their children
+    std::vector<pending_node_t> pending{};
+    pending.push_back({0, 0u, 1u});
+    nodes_.push_back({});
+    std::size_t max_depth = 0u;
+    for (std::size_t p = 0u; p < pending.size(); ++p)
+    {
+        pending_node_t const current = pending[p];
+        max_depth                    = std::max(max_depth, current.depth);
+
+        std::array<std::int32_t, width> slots{};
+        std::size_t slot_count = 0u;
+        if (is_leaf(current.binary_node))
+        {
+            slots[slot_count++] = current.binary_node;
+        }
+        else
+        {
+            binary_node_t const& b = binary_nodes[static_cast<std::size_t>(current.binary_node)];
+            slots[slot_count++]    = b.children[0];
+            slots[slot_count++]    = b.children[1];
+        }
+
+        // open the largest internal child until the node is full
+        while (slot_count < width)
+        {
+            std::size_t largest = width;
+            for (std::size_t k = 0u; k < slot_count; ++k)
+            {
+                if (is_leaf(slots[k]))
+                    continue;
+
+                std::uint32_t const count = binary_nodes[static_cast<std::size_t>(slots[k])].count;
+                if (largest == width ||
+                    count > binary_nodes[static_cast<std::size_t>(slots[largest])].count)
+                    largest = k;
+            }
+            if (largest == width)
+                break;
+
+            binary_node_t const& b = binary_nodes[static_cast<std::size_t>(slots[largest])];
+            slots[largest]         = b.children[0];
+            slots[slot_count++]    = b.children[1];
+        }
+
+        node_t node{};
+        double constexpr infinity = std::numeric_limits<double>::infinity();
+        node.min_x.setConstant(infinity);
+        node.min_y.setConstant(infinity);
+        node.min_z.setConstant(infinity);
+        node.max_x.setConstant(-infinity);
+        node.max_y.setConstant(-infinity);
+        node.max_z.setConstant(-infinity);
+        node.children.fill(empty_child);
+        node.child_count = static_cast<std::uint32_t>(slot_count);
+
+        for (std::size_t k = 0u; k < slot_count; ++k)
+        {
+            binary_node_t const& b = binary_nodes[static_cast<std::size_t>(slots[k])];
+            if (is_leaf(slots[k]))
+            {
+                node.children[k] = ~static_cast<std::int32_t>(leaves_.size());
+                leaves_.push_back({b.begin, b.count});
+                continue;
+            }
+
+            node.children[k] = static_cast<std::int32_t>(nodes_.size());
+            pending.push_back({slots[k], nodes_.size(), current.depth + 1u});
+            nodes_.push_back({});
+        }
+
+        nodes_[current.wide_node] = node;
+    }
+
+    // every visited node pushes at most width - 1 more entries than it pops
+    stack_capacity_ = (width - 1u) * max_depth + 1u;
+}
+
+void wide_bvh_t::refit_internal_nodes()
+{
+    for (std::size_t i = nodes_.size(); i-- > 0u;)
+    {
+        node_t& node = nodes_[i];
+        for (std::uint32_t k = 0u; k < node.child_count; ++k)
+        {
+            std::int32_t const child = node.children[k];
+
+            Eigen::AlignedBox3d const box = child < 0 ?
+                                                leaf_boxes_[static_cast<std::size_t>(~child)] :
+                                                bounds_of(nodes_[static_cast<std::size_t>(child)]);
+
+            node.min_x[k] = box.min().x();
+            node.min_y[k] = box.min().y();
+            node.min_z[k] = box.min().z();
+            node.max_x[k] = box.max().x();
+            node.max_y[k] = box.max().y();
+            node.max_z[k] = box.max().z();
+        }
+    }
+}
+
+} // namespace collision
+} // namespace physics
+} // namespace sbs
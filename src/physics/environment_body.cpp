@@ -1,34 +1,25 @@
 #include "..\..\include\sbs\physics\environment_body.h"
 
-#include <Discregrid/geometry/mesh_distance.hpp>
-#include <Discregrid/mesh/triangle_mesh.hpp>
 #include <cassert>
 #include <sbs/common/geometry.h>
+#include <sbs/physics/collision/mesh_distance.h>
+#include <sbs/physics/collision/sdf_cache.h>
 #include <sbs/physics/environment_body.h>
 
 namespace sbs {
 namespace physics {
 
-environment_body_t::environment_body_t(
-    simulation_t& simulation,
-    index_type id,
+namespace {
+
+void get_triangle_mesh(
     common::geometry_t const& geometry,
-    Eigen::AlignedBox3d const& domain,
-    std::array<unsigned int, 3u> const& resolution)
-    : body_t(simulation, id),
-      visual_model_(geometry),
-      collision_model_(
-          Eigen::AlignedBox3d{},
-          {2, 2, 2}) /*dummy values, because Discregrid::CubicLagrangeGrid does not have a default
-                        constructor*/
+    std::vector<Eigen::Vector3d>& vertices,
+    std::vector<std::array<unsigned int, 3>>& faces)
 {
     assert(geometry.geometry_type == common::geometry_t::geometry_type_t::triangle);
     assert(geometry.has_positions());
     assert(geometry.has_indices());
 
-    std::vector<Eigen::Vector3d> vertices{};
-    std::vector<std::array<unsigned int, 3>> faces{};
-
     vertices.reserve(geometry.positions.size() / 3u);
     faces.reserve(geometry.indices.size() / 3u);
 
@@ -48,35 +39,106 @@ environment_body_t::environment_body_t(
 
         faces.push_back({v1, v2, v3});
     }
+}
 
-    Discregrid::TriangleMesh mesh(vertices, faces);
-    Eigen::AlignedBox3d extended_domain = domain;
-    for (auto const& x : mesh.vertices())
+} // namespace
+
+environment_body_t::environment_body_t(
+    simulation_t& simulation,
+    index_type id,
+    common::geometry_t const& geometry,
+    Eigen::AlignedBox3d const& domain,
+    std::array<unsigned int, 3u> const& resolution,
+    collision::sdf_cache_t const* sdf_cache)
+    : body_t(simulation, id),
+      visual_model_(geometry),
+      collision_model_(
+          Eigen::AlignedBox3d{},
+          {2, 2, 2}) /*dummy values, because Discregrid::CubicLagrangeGrid does not have a default
+                        constructor*/
+{
+    std::vector<Eigen::Vector3d> vertices{};
+    std::vector<std::array<unsigned int, 3>> faces{};
+    get_triangle_mesh(geometry, vertices, faces);
+
+    std::uint64_t key = 0u;
+    if (sdf_cache != nullptr)
     {
-        for (auto const& x : mesh.vertices())
+        key = collision::sdf_cache_t::key(vertices, faces, domain, resolution);
+        std::shared_ptr<Discregrid::CubicLagrangeDiscreteGrid const> const cached_grid =
+            sdf_cache->load(key, resolution);
+        if (cached_grid)
         {
-            extended_domain.extend(x);
+            // the cached grid's domain is the extended domain it was computed on
+            collision_model_          = collision::sdf_model_t(cached_grid);
+            collision_model_.volume() = cached_grid->domain();
+            collision_model_.id()     = this->id();
+            return;
         }
-        extended_domain.max() +=
-            1.0e-3 * extended_domain.diagonal().norm() * Eigen::Vector3d::Ones();
-        extended_domain.min() -=
-            1.0e-3 * extended_domain.diagonal().norm() * Eigen::Vector3d::Ones();
     }
 
-    Discregrid::MeshDistance md(mesh);
+    Eigen::AlignedBox3d extended_domain = domain;
+    for (Eigen::Vector3d const& x : vertices)
+        extended_domain.extend(x);
 
-    auto const sdf = [&md](Eigen::Vector3d const& xi) {
-        return md.signedDistanceCached(xi);
-    };
+    Eigen::Vector3d const padding =
+        1.0e-3 * extended_domain.diagonal().norm() * Eigen::Vector3d::Ones();
+    extended_domain.max() += padding;
+    extended_domain.min() -= padding;
 
-    Discregrid::CubicLagrangeDiscreteGrid grid(extended_domain, resolution);
-    grid.addFunction(sdf);
+    collision::mesh_distance_t const mesh_distance(vertices, faces);
+    auto const grid =
+        std::make_shared<Discregrid::CubicLagrangeDiscreteGrid>(extended_domain, resolution);
+    mesh_distance.add_to(*grid);
+
+    if (sdf_cache != nullptr)
+        sdf_cache->store(key, grid);
 
     collision_model_          = collision::sdf_model_t(grid);
     collision_model_.volume() = extended_domain;
     collision_model_.id()     = this->id();
 }
 
+environment_body_t::environment_body_t(
+    simulation_t& simulation,
+    index_type id,
+    common::geometry_t const& geometry,
+    Eigen::AlignedBox3d const& domain,
+    scalar_type cell_size,
+    scalar_type narrow_band,
+    scalar_type far_field)
+    : body_t(simulation, id),
+      visual_model_(geometry),
+      collision_model_(collision::sparse_sdf_t{})
+{
+    std::vector<Eigen::Vector3d> vertices{};
+    std::vector<std::array<unsigned int, 3>> faces{};
+    get_triangle_mesh(geometry, vertices, faces);
+
+    collision::mesh_distance_t const mesh_distance(vertices, faces);
+    auto const distance = [&mesh_distance](Eigen::Vector3d const& p) {
+        return mesh_distance.signed_distance(p);
+    };
+
+    collision_model_ = collision::sdf_model_t(
+        collision::sparse_sdf_t(domain, cell_size, narrow_band, far_field, distance));
+    collision_model_.id() = this->id();
+}
+
+environment_body_t::environment_body_t(
+    simulation_t& simulation,
+    index_type id,
+    common::geometry_t const& geometry)
+    : body_t(simulation, id), visual_model_(geometry), collision_model_(collision::sparse_sdf_t{})
+{
+    std::vector<Eigen::Vector3d> vertices{};
+    std::vector<std::array<unsigned int, 3>> faces{};
+    get_triangle_mesh(geometry, vertices, faces);
+
+    collision_model_      = collision::sdf_model_t::from_mesh(vertices, faces);
+    collision_model_.id() = this->id();
+}
+
 environment_body_t::environment_body_t(
     simulation_t& simulation,
     index_type id,
@@ -109,7 +171,7 @@ void environment_body_t::update_visual_model()
 }
 void environment_body_t::update_collision_model()
 {
-    // no-op, but might be changed to include local transformation later
+    // no-op, the collision model is moved by transform() or by its own velocities
 }
 void environment_body_t::update_physical_model()
 {
@@ -117,13 +179,30 @@ void environment_body_t::update_physical_model()
 }
 void environment_body_t::transform(Eigen::Affine3d const& affine)
 {
-    // no-op
+    visual_model_.transform(affine);
+    collision_model_.set_transform(affine * collision_model_.transform());
+}
+
+void environment_body_t::advance(scalar_type dt)
+{
+    bool const is_at_rest = collision_model_.linear_velocity().isZero() &&
+                            collision_model_.angular_velocity().isZero();
+    if (is_at_rest)
+        return;
+
+    Eigen::Affine3d const previous_transform = collision_model_.transform();
+    collision_model_.advance(dt);
+    visual_model_.transform(collision_model_.transform() * previous_transform.inverse());
 }
 
 collision::sdf_model_t const& environment_body_t::sdf() const
 {
     return collision_model_;
 }
+collision::sdf_model_t& environment_body_t::sdf()
+{
+    return collision_model_;
+}
 
 } // namespace physics
 } // namespace sbs
\ No newline at end of file
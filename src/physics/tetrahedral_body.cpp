@@ -17,6 +17,53 @@ tetrahedral_body_t::tetrahedral_body_t(
       visual_model_(&physical_model_),
       collision_model_()
 {
+    assert(positions.size() == physical_model_.vertex_count());
+
+    for (auto const& x : positions)
+    {
+        particle_t const p{x};
+        simulation.add_particle(p, this->id());
+    }
+    update_visual_model(simulation.particles().at(this->id()));
+    collision_model_      = collision::point_bvh_model_t(&visual_model_);
+    collision_model_.id() = this->id();
+}
+
+tetrahedral_body_t::tetrahedral_body_t(
+    simulation_t& simulation,
+    index_type id,
+    std::vector<Eigen::Vector3d> const& positions,
+    tetrahedron_set_t topology,
+    boundary_surface_arrays_t boundary)
+    : body_t(simulation, id),
+      physical_model_(std::move(topology)),
+      visual_model_(&physical_model_, std::move(boundary)),
+      collision_model_()
+{
+    assert(positions.size() == physical_model_.vertex_count());
+
+    for (auto const& x : positions)
+    {
+        particle_t const p{x};
+        simulation.add_particle(p, this->id());
+    }
+    update_visual_model(simulation.particles().at(this->id()));
+    collision_model_      = collision::point_bvh_model_t(&visual_model_);
+    collision_model_.id() = this->id();
+}
+
+tetrahedral_body_t::tetrahedral_body_t(
+    simulation_t& simulation,
+    index_type id,
+    common::array_view_t<Eigen::Vector3d> positions,
+    tetrahedron_set_array_views_t const& topology,
+    boundary_surface_array_views_t const& boundary)
+    : body_t(simulation, id), physical_model_(), visual_model_(), collision_model_()
+{
+    physical_model_.assign_arrays(topology);
+    visual_model_ = tetrahedral_mesh_boundary_t(&physical_model_, boundary);
+    assert(positions.size() == physical_model_.vertex_count());
+
     for (auto const& x : positions)
     {
         particle_t const p{x};
@@ -37,18 +84,8 @@ tetrahedral_body_t::tetrahedral_body_t(
     assert(geometry.has_indices());
     assert(geometry.has_positions());
 
-    physical_model_.reserve_vertices(geometry.positions.size() / 3u);
-
-    for (std::size_t i = 0u; i < geometry.indices.size(); i += 4u)
-    {
-        sbs::physics::tetrahedron_t const tetrahedron{
-            static_cast<index_type>(geometry.indices[i]),
-            static_cast<index_type>(geometry.indices[i + 1u]),
-            static_cast<index_type>(geometry.indices[i + 2u]),
-            static_cast<index_type>(geometry.indices[i + 3u])};
-
-        physical_model_.add_tetrahedron(tetrahedron);
-    }
+    std::vector<index_type> const indices(geometry.indices.begin(), geometry.indices.end());
+    physical_model_.assign_tetrahedra(indices);
     visual_model_ = tetrahedral_mesh_boundary_t(&physical_model_);
 
     for (std::size_t i = 0u; i < physical_model_.vertex_count(); ++i)
@@ -2,13 +2,23 @@
 #include "..\..\include\sbs\physics\tetrahedral_mesh_boundary.h"
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <algorithm>
+#include <limits>
 #include <numeric>
+#include <sbs/common/parallel.h>
 #include <sbs/physics/tetrahedral_mesh_boundary.h>
 #include <sbs/physics/topology.h>
 
 namespace sbs {
 namespace physics {
 
+namespace {
+
+std::size_t constexpr num_attributes_per_vertex = 9u; ///< (x,y,z,nx,ny,nz,r,g,b)
+std::size_t constexpr max_tracked_topology_edits = 64u;
+
+} // namespace
+
 /**
  * Surface mesh adapter
  */
@@ -18,12 +28,65 @@ tetrahedral_mesh_boundary_t::tetrahedral_mesh_boundary_t(tetrahedron_set_t* mesh
       vertex_index_map_{},
       tet_to_surface_vertex_index_map_{},
       triangle_index_map_{},
+      tet_to_surface_triangle_index_map_{},
       vertices_{},
-      triangles_{}
+      triangles_{},
+      vertex_triangles_{},
+      are_vertex_triangles_outdated_(false),
+      triangle_normals_{},
+      topology_revision_(0u),
+      triangle_edits_{}
 {
     extract_boundary_surface();
 }
 
+tetrahedral_mesh_boundary_t::tetrahedral_mesh_boundary_t(
+    tetrahedron_set_t* mesh,
+    boundary_surface_arrays_t arrays)
+    : mesh_(mesh),
+      vertex_index_map_(std::move(arrays.vertex_index_map)),
+      tet_to_surface_vertex_index_map_(mesh->vertex_count()),
+      triangle_index_map_(std::move(arrays.triangle_index_map)),
+      tet_to_surface_triangle_index_map_(mesh->triangles().size()),
+      vertices_(vertex_index_map_.size()),
+      triangles_(triangle_index_map_.size()),
+      vertex_triangles_{},
+      are_vertex_triangles_outdated_(false),
+      triangle_normals_{},
+      topology_revision_(0u),
+      triangle_edits_{}
+{
+    for (std::size_t vi = 0u; vi < vertex_index_map_.size(); ++vi)
+        tet_to_surface_vertex_index_map_[vertex_index_map_[vi]] = static_cast<index_type>(vi);
+
+    for (std::size_t fi = 0u; fi < triangle_index_map_.size(); ++fi)
+    {
+        tet_to_surface_triangle_index_map_[triangle_index_map_[fi]] = static_cast<index_type>(fi);
+        std::copy_n(
+            arrays.triangle_vertices.begin() + 3u * fi,
+            3u,
+            triangles_[fi].vertices.begin());
+    }
+
+    rebuild_vertex_triangles();
+    begin_topology_edit();
+    mark_triangles_edited(0u, std::numeric_limits<std::size_t>::max());
+    mark_vertices_dirty();
+    mark_indices_dirty();
+}
+
+tetrahedral_mesh_boundary_t::tetrahedral_mesh_boundary_t(
+    tetrahedron_set_t* mesh,
+    boundary_surface_array_views_t const& arrays)
+    : tetrahedral_mesh_boundary_t(
+          mesh,
+          boundary_surface_arrays_t{
+              {arrays.vertex_index_map.begin(), arrays.vertex_index_map.end()},
+              {arrays.triangle_index_map.begin(), arrays.triangle_index_map.end()},
+              {arrays.triangle_vertices.begin(), arrays.triangle_vertices.end()}})
+{
+}
+
 std::size_t tetrahedral_mesh_boundary_t::triangle_count() const
 {
     return triangles_.size();
@@ -46,6 +109,36 @@ tetrahedral_mesh_boundary_t::triangle(std::size_t fi) const
     return triangles_[fi];
 }
 
+std::uint64_t tetrahedral_mesh_boundary_t::topology_revision() const
+{
+    return topology_revision_;
+}
+
+std::pair<std::size_t, std::size_t>
+tetrahedral_mesh_boundary_t::edited_triangles(std::uint64_t revision) const
+{
+    if (revision >= topology_revision_)
+        return {0u, 0u};
+
+    // edits of revisions which are not tracked anymore may have changed any triangle
+    if (triangle_edits_.empty() || triangle_edits_.front().revision > revision + 1u)
+        return {0u, triangles_.size()};
+
+    std::size_t begin = std::numeric_limits<std::size_t>::max();
+    std::size_t end   = 0u;
+    for (triangle_edit_t const& edit : triangle_edits_)
+    {
+        if (edit.revision <= revision)
+            continue;
+
+        begin = std::min(begin, edit.begin);
+        end   = std::max(end, edit.end);
+    }
+    end   = std::min(end, triangles_.size());
+    begin = std::min(begin, end);
+    return {begin, end};
+}
+
 std::vector<index_type> const&
 tetrahedral_mesh_boundary_t::surface_to_tetrahedral_mesh_index_map() const
 {
@@ -64,17 +157,22 @@ index_type tetrahedral_mesh_boundary_t::from_surface_triangle(std::size_t fi) co
 
 void tetrahedral_mesh_boundary_t::extract_boundary_surface()
 {
+    begin_topology_edit();
+    mark_triangles_edited(0u, std::numeric_limits<std::size_t>::max());
+
     vertex_index_map_.clear();
     triangle_index_map_.clear();
     tet_to_surface_vertex_index_map_.clear();
+    tet_to_surface_triangle_index_map_.clear();
     vertices_.clear();
     triangles_.clear();
 
     std::size_t const tet_mesh_vertex_count = mesh_->vertex_count();
-    std::size_t const tet_mesh_face_count   = mesh_->triangle_count();
+    std::size_t const tet_mesh_face_count   = mesh_->triangles().size();
 
-    // maps tetrahedral mesh vertices to surface mesh vertices
+    // maps tetrahedral mesh vertices and triangles to surface mesh vertices and triangles
     tet_to_surface_vertex_index_map_.resize(tet_mesh_vertex_count);
+    tet_to_surface_triangle_index_map_.resize(tet_mesh_face_count);
 
     // pre-allocate vertex storage heuristically, and triangle storage exactly
     vertex_index_map_.reserve(mesh_->triangle_count());
@@ -82,47 +180,47 @@ void tetrahedral_mesh_boundary_t::extract_boundary_surface()
     triangles_.reserve(mesh_->triangle_count());
     vertices_.reserve(mesh_->vertex_count());
 
-    std::vector<triangle_t> const& triangles = mesh_->triangles();
-    for (std::size_t fi = 0u; fi < triangles.size(); ++fi)
-    {
-        bool const is_interior_triangle = triangles[fi].incident_tetrahedron_indices().size() == 2u;
-        if (is_interior_triangle)
-            continue;
+    // boundary triangles are those of unpaired half-faces, visited in triangle index order
+    std::vector<index_type> boundary_half_faces(
+        tet_mesh_face_count,
+        tetrahedron_set_t::no_half_face);
+    for (index_type const h : mesh_->boundary_half_faces())
+        boundary_half_faces[mesh_->tetrahedron(h / 4u).face_indices()[h % 4u]] = h;
 
-        triangle_index_map_.push_back(static_cast<index_type>(fi));
+    for (index_type const h : boundary_half_faces)
+    {
+        if (h != tetrahedron_set_t::no_half_face)
+            add_surface_triangle(h);
+    }
 
-        triangle_t const& boundary_triangle = triangles[fi];
-        triangle_type surface_mesh_triangle{};
+    rebuild_vertex_triangles();
+    mark_vertices_dirty();
+    mark_indices_dirty();
+}
 
-        for (std::size_t j = 0u; j < boundary_triangle.vertex_indices().size(); ++j)
-        {
-            index_type const vi = boundary_triangle.vertex_indices()[j];
-
-            if (!tet_to_surface_vertex_index_map_[vi].has_value())
-            {
-                // update map
-                index_type const new_vertex_index =
-                    static_cast<index_type>(vertex_index_map_.size());
-                tet_to_surface_vertex_index_map_[vi] = new_vertex_index;
-                vertex_index_map_.push_back(vi);
-                // Note: Vertex attributes should be set by the owning body in update_visual_model()
-                vertices_.push_back({});
-                surface_mesh_triangle.vertices[j] = new_vertex_index;
-            }
-            else
-            {
-                surface_mesh_triangle.vertices[j] = tet_to_surface_vertex_index_map_[vi].value();
-            }
-        }
+index_type tetrahedral_mesh_boundary_t::add_tetrahedron(tetrahedron_t const& tetrahedron)
+{
+    index_type const ti = mesh_->add_tetrahedron(tetrahedron);
+    begin_topology_edit();
+    update_boundary_triangles(mesh_->tetrahedron(ti).face_indices());
+    return ti;
+}
 
-        triangles_.push_back(surface_mesh_triangle);
-    }
+tetrahedron_t tetrahedral_mesh_boundary_t::remove_tetrahedron(index_type ti)
+{
+    tetrahedron_t const removed_tetrahedron = mesh_->remove_tetrahedron(ti);
+    begin_topology_edit();
+    update_boundary_triangles(removed_tetrahedron.face_indices());
+    return removed_tetrahedron;
 }
 
 void tetrahedral_mesh_boundary_t::compute_normals()
 {
-    for (std::size_t i = 0u; i < triangles_.size(); ++i)
-    {
+    if (are_vertex_triangles_outdated_)
+        rebuild_vertex_triangles();
+
+    triangle_normals_.resize(triangles_.size());
+    common::parallel_for(triangles_.size(), [this](std::size_t i) {
         auto const v1 = triangles_[i].vertices[0u];
         auto const v2 = triangles_[i].vertices[1u];
         auto const v3 = triangles_[i].vertices[2u];
@@ -131,17 +229,17 @@ void tetrahedral_mesh_boundary_t::compute_normals()
         Eigen::Vector3d const& p2 = vertices_[v2].position;
         Eigen::Vector3d const& p3 = vertices_[v3].position;
 
-        Eigen::Vector3d const n = (p2 - p1).cross(p3 - p1);
+        triangle_normals_[i] = (p2 - p1).cross(p3 - p1);
+    });
 
-        vertices_[v1].normal += n;
-        vertices_[v2].normal += n;
-        vertices_[v3].normal += n;
-    }
+    // every vertex gathers the area weighted normals of its triangles, in a fixed order
+    common::parallel_for(vertices_.size(), [this](std::size_t i) {
+        Eigen::Vector3d n = Eigen::Vector3d::Zero();
+        for (index_type const fi : vertex_triangles_[i])
+            n += triangle_normals_[fi];
 
-    for (std::size_t i = 0u; i < vertices_.size(); ++i)
-    {
-        vertices_[i].normal.normalize();
-    }
+        vertices_[i].normal = n.normalized();
+    });
 }
 
 void tetrahedral_mesh_boundary_t::prepare_vertices_for_rendering()
@@ -163,13 +261,14 @@ tetrahedral_mesh_boundary_t::mutable_vertex(std::size_t vi)
 common::shared_vertex_surface_mesh_i::triangle_type&
 tetrahedral_mesh_boundary_t::mutable_triangle(std::size_t f)
 {
+    begin_topology_edit();
+    mark_triangles_edited(f, f + 1u);
     return triangles_[f];
 }
 
 void tetrahedral_mesh_boundary_t::prepare_vertices_for_surface_rendering()
 {
-    std::size_t constexpr num_attributes_per_vertex = 9u;
-    std::size_t const vertex_count                  = vertices_.size();
+    std::size_t const vertex_count = vertices_.size();
     std::vector<float> vertex_buffer{};
     vertex_buffer.reserve(vertex_count * num_attributes_per_vertex);
 
@@ -217,6 +316,197 @@ void tetrahedral_mesh_boundary_t::prepare_indices_for_wireframe_rendering()
     // no-op
 }
 
+void tetrahedral_mesh_boundary_t::update_boundary_triangles(std::array<index_type, 4u> const& fis)
+{
+    tet_to_surface_vertex_index_map_.resize(mesh_->vertex_count());
+    tet_to_surface_triangle_index_map_.resize(mesh_->triangles().size());
+
+    // vertices of removed surface triangles are only removed once all triangles are up to date
+    std::array<index_type, 12u> removed_triangle_vertices{};
+    std::size_t removed_triangle_vertex_count = 0u;
+    for (index_type const fi : fis)
+    {
+        index_type const h             = boundary_half_face_of(fi);
+        bool const is_boundary         = h != tetrahedron_set_t::no_half_face;
+        bool const is_surface_triangle = tet_to_surface_triangle_index_map_[fi].has_value();
+        if (is_boundary && !is_surface_triangle)
+        {
+            add_surface_triangle(h);
+        }
+        else if (!is_boundary && is_surface_triangle)
+        {
+            index_type const surface_triangle_index =
+                tet_to_surface_triangle_index_map_[fi].value();
+            for (std::uint32_t const vi : triangles_[surface_triangle_index].vertices)
+                removed_triangle_vertices[removed_triangle_vertex_count++] = vertex_index_map_[vi];
+            remove_surface_triangle(fi);
+        }
+    }
+
+    for (std::size_t i = 0u; i < removed_triangle_vertex_count; ++i)
+        remove_surface_vertex_if_unused(removed_triangle_vertices[i]);
+
+    are_vertex_triangles_outdated_ = true;
+}
+
+index_type tetrahedral_mesh_boundary_t::boundary_half_face_of(index_type fi) const
+{
+    if (fi >= mesh_->triangles().size())
+        return tetrahedron_set_t::no_half_face;
+
+    // removed triangles have no incident tetrahedra
+    for (index_type const ti : mesh_->triangle(fi).incident_tetrahedron_indices())
+    {
+        std::uint8_t const f = mesh_->tetrahedron(ti).id_of_face(fi);
+        if (mesh_->is_boundary_face(ti, f))
+            return 4u * ti + f;
+    }
+    return tetrahedron_set_t::no_half_face;
+}
+
+void tetrahedral_mesh_boundary_t::add_surface_triangle(index_type h)
+{
+    // the face as seen from the tetrahedron owning it, which orients it outwards
+    tetrahedron_t const& tetrahedron        = mesh_->tetrahedron(h / 4u);
+    index_type const fi                     = tetrahedron.face_indices()[h % 4u];
+    triangle_t const boundary_triangle      = tetrahedron.faces_copy()[h % 4u];
+    index_type const surface_triangle_index = static_cast<index_type>(triangles_.size());
+
+    triangle_type surface_mesh_triangle{};
+    for (std::size_t j = 0u; j < boundary_triangle.vertex_indices().size(); ++j)
+    {
+        index_type const vi               = boundary_triangle.vertex_indices()[j];
+        surface_mesh_triangle.vertices[j] = surface_vertex_of(vi);
+    }
+
+    triangles_.push_back(surface_mesh_triangle);
+    triangle_index_map_.push_back(fi);
+    tet_to_surface_triangle_index_map_[fi] = surface_triangle_index;
+    mark_indices_dirty(3u * surface_triangle_index, 3u * triangles_.size());
+    mark_triangles_edited(surface_triangle_index, triangles_.size());
+}
+
+void tetrahedral_mesh_boundary_t::remove_surface_triangle(index_type fi)
+{
+    // the last surface triangle takes the removed one's place
+    index_type const surface_triangle_index = tet_to_surface_triangle_index_map_[fi].value();
+    index_type const last                   = static_cast<index_type>(triangles_.size() - 1u);
+    if (surface_triangle_index != last)
+    {
+        index_type const moved_fi                    = triangle_index_map_[last];
+        triangles_[surface_triangle_index]           = triangles_[last];
+        triangle_index_map_[surface_triangle_index]  = moved_fi;
+        tet_to_surface_triangle_index_map_[moved_fi] = surface_triangle_index;
+        mark_indices_dirty(3u * surface_triangle_index, 3u * surface_triangle_index + 3u);
+        mark_triangles_edited(surface_triangle_index, surface_triangle_index + 1u);
+    }
+    triangles_.pop_back();
+    triangle_index_map_.pop_back();
+    tet_to_surface_triangle_index_map_[fi].reset();
+}
+
+index_type tetrahedral_mesh_boundary_t::surface_vertex_of(index_type vi)
+{
+    if (tet_to_surface_vertex_index_map_[vi].has_value())
+        return tet_to_surface_vertex_index_map_[vi].value();
+
+    index_type const new_vertex_index    = static_cast<index_type>(vertex_index_map_.size());
+    tet_to_surface_vertex_index_map_[vi] = new_vertex_index;
+    vertex_index_map_.push_back(vi);
+    // Note: Vertex attributes should be set by the owning body in update_visual_model()
+    vertices_.push_back({});
+    mark_vertices_dirty(
+        num_attributes_per_vertex * new_vertex_index,
+        num_attributes_per_vertex * vertices_.size());
+    return new_vertex_index;
+}
+
+void tetrahedral_mesh_boundary_t::remove_surface_vertex_if_unused(index_type vi)
+{
+    if (!tet_to_surface_vertex_index_map_[vi].has_value())
+        return;
+
+    std::vector<index_type> const& incident_triangles =
+        mesh_->vertex(vi).incident_triangle_indices();
+    bool const is_used = std::any_of(
+        incident_triangles.begin(),
+        incident_triangles.end(),
+        [this](index_type const fi) { return tet_to_surface_triangle_index_map_[fi].has_value(); });
+    if (is_used)
+        return;
+
+    // the last surface vertex takes the removed one's place, and its triangles are renumbered
+    index_type const surface_vertex_index = tet_to_surface_vertex_index_map_[vi].value();
+    index_type const last                 = static_cast<index_type>(vertices_.size() - 1u);
+    if (surface_vertex_index != last)
+    {
+        index_type const moved_vi                  = vertex_index_map_[last];
+        vertices_[surface_vertex_index]            = vertices_[last];
+        vertex_index_map_[surface_vertex_index]    = moved_vi;
+        tet_to_surface_vertex_index_map_[moved_vi] = surface_vertex_index;
+        mark_vertices_dirty(
+            num_attributes_per_vertex * surface_vertex_index,
+            num_attributes_per_vertex * (surface_vertex_index + 1u));
+
+        for (index_type const fi : mesh_->vertex(moved_vi).incident_triangle_indices())
+        {
+            if (!tet_to_surface_triangle_index_map_[fi].has_value())
+                continue;
+
+            index_type const surface_triangle_index =
+                tet_to_surface_triangle_index_map_[fi].value();
+            std::array<std::uint32_t, 3u>& vertices = triangles_[surface_triangle_index].vertices;
+            std::replace(vertices.begin(), vertices.end(), last, surface_vertex_index);
+            mark_indices_dirty(3u * surface_triangle_index, 3u * surface_triangle_index + 3u);
+            mark_triangles_edited(surface_triangle_index, surface_triangle_index + 1u);
+        }
+    }
+    vertices_.pop_back();
+    vertex_index_map_.pop_back();
+    tet_to_surface_vertex_index_map_[vi].reset();
+}
+
+void tetrahedral_mesh_boundary_t::rebuild_vertex_triangles()
+{
+    vertex_triangles_.assign(
+        vertices_.size(),
+        triangles_.size(),
+        3u,
+        [this](std::size_t fi, std::size_t k) { return triangles_[fi].vertices[k]; });
+    are_vertex_triangles_outdated_ = false;
+}
+
+void tetrahedral_mesh_boundary_t::begin_topology_edit()
+{
+    if (triangle_edits_.size() == max_tracked_topology_edits)
+        triangle_edits_.erase(triangle_edits_.begin());
+
+    triangle_edits_.push_back({++topology_revision_, std::numeric_limits<std::size_t>::max(), 0u});
+}
+
+void tetrahedral_mesh_boundary_t::mark_triangles_edited(std::size_t begin, std::size_t end)
+{
+    triangle_edit_t& edit = triangle_edits_.back();
+    edit.begin            = std::min(edit.begin, begin);
+    edit.end              = std::max(edit.end, end);
+}
+
+boundary_surface_arrays_t tetrahedral_mesh_boundary_t::arrays() const
+{
+    boundary_surface_arrays_t flat{};
+    flat.vertex_index_map   = vertex_index_map_;
+    flat.triangle_index_map = triangle_index_map_;
+    flat.triangle_vertices.reserve(3u * triangles_.size());
+    for (triangle_type const& t : triangles_)
+    {
+        flat.triangle_vertices.insert(
+            flat.triangle_vertices.end(),
+            t.vertices.begin(),
+            t.vertices.end());
+    }
+    return flat;
+}
+
 tetrahedron_set_t const* tetrahedral_mesh_boundary_t::tetrahedral_mesh() const
 {
     return mesh_;
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <sbs/physics/body.h>
 #include <sbs/physics/collision/cd_system.h>
@@ -9,6 +10,31 @@
 namespace sbs {
 namespace physics {
 
+namespace {
+
+/**
+ * Longest distance travelled by a particle during a step of length dt, assuming the particles
+ * keep their current velocity and the external forces applied to them, including gravity. The
+ * constraint projections also move particles, which this estimate does not account for.
+ */
+scalar_type max_particle_displacement(simulation_t const& simulation, scalar_type dt)
+{
+    Eigen::Vector3d const gravity{0., -9.81, 0.};
+    scalar_type max_displacement = 0.;
+    for (std::vector<particle_t> const& body_particles : simulation.particles())
+    {
+        for (particle_t const& p : body_particles)
+        {
+            Eigen::Vector3d const a            = (p.f() + gravity) * p.invmass();
+            Eigen::Vector3d const displacement = p.v() * dt + scalar_type{0.5} * a * dt * dt;
+            max_displacement                   = std::max(max_displacement, displacement.norm());
+        }
+    }
+    return max_displacement;
+}
+
+} // namespace
+
 timestep_t::timestep_t(
     scalar_type const dt,
     std::size_t const iterations,
@@ -27,10 +53,27 @@ void timestep_t::step(simulation_t& simulation)
     // cut(simulation);
     // body->update_physical_model();
     auto const& cd_system = simulation.collision_detection_system();
+    if (refresh_contacts_every_substep_)
+    {
+        cd_system->broad_phase_margin() = max_particle_displacement(simulation, dt_);
+    }
     cd_system->execute();
 
     for (std::size_t s = 0u; s < substeps_; ++s)
     {
+        if (refresh_contacts_every_substep_ && s > 0u)
+        {
+            // move the collision models to the current positions, and only run the narrow
+            // phase again on the candidate pairs found at the start of the step
+            for (auto& body : simulation.bodies())
+            {
+                body->update_visual_model();
+                body->update_collision_model();
+            }
+            simulation.collision_constraints().clear();
+            cd_system->refresh_contacts();
+        }
+
         // move particles using semi-implicit integration
         for (std::vector<particle_t>& body_particles : particles)
         {
@@ -55,6 +98,10 @@ void timestep_t::step(simulation_t& simulation)
                 p.f().setZero();
             }
         }
+
+        // kinematic colliders move along their velocities, as their contacts assumed
+        for (auto& body : simulation.bodies())
+            body->advance(dt);
     }
 
     auto& bodies = simulation.bodies();
@@ -96,6 +143,15 @@ std::size_t& timestep_t::substeps()
     return substeps_;
 }
 
+bool timestep_t::refresh_contacts_every_substep() const
+{
+    return refresh_contacts_every_substep_;
+}
+bool& timestep_t::refresh_contacts_every_substep()
+{
+    return refresh_contacts_every_substep_;
+}
+
 std::unique_ptr<solver_t> const& timestep_t::solver() const
 {
     return solver_;
@@ -1,11 +1,37 @@
 #include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iterator>
+#include <numeric>
+#include <sbs/common/parallel.h>
 #include <sbs/physics/topology.h>
+#include <set>
 
 namespace sbs {
 namespace physics {
 
+namespace {
+
+/**
+ * Indices of removed primitives are kept in a min-heap, such that added primitives fill the
+ * smallest free index first
+ */
+void push_free_index(std::vector<index_type>& free_indices, index_type i)
+{
+    free_indices.push_back(i);
+    std::push_heap(free_indices.begin(), free_indices.end(), std::greater<index_type>{});
+}
+
+index_type pop_smallest_free_index(std::vector<index_type>& free_indices)
+{
+    std::pop_heap(free_indices.begin(), free_indices.end(), std::greater<index_type>{});
+    index_type const i = free_indices.back();
+    free_indices.pop_back();
+    return i;
+}
+
+} // namespace
+
 /**
  * Vertex implementation
  */
@@ -124,6 +150,13 @@ bool edge_t::is_reverse_of(edge_t const& other) const
     return v1() == other.v2() && v2() == other.v1();
 }
 
+std::uint64_t edge_t::key() const
+{
+    std::uint64_t const a = std::min(v_[0], v_[1]);
+    std::uint64_t const b = std::max(v_[0], v_[1]);
+    return (a << 32u) | b;
+}
+
 bool edge_t::operator==(edge_t const& other) const
 {
     std::array<index_type, 2u> v      = v_;
@@ -231,6 +264,18 @@ bool triangle_t::is_reverse_of(triangle_t const& other) const
     return v != vother;
 }
 
+std::array<index_type, 3u> triangle_t::key() const
+{
+    std::array<index_type, 3u> v = v_;
+    if (v[0] > v[1])
+        std::swap(v[0], v[1]);
+    if (v[1] > v[2])
+        std::swap(v[1], v[2]);
+    if (v[0] > v[1])
+        std::swap(v[0], v[1]);
+    return v;
+}
+
 bool triangle_t::operator==(triangle_t const& other) const
 {
     std::array<index_type, 3u> v      = v_;
@@ -401,6 +446,47 @@ bool tetrahedron_t::operator<(tetrahedron_t const& other) const
     return v < otherv;
 }
 
+/**
+ * Compressed sparse row incidence implementation
+ */
+
+csr_incidence_t::row_type csr_incidence_t::operator[](std::size_t i) const
+{
+    return row_type{entries_.data() + offsets_[i], entries_.data() + offsets_[i + 1u]};
+}
+
+void csr_incidence_t::assign_rows(std::vector<index_type> offsets, std::vector<index_type> entries)
+{
+    offsets_ = std::move(offsets);
+    entries_ = std::move(entries);
+}
+
+void csr_incidence_t::assign_rows(csr_incidence_view_t const& rows)
+{
+    offsets_.assign(rows.offsets.begin(), rows.offsets.end());
+    entries_.assign(rows.entries.begin(), rows.entries.end());
+}
+
+std::size_t csr_incidence_t::row_count() const
+{
+    return offsets_.empty() ? 0u : offsets_.size() - 1u;
+}
+
+std::size_t csr_incidence_t::count(std::size_t i) const
+{
+    return static_cast<std::size_t>(offsets_[i + 1u] - offsets_[i]);
+}
+
+std::vector<index_type> const& csr_incidence_t::offsets() const
+{
+    return offsets_;
+}
+
+std::vector<index_type> const& csr_incidence_t::entries() const
+{
+    return entries_;
+}
+
 /**
  * Vertex set implementation
  */
@@ -410,7 +496,7 @@ vertex_t const& vertex_set_t::vertex(std::size_t vi) const
     return vertices_[vi];
 }
 
-vertex_t& vertex_set_t::vertex(std::size_t vi)
+vertex_t& vertex_set_t::mutable_vertex(std::size_t vi)
 {
     return vertices_[vi];
 }
@@ -422,8 +508,10 @@ bool vertex_set_t::contains_vertex(vertex_t const& v) const
 
 index_type vertex_set_t::add_vertex()
 {
+    build_deferred_incidence_lists();
     index_type const vi = static_cast<index_type>(vertices_.size());
     vertices_.push_back(vertex_t{vi});
+    ++revision_;
 
     return vi;
 }
@@ -460,6 +548,7 @@ void vertex_set_t::reserve_vertices(std::size_t count)
 void vertex_set_t::clear()
 {
     vertices_.clear();
+    ++revision_;
 }
 
 std::vector<vertex_t> const& vertex_set_t::vertices() const
@@ -469,6 +558,7 @@ std::vector<vertex_t> const& vertex_set_t::vertices() const
 
 void vertex_set_t::remove_vertex_to_edge_incidency(index_type const vi, index_type ei)
 {
+    build_deferred_incidence_lists();
     vertex_t& v = vertices_[vi];
     auto it = std::remove(v.incident_edge_indices().begin(), v.incident_edge_indices().end(), ei);
     v.incident_edge_indices().erase(it);
@@ -476,6 +566,7 @@ void vertex_set_t::remove_vertex_to_edge_incidency(index_type const vi, index_ty
 
 void vertex_set_t::remove_vertex_to_triangle_incidency(index_type const vi, index_type fi)
 {
+    build_deferred_incidence_lists();
     vertex_t& v = vertices_[vi];
     auto it =
         std::remove(v.incident_triangle_indices().begin(), v.incident_triangle_indices().end(), fi);
@@ -484,6 +575,7 @@ void vertex_set_t::remove_vertex_to_triangle_incidency(index_type const vi, inde
 
 void vertex_set_t::remove_vertex_to_tetrahedron_incidency(index_type const vi, index_type ti)
 {
+    build_deferred_incidence_lists();
     vertex_t& v = vertices_[vi];
     auto it     = std::remove(
         v.incident_tetrahedron_indices().begin(),
@@ -506,25 +598,25 @@ edge_t const& edge_set_t::edge(index_type ei) const
     return edges_[ei];
 }
 
-edge_t& edge_set_t::edge(index_type ei)
+edge_t& edge_set_t::mutable_edge(index_type ei)
 {
     return edges_[ei];
 }
 
 index_type edge_set_t::ei(edge_t const& edge) const
 {
-    auto it = edge_map_.find(edge);
-    assert(it != edge_map_.end());
-    return it->second;
+    index_type const* ei = edge_map_.find(edge.key());
+    assert(ei != nullptr);
+    return *ei;
 }
 
 index_type edge_set_t::add_edge(edge_t const& edge)
 {
-    auto it = edge_map_.find(edge);
-    if (it != edge_map_.end())
+    build_deferred_incidence_lists();
+    std::uint64_t const key = edge.key();
+    if (index_type const* existing_ei = edge_map_.find(key))
     {
-        index_type const ei = it->second;
-        return ei;
+        return *existing_ei;
     }
 
     edge_t created_edge{edge.v1(), edge.v2()};
@@ -537,9 +629,8 @@ index_type edge_set_t::add_edge(edge_t const& edge)
     index_type ei{};
     if (!edge_garbage_collector_.empty())
     {
-        ei         = *edge_garbage_collector_.begin();
+        ei         = pop_smallest_free_index(edge_garbage_collector_);
         edges_[ei] = created_edge;
-        edge_garbage_collector_.erase(edge_garbage_collector_.begin());
     }
     else
     {
@@ -547,13 +638,15 @@ index_type edge_set_t::add_edge(edge_t const& edge)
         edges_.push_back(created_edge);
     }
 
-    edge_map_[created_edge] = ei;
+    edge_map_.insert_or_assign(key, ei);
     create_vertex_to_edge_incidency(ei);
+    ++revision_;
     return ei;
 }
 
 edge_t edge_set_t::remove_edge(index_type ei)
 {
+    build_deferred_incidence_lists();
     edge_t const& edge = edges_[ei];
 
     for (index_type const vi : edge.vertex_indices())
@@ -561,20 +654,19 @@ edge_t edge_set_t::remove_edge(index_type ei)
         remove_vertex_to_edge_incidency(vi, ei);
     }
 
-    auto it = edge_map_.find(edge);
-    assert(it != edge_map_.end());
-    edge_map_.erase(it);
+    bool const was_erased = edge_map_.erase(edge.key());
+    assert(was_erased);
+    (void)was_erased;
 
-    edge_garbage_collector_.insert(ei);
+    push_free_index(edge_garbage_collector_, ei);
+    ++revision_;
 
     return edge;
 }
 
 edge_t edge_set_t::remove_edge(edge_t const& edge)
 {
-    auto it = edge_map_.find(edge);
-    assert(it != edge_map_.end());
-    index_type const ei = it->second;
+    index_type const ei = this->ei(edge);
     remove_edge(ei);
     return edge;
 }
@@ -586,12 +678,13 @@ std::size_t edge_set_t::edge_count() const
 
 bool edge_set_t::contains_edge(edge_t const& edge) const
 {
-    return edge_map_.find(edge) != edge_map_.end();
+    return edge_map_.contains(edge.key());
 }
 
 void edge_set_t::reserve_edges(std::size_t count)
 {
     edges_.reserve(count);
+    edge_map_.reserve(count);
 }
 
 void edge_set_t::clear()
@@ -612,23 +705,24 @@ std::vector<edge_t> const& edge_set_t::edges() const
     return edges_;
 }
 
-std::vector<edge_t>& edge_set_t::edges()
+std::vector<edge_t>& edge_set_t::mutable_edges()
 {
     return edges_;
 }
 
-std::map<edge_t, index_type>::const_iterator edge_set_t::safe_edges_begin() const
+edge_set_t::edge_map_type::const_iterator edge_set_t::safe_edges_begin() const
 {
     return edge_map_.begin();
 }
 
-std::map<edge_t, index_type>::const_iterator edge_set_t::safe_edges_end() const
+edge_set_t::edge_map_type::const_iterator edge_set_t::safe_edges_end() const
 {
     return edge_map_.end();
 }
 
 void edge_set_t::remove_edge_to_triangle_incidency(index_type const ei, index_type fi)
 {
+    build_deferred_incidence_lists();
     edge_t& edge = edges_[ei];
     auto it      = std::remove(
         edge.incident_triangle_indices().begin(),
@@ -639,6 +733,7 @@ void edge_set_t::remove_edge_to_triangle_incidency(index_type const ei, index_ty
 
 void edge_set_t::remove_edge_to_tetrahedron_incidency(index_type const ei, index_type ti)
 {
+    build_deferred_incidence_lists();
     edge_t& edge = edges_[ei];
     auto it      = std::remove(
         edge.incident_tetrahedron_indices().begin(),
@@ -649,10 +744,11 @@ void edge_set_t::remove_edge_to_tetrahedron_incidency(index_type const ei, index
 
 void edge_set_t::create_vertex_to_edge_incidency(index_type const ei)
 {
+    build_deferred_incidence_lists();
     edge_t const& edge = edges_[ei];
     for (index_type const vi : edge.vertex_indices())
     {
-        vertex_t& v = vertex(vi);
+        vertex_t& v = mutable_vertex(vi);
         v.incident_edge_indices().push_back(ei);
     }
 }
@@ -664,24 +760,29 @@ bool edge_set_t::operator==(edge_set_t const& other) const
     if (!are_vertex_sets_equal)
         return false;
 
-    std::vector<edge_t> edge_set_1{};
+
+    // the maps' iteration orders depend on their insertion histories
+    std::vector<std::uint64_t> edge_set_1{};
     std::transform(
         edge_map_.begin(),
         edge_map_.end(),
         std::back_inserter(edge_set_1),
-        [](std::pair<edge_t const, index_type> const& kv) { return kv.first; });
+        [](edge_map_type::value_type const& kv) { return kv.first; });
+    std::sort(edge_set_1.begin(), edge_set_1.end());
 
-    std::vector<edge_t> edge_set_2{};
+    std::vector<std::uint64_t> edge_set_2{};
     std::transform(
         other.edge_map_.begin(),
         other.edge_map_.end(),
         std::back_inserter(edge_set_2),
-        [](std::pair<edge_t const, index_type> const& kv) { return kv.first; });
+        [](edge_map_type::value_type const& kv) { return kv.first; });
+    std::sort(edge_set_2.begin(), edge_set_2.end());
 
     bool const are_edge_sets_equal = (edge_set_1 == edge_set_2);
     return are_edge_sets_equal;
 }
 
+
 /**
  * Triangle set implementation
  */
@@ -691,50 +792,39 @@ triangle_t const& triangle_set_t::triangle(index_type fi) const
     return triangles_[fi];
 }
 
-triangle_t& triangle_set_t::triangle(index_type fi)
+triangle_t& triangle_set_t::mutable_triangle(index_type fi)
 {
     return triangles_[fi];
 }
 
 index_type triangle_set_t::fi(triangle_t const& triangle) const
 {
-    auto it = triangle_map_.find(triangle);
-    assert(it != triangle_map_.end());
-    return it->second;
+    index_type const* fi = triangle_map_.find(triangle.key());
+    assert(fi != nullptr);
+    return *fi;
 }
 
-void triangle_set_t::add_triangle(triangle_t const& triangle)
+index_type triangle_set_t::add_triangle(triangle_t const& triangle)
 {
-    auto it = triangle_map_.find(triangle);
-    if (it != triangle_map_.end())
+    build_deferred_incidence_lists();
+    std::array<index_type, 3u> const key = triangle.key();
+    if (index_type const* existing_fi = triangle_map_.find(key))
     {
-        return;
+        return *existing_fi;
     }
 
     triangle_t created_triangle{triangle.v1(), triangle.v2(), triangle.v3()};
     std::array<edge_t, 3u> const edge_copies = created_triangle.edges_copy();
     for (std::uint8_t e = 0u; e < edge_copies.size(); ++e)
     {
-        edge_t const& edge_copy = edge_copies[e];
-
-        auto edge_it = edge_map_.find(edge_copy);
-        if (edge_it == edge_map_.end())
-        {
-            index_type const ei                   = add_edge(edge_copy);
-            created_triangle.edge_indices().at(e) = ei;
-        }
-        else
-        {
-            index_type const ei                   = edge_it->second;
-            created_triangle.edge_indices().at(e) = ei;
-        }
+        // add_edge returns the index of the existing edge, if any
+        created_triangle.edge_indices().at(e) = add_edge(edge_copies[e]);
     }
     index_type fi{};
     if (!triangle_garbage_collector_.empty())
     {
-        fi             = *triangle_garbage_collector_.begin();
+        fi             = pop_smallest_free_index(triangle_garbage_collector_);
         triangles_[fi] = created_triangle;
-        triangle_garbage_collector_.erase(triangle_garbage_collector_.begin());
     }
     else
     {
@@ -742,14 +832,16 @@ void triangle_set_t::add_triangle(triangle_t const& triangle)
         triangles_.push_back(created_triangle);
     }
 
-    triangle_map_[created_triangle] = fi;
+    triangle_map_.insert_or_assign(key, fi);
     create_vertex_to_triangle_incidency(fi);
     create_edge_to_triangle_incidency(fi);
-    return;
+    ++revision_;
+    return fi;
 }
 
 triangle_t triangle_set_t::remove_triangle(index_type fi)
 {
+    build_deferred_incidence_lists();
     triangle_t const triangle = triangles_[fi];
 
     for (index_type const vi : triangle.vertex_indices())
@@ -765,19 +857,18 @@ triangle_t triangle_set_t::remove_triangle(index_type fi)
         }
     }
 
-    auto it = triangle_map_.find(triangle);
-    assert(it != triangle_map_.end());
-    triangle_map_.erase(it);
-    triangle_garbage_collector_.insert(fi);
+    bool const was_erased = triangle_map_.erase(triangle.key());
+    assert(was_erased);
+    (void)was_erased;
+    push_free_index(triangle_garbage_collector_, fi);
+    ++revision_;
 
     return triangle;
 }
 
 triangle_t triangle_set_t::remove_triangle(triangle_t const& triangle)
 {
-    auto it = triangle_map_.find(triangle);
-    assert(it != triangle_map_.end());
-    index_type const fi = it->second;
+    index_type const fi = this->fi(triangle);
     remove_triangle(fi);
     return triangle;
 }
@@ -789,12 +880,13 @@ std::size_t triangle_set_t::triangle_count() const
 
 bool triangle_set_t::contains_triangle(triangle_t const& triangle) const
 {
-    return triangle_map_.find(triangle) != triangle_map_.end();
+    return triangle_map_.contains(triangle.key());
 }
 
 void triangle_set_t::reserve_triangles(std::size_t count)
 {
     triangles_.reserve(count);
+    triangle_map_.reserve(count);
 }
 
 void triangle_set_t::clear()
@@ -815,37 +907,39 @@ std::vector<triangle_t> const& triangle_set_t::triangles() const
     return triangles_;
 }
 
-std::vector<triangle_t>& triangle_set_t::triangles()
+std::vector<triangle_t>& triangle_set_t::mutable_triangles()
 {
     return triangles_;
 }
 
-std::map<triangle_t, index_type>::const_iterator triangle_set_t::safe_triangles_begin() const
+triangle_set_t::triangle_map_type::const_iterator triangle_set_t::safe_triangles_begin() const
 {
     return triangle_map_.begin();
 }
 
-std::map<triangle_t, index_type>::const_iterator triangle_set_t::safe_triangles_end() const
+triangle_set_t::triangle_map_type::const_iterator triangle_set_t::safe_triangles_end() const
 {
     return triangle_map_.end();
 }
 
 void triangle_set_t::create_vertex_to_triangle_incidency(index_type const fi)
 {
+    build_deferred_incidence_lists();
     triangle_t const& f = triangle(fi);
     for (index_type const vi : f.vertex_indices())
     {
-        vertex_t& v = vertex(vi);
+        vertex_t& v = mutable_vertex(vi);
         v.incident_triangle_indices().push_back(fi);
     }
 }
 
 void triangle_set_t::create_edge_to_triangle_incidency(index_type const fi)
 {
+    build_deferred_incidence_lists();
     triangle_t const& f = triangle(fi);
     for (index_type const ei : f.edge_indices())
     {
-        edge_t& e = edge(ei);
+        edge_t& e = mutable_edge(ei);
         e.incident_triangle_indices().push_back(fi);
     }
 }
@@ -854,7 +948,8 @@ void triangle_set_t::remove_triangle_to_tetrahedron_incidency(
     index_type const fi,
     index_type const ti)
 {
-    triangle_t& f = triangle(fi);
+    build_deferred_incidence_lists();
+    triangle_t& f = mutable_triangle(fi);
     auto it       = std::remove(
         f.incident_tetrahedron_indices().begin(),
         f.incident_tetrahedron_indices().end(),
@@ -869,24 +964,170 @@ bool triangle_set_t::operator==(triangle_set_t const& other) const
     if (!are_edge_sets_equal)
         return false;
 
-    std::vector<triangle_t> triangle_set_1{};
+
+    std::vector<std::array<index_type, 3u>> triangle_set_1{};
     std::transform(
         triangle_map_.begin(),
         triangle_map_.end(),
         std::back_inserter(triangle_set_1),
-        [](std::pair<triangle_t const, index_type> const& kv) { return kv.first; });
+        [](triangle_map_type::value_type const& kv) { return kv.first; });
+    std::sort(triangle_set_1.begin(), triangle_set_1.end());
 
-    std::vector<triangle_t> triangle_set_2{};
+    std::vector<std::array<index_type, 3u>> triangle_set_2{};
     std::transform(
         other.triangle_map_.begin(),
         other.triangle_map_.end(),
         std::back_inserter(triangle_set_2),
-        [](std::pair<triangle_t const, index_type> const& kv) { return kv.first; });
+        [](triangle_map_type::value_type const& kv) { return kv.first; });
+    std::sort(triangle_set_2.begin(), triangle_set_2.end());
 
     bool const are_triangle_sets_equal = (triangle_set_1 == triangle_set_2);
     return are_triangle_sets_equal;
 }
 
+
+namespace {
+
+/**
+ * Local vertices of the faces of a tetrahedron, in the order of tetrahedron_t::faces_copy()
+ */
+std::array<std::array<std::uint8_t, 3u>, 4u> constexpr tetrahedron_face_vertices{
+    {{0u, 1u, 3u}, {1u, 2u, 3u}, {2u, 0u, 3u}, {0u, 2u, 1u}}};
+
+/**
+ * Local vertices of the edges of a tetrahedron, in the order and orientation in which
+ * add_tetrahedron() first encounters them while adding the edges of its faces
+ */
+std::array<std::array<std::uint8_t, 2u>, 6u> constexpr tetrahedron_edge_vertices{
+    {{0u, 1u}, {1u, 3u}, {3u, 0u}, {1u, 2u}, {2u, 3u}, {2u, 0u}}};
+
+/**
+ * Local edges above of tetrahedron_t::edges_copy() and of each face's triangle_t::edges_copy()
+ */
+std::array<std::uint8_t, 6u> constexpr tetrahedron_edges{0u, 3u, 5u, 2u, 1u, 4u};
+std::array<std::array<std::uint8_t, 3u>, 4u> constexpr tetrahedron_face_edges{
+    {{0u, 1u, 2u}, {3u, 4u, 1u}, {5u, 2u, 4u}, {5u, 3u, 0u}}};
+
+/**
+ * @brief Key of a slot, compared by its high part first
+ */
+struct slot_key_t
+{
+    std::uint64_t high;
+    std::uint64_t low;
+    std::uint32_t slot;
+};
+
+/**
+ * @brief Stably sorts keys by the lowest bit_count bits of their given part, 11 bits per pass.
+ * Histograms and scatters run in parallel over contiguous chunks of keys, such that the result
+ * does not depend on the number of threads.
+ */
+void radix_sort(
+    std::vector<slot_key_t>& keys,
+    std::vector<slot_key_t>& buffer,
+    std::uint64_t slot_key_t::*part,
+    unsigned int bit_count)
+{
+    unsigned int constexpr digit_bits = 11u;
+    std::size_t constexpr radix       = std::size_t{1u} << digit_bits;
+    std::uint64_t constexpr mask      = radix - 1u;
+
+    std::size_t const count       = keys.size();
+    std::size_t const chunk_count = std::min(
+        common::thread_count(),
+        std::max<std::size_t>(count / 65536u, 1u));
+
+    buffer.resize(count);
+    std::vector<std::size_t> offsets(chunk_count * radix);
+    for (unsigned int shift = 0u; shift < bit_count; shift += digit_bits)
+    {
+        std::fill(offsets.begin(), offsets.end(), std::size_t{0u});
+        std::size_t const chunks = common::parallel_for_chunks(
+            count,
+            chunk_count,
+            [&](std::size_t c, std::size_t begin, std::size_t end) {
+                std::size_t* histogram = offsets.data() + c * radix;
+                for (std::size_t i = begin; i < end; ++i)
+                    ++histogram[(keys[i].*part >> shift) & mask];
+            });
+
+        // digits first, then chunks, which keeps equal keys in their current order
+        std::size_t sum = 0u;
+        for (std::size_t d = 0u; d < radix; ++d)
+        {
+            for (std::size_t c = 0u; c < chunks; ++c)
+            {
+                std::size_t const n    = offsets[c * radix + d];
+                offsets[c * radix + d] = sum;
+                sum += n;
+            }
+        }
+
+        common::parallel_for_chunks(
+            count,
+            chunk_count,
+            [&](std::size_t c, std::size_t begin, std::size_t end) {
+                std::size_t* offset = offsets.data() + c * radix;
+                for (std::size_t i = begin; i < end; ++i)
+                    buffer[offset[(keys[i].*part >> shift) & mask]++] = keys[i];
+            });
+        keys.swap(buffer);
+    }
+}
+
+/**
+ * @brief Numbers the distinct keys of the slots in the order of their first slots.
+ * @param keys Keys of slots 0, 1, ..., sorted by key and then by slot on return
+ * @param group_begins Filled with the offsets in keys of the groups of slots sharing a key,
+ * terminated by the number of slots
+ * @return The slots' numbers
+ */
+std::vector<index_type> number_distinct_keys(
+    std::vector<slot_key_t>& keys,
+    unsigned int high_bit_count,
+    unsigned int low_bit_count,
+    std::vector<std::size_t>& group_begins)
+{
+    std::vector<slot_key_t> buffer{};
+    radix_sort(keys, buffer, &slot_key_t::low, low_bit_count);
+    radix_sort(keys, buffer, &slot_key_t::high, high_bit_count);
+
+    // every slot points to the first slot of its group, which precedes it
+    std::size_t const count = keys.size();
+    std::vector<std::uint32_t> first_slots(count);
+    group_begins.clear();
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        if (i == 0u || keys[i].high != keys[i - 1u].high || keys[i].low != keys[i - 1u].low)
+            group_begins.push_back(i);
+
+        first_slots[keys[i].slot] = keys[group_begins.back()].slot;
+    }
+    group_begins.push_back(count);
+
+    std::vector<index_type> numbers(count);
+    index_type next = 0u;
+    for (std::size_t s = 0u; s < count; ++s)
+        numbers[s] = (first_slots[s] == s) ? next++ : numbers[first_slots[s]];
+
+    return numbers;
+}
+
+/**
+ * @brief Copies the rows of incidences to list(0), list(1), ... in parallel
+ */
+template <class ListFunc>
+void copy_incidences(csr_incidence_t const& incidences, ListFunc const& list)
+{
+    common::parallel_for(incidences.row_count(), [&](std::size_t i) {
+        csr_incidence_t::row_type const row = incidences[i];
+        list(i).assign(row.begin(), row.end());
+    });
+}
+
+} // namespace
+
 /**
  * Tetrahedron set
  */
@@ -896,13 +1137,15 @@ tetrahedron_t const& tetrahedron_set_t::tetrahedron(index_type ti) const
     return tetrahedra_[ti];
 }
 
-tetrahedron_t& tetrahedron_set_t::tetrahedron(index_type ti)
+tetrahedron_t& tetrahedron_set_t::mutable_tetrahedron(index_type ti)
 {
     return tetrahedra_[ti];
 }
 
-void tetrahedron_set_t::add_tetrahedron(tetrahedron_t const& tetrahedron)
+index_type tetrahedron_set_t::add_tetrahedron(tetrahedron_t const& tetrahedron)
 {
+    build_deferred_incidence_lists();
+
     tetrahedron_t created_tetrahedron{
         tetrahedron.v1(),
         tetrahedron.v2(),
@@ -912,36 +1155,20 @@ void tetrahedron_set_t::add_tetrahedron(tetrahedron_t const& tetrahedron)
     std::array<triangle_t, 4u> const triangle_copies = created_tetrahedron.faces_copy();
     for (std::uint8_t f = 0u; f < triangle_copies.size(); ++f)
     {
-        triangle_t const& triangle_copy = triangle_copies[f];
-
-        auto triangle_it = triangle_map_.find(triangle_copy);
-        if (triangle_it == triangle_map_.end())
-        {
-            add_triangle(triangle_copy);
-            index_type const fi                      = triangle_map_[triangle_copy];
-            created_tetrahedron.face_indices().at(f) = fi;
-        }
-        else
-        {
-            index_type const fi                      = triangle_it->second;
-            created_tetrahedron.face_indices().at(f) = fi;
-        }
+        // add_triangle returns the index of the existing triangle, if any
+        created_tetrahedron.face_indices().at(f) = add_triangle(triangle_copies[f]);
     }
     std::array<edge_t, 6u> const edge_copies = created_tetrahedron.edges_copy();
     for (std::uint8_t e = 0u; e < edge_copies.size(); ++e)
     {
-        auto it = edge_map_.find(edge_copies[e]);
-        assert(it != edge_map_.end());
-        index_type const ei                      = it->second;
-        created_tetrahedron.edge_indices().at(e) = ei;
+        created_tetrahedron.edge_indices().at(e) = ei(edge_copies[e]);
     }
 
     index_type ti{};
     if (!tetrahedron_garbage_collector_.empty())
     {
-        ti              = *tetrahedron_garbage_collector_.begin();
+        ti              = pop_smallest_free_index(tetrahedron_garbage_collector_);
         tetrahedra_[ti] = created_tetrahedron;
-        tetrahedron_garbage_collector_.erase(tetrahedron_garbage_collector_.begin());
     }
     else
     {
@@ -952,13 +1179,321 @@ void tetrahedron_set_t::add_tetrahedron(tetrahedron_t const& tetrahedron)
     create_vertex_to_tetrahedron_incidency(ti);
     create_edge_to_tetrahedron_incidency(ti);
     create_triangle_to_tetrahedron_incidency(ti);
-    return;
+
+    opposite_half_faces_.resize(4u * tetrahedra_.size(), no_half_face);
+    for (std::uint8_t f = 0u; f < 4u; ++f)
+    {
+        opposite_half_faces_[4u * ti + f] = no_half_face;
+        pair_half_face(ti, f);
+    }
+    ++revision_;
+    return ti;
+}
+
+void tetrahedron_set_t::assign_tetrahedra(std::vector<index_type> const& indices)
+{
+    clear();
+
+    std::size_t const tetrahedron_total = indices.size() / 4u;
+    if (tetrahedron_total == 0u)
+        return;
+
+    index_type const max_vi = *std::max_element(indices.begin(), indices.end());
+    unsigned int bit_count  = 1u;
+    while (bit_count < 32u && (max_vi >> bit_count) != 0u)
+        ++bit_count;
+
+    reserve_vertices(static_cast<std::size_t>(max_vi) + 1u);
+    add_vertex(max_vi);
+
+    tetrahedra_.reserve(tetrahedron_total);
+    for (std::size_t t = 0u; t < tetrahedron_total; ++t)
+    {
+        index_type const* v = indices.data() + 4u * t;
+        tetrahedra_.emplace_back(v[0], v[1], v[2], v[3]);
+    }
+
+    auto const vertex_of = [&](std::size_t t, std::uint8_t local_vi) {
+        return indices[4u * t + local_vi];
+    };
+
+    /**
+     * Edges are the distinct keys of 6 slots per tetrahedron and triangles those of 4 slots per
+     * tetrahedron. Numbering them in the order of their first slots and orienting them as their
+     * first slots reproduces the indices and orientations of incremental construction.
+     */
+    std::vector<slot_key_t> keys(6u * tetrahedron_total);
+    std::vector<std::size_t> group_begins{};
+    common::parallel_for(keys.size(), [&](std::size_t s) {
+        std::array<std::uint8_t, 2u> const& e = tetrahedron_edge_vertices[s % 6u];
+        index_type const a                    = vertex_of(s / 6u, e[0]);
+        index_type const b                    = vertex_of(s / 6u, e[1]);
+        keys[s] = {std::min(a, b), std::max(a, b), static_cast<std::uint32_t>(s)};
+    });
+    std::vector<index_type> const edge_slots =
+        number_distinct_keys(keys, bit_count, bit_count, group_begins);
+
+    std::size_t const edge_total = group_begins.size() - 1u;
+    mutable_edges().resize(edge_total);
+    edge_map_.reserve(edge_total);
+    common::parallel_for(edge_total, [&](std::size_t g) {
+        std::uint32_t const first             = keys[group_begins[g]].slot;
+        std::array<std::uint8_t, 2u> const& e = tetrahedron_edge_vertices[first % 6u];
+        edge_t& created_edge                  = mutable_edge(edge_slots[first]);
+        created_edge = edge_t{vertex_of(first / 6u, e[0]), vertex_of(first / 6u, e[1])};
+
+        std::vector<index_type>& incident_tets = created_edge.incident_tetrahedron_indices();
+        incident_tets.reserve(group_begins[g + 1u] - group_begins[g]);
+        for (std::size_t i = group_begins[g]; i < group_begins[g + 1u]; ++i)
+            incident_tets.push_back(keys[i].slot / 6u);
+    });
+    for (index_type ei = 0u; ei < edge_total; ++ei)
+        edge_map_.insert_or_assign(edge(ei).key(), ei);
+
+    keys.resize(4u * tetrahedron_total);
+    common::parallel_for(keys.size(), [&](std::size_t s) {
+        std::array<std::uint8_t, 3u> const& f = tetrahedron_face_vertices[s % 4u];
+        std::array<index_type, 3u> const k =
+            triangle_t{vertex_of(s / 4u, f[0]), vertex_of(s / 4u, f[1]), vertex_of(s / 4u, f[2])}
+                .key();
+        keys[s] = {k[0], (std::uint64_t{k[1]} << bit_count) | k[2], static_cast<std::uint32_t>(s)};
+    });
+    std::vector<index_type> const face_slots =
+        number_distinct_keys(keys, bit_count, 2u * bit_count, group_begins);
+
+    // slots of a face's group are half-faces in increasing order, of which the first two pair
+    std::size_t const triangle_total = group_begins.size() - 1u;
+    mutable_triangles().resize(triangle_total);
+    triangle_map_.reserve(triangle_total);
+    opposite_half_faces_.assign(4u * tetrahedron_total, no_half_face);
+    common::parallel_for(triangle_total, [&](std::size_t g) {
+        std::uint32_t const first             = keys[group_begins[g]].slot;
+        if (group_begins[g + 1u] - group_begins[g] >= 2u)
+        {
+            std::uint32_t const second   = keys[group_begins[g] + 1u].slot;
+            opposite_half_faces_[first]  = second;
+            opposite_half_faces_[second] = first;
+        }
+
+        std::size_t const t                   = first / 4u;
+        std::array<std::uint8_t, 3u> const& f = tetrahedron_face_vertices[first % 4u];
+        triangle_t& created_triangle          = mutable_triangle(face_slots[first]);
+        created_triangle = triangle_t{vertex_of(t, f[0]), vertex_of(t, f[1]), vertex_of(t, f[2])};
+        for (std::uint8_t e = 0u; e < 3u; ++e)
+        {
+            created_triangle.edge_indices()[e] =
+                edge_slots[6u * t + tetrahedron_face_edges[first % 4u][e]];
+        }
+
+        std::vector<index_type>& incident_tets = created_triangle.incident_tetrahedron_indices();
+        incident_tets.reserve(group_begins[g + 1u] - group_begins[g]);
+        for (std::size_t i = group_begins[g]; i < group_begins[g + 1u]; ++i)
+            incident_tets.push_back(keys[i].slot / 4u);
+    });
+    for (index_type fi = 0u; fi < triangle_total; ++fi)
+        triangle_map_.insert_or_assign(triangle(fi).key(), fi);
+
+    common::parallel_for(tetrahedron_total, [&](std::size_t t) {
+        tetrahedron_t& created_tetrahedron = tetrahedra_[t];
+        for (std::uint8_t e = 0u; e < 6u; ++e)
+            created_tetrahedron.edge_indices()[e] = edge_slots[6u * t + tetrahedron_edges[e]];
+        for (std::uint8_t f = 0u; f < 4u; ++f)
+            created_tetrahedron.face_indices()[f] = face_slots[4u * t + f];
+    });
+
+    // incidences in increasing primitive index order, as incremental construction creates them
+    ++revision_;
+    topology_incidences_t const& created_incidences = incidences();
+    copy_incidences(created_incidences.vertex_edges, [&](std::size_t vi) -> auto& {
+        return mutable_vertex(vi).incident_edge_indices();
+    });
+    copy_incidences(created_incidences.vertex_triangles, [&](std::size_t vi) -> auto& {
+        return mutable_vertex(vi).incident_triangle_indices();
+    });
+    copy_incidences(created_incidences.vertex_tetrahedra, [&](std::size_t vi) -> auto& {
+        return mutable_vertex(vi).incident_tetrahedron_indices();
+    });
+    copy_incidences(created_incidences.edge_triangles, [&](std::size_t ei) -> auto& {
+        return mutable_edge(static_cast<index_type>(ei)).incident_triangle_indices();
+    });
+}
+
+tetrahedron_set_arrays_t tetrahedron_set_t::arrays() const
+{
+    assert(is_safe_to_iterate_over_edges());
+    assert(is_safe_to_iterate_over_triangles());
+    assert(is_safe_to_iterate_over_tetrahedra());
+
+    tetrahedron_set_arrays_t flat{};
+    flat.vertex_count = vertex_count();
+
+    std::vector<edge_t> const& all_edges = edges();
+    flat.edge_vertices.resize(2u * all_edges.size());
+    common::parallel_for(all_edges.size(), [&](std::size_t ei) {
+        std::array<index_type, 2u> const& v = all_edges[ei].vertex_indices();
+        std::copy_n(v.begin(), 2u, flat.edge_vertices.begin() + 2u * ei);
+    });
+
+    std::vector<triangle_t> const& all_triangles = triangles();
+    flat.triangle_vertices.resize(3u * all_triangles.size());
+    flat.triangle_edges.resize(3u * all_triangles.size());
+    common::parallel_for(all_triangles.size(), [&](std::size_t fi) {
+        triangle_t const& t = all_triangles[fi];
+        std::copy_n(t.vertex_indices().begin(), 3u, flat.triangle_vertices.begin() + 3u * fi);
+        std::copy_n(t.edge_indices().begin(), 3u, flat.triangle_edges.begin() + 3u * fi);
+    });
+
+    flat.tetrahedron_vertices.resize(4u * tetrahedra_.size());
+    flat.tetrahedron_edges.resize(6u * tetrahedra_.size());
+    flat.tetrahedron_faces.resize(4u * tetrahedra_.size());
+    common::parallel_for(tetrahedra_.size(), [&](std::size_t ti) {
+        tetrahedron_t const& t = tetrahedra_[ti];
+        std::copy_n(t.vertex_indices().begin(), 4u, flat.tetrahedron_vertices.begin() + 4u * ti);
+        std::copy_n(t.edge_indices().begin(), 6u, flat.tetrahedron_edges.begin() + 6u * ti);
+        std::copy_n(t.face_indices().begin(), 4u, flat.tetrahedron_faces.begin() + 4u * ti);
+    });
+
+    flat.opposite_half_faces = opposite_half_faces_;
+    flat.incidences          = incidences();
+    return flat;
+}
+
+template <class Arrays>
+void tetrahedron_set_t::assign_primitives(Arrays const& arrays)
+{
+    clear();
+
+    if (arrays.vertex_count > 0u)
+    {
+        reserve_vertices(arrays.vertex_count);
+        add_vertex(static_cast<index_type>(arrays.vertex_count - 1u));
+    }
+
+    std::size_t const edge_total = arrays.edge_vertices.size() / 2u;
+    mutable_edges().resize(edge_total);
+    common::parallel_for(edge_total, [&](std::size_t ei) {
+        index_type const* v = arrays.edge_vertices.data() + 2u * ei;
+        mutable_edge(static_cast<index_type>(ei)) = edge_t{v[0], v[1]};
+    });
+
+    std::size_t const triangle_total = arrays.triangle_vertices.size() / 3u;
+    mutable_triangles().resize(triangle_total);
+    common::parallel_for(triangle_total, [&](std::size_t fi) {
+        index_type const* v          = arrays.triangle_vertices.data() + 3u * fi;
+        triangle_t& created_triangle = mutable_triangle(static_cast<index_type>(fi));
+        created_triangle             = triangle_t{v[0], v[1], v[2]};
+        std::copy_n(
+            arrays.triangle_edges.begin() + 3u * fi,
+            3u,
+            created_triangle.edge_indices().begin());
+    });
+
+    // the two maps are independent, such that they are filled concurrently
+    common::parallel_for(
+        2u,
+        [&](std::size_t m) {
+            if (m == 0u)
+            {
+                edge_map_.reserve(edge_total);
+                for (std::size_t ei = 0u; ei < edge_total; ++ei)
+                    edge_map_.insert_or_assign(edges()[ei].key(), static_cast<index_type>(ei));
+            }
+            else
+            {
+                triangle_map_.reserve(triangle_total);
+                for (std::size_t fi = 0u; fi < triangle_total; ++fi)
+                {
+                    triangle_map_.insert_or_assign(
+                        triangles()[fi].key(),
+                        static_cast<index_type>(fi));
+                }
+            }
+        },
+        1u);
+
+    std::size_t const tetrahedron_total = arrays.tetrahedron_vertices.size() / 4u;
+    tetrahedra_.resize(tetrahedron_total);
+    common::parallel_for(tetrahedron_total, [&](std::size_t ti) {
+        index_type const* v                = arrays.tetrahedron_vertices.data() + 4u * ti;
+        tetrahedron_t& created_tetrahedron = tetrahedra_[ti];
+        created_tetrahedron                = tetrahedron_t{v[0], v[1], v[2], v[3]};
+        std::copy_n(
+            arrays.tetrahedron_edges.begin() + 6u * ti,
+            6u,
+            created_tetrahedron.edge_indices().begin());
+        std::copy_n(
+            arrays.tetrahedron_faces.begin() + 4u * ti,
+            4u,
+            created_tetrahedron.face_indices().begin());
+    });
+}
+
+void tetrahedron_set_t::assign_arrays(tetrahedron_set_arrays_t arrays)
+{
+    assign_primitives(arrays);
+    opposite_half_faces_ = std::move(arrays.opposite_half_faces);
+
+    ++revision_;
+    incidences_                   = std::move(arrays.incidences);
+    incidences_revision_          = revision_;
+    are_incidence_lists_deferred_ = true;
+}
+
+void tetrahedron_set_t::assign_arrays(tetrahedron_set_array_views_t const& arrays)
+{
+    assign_primitives(arrays);
+    opposite_half_faces_.assign(
+        arrays.opposite_half_faces.begin(),
+        arrays.opposite_half_faces.end());
+
+    ++revision_;
+    incidences_.vertex_edges.assign_rows(arrays.incidences.vertex_edges);
+    incidences_.vertex_triangles.assign_rows(arrays.incidences.vertex_triangles);
+    incidences_.vertex_tetrahedra.assign_rows(arrays.incidences.vertex_tetrahedra);
+    incidences_.edge_triangles.assign_rows(arrays.incidences.edge_triangles);
+    incidences_.edge_tetrahedra.assign_rows(arrays.incidences.edge_tetrahedra);
+    incidences_.triangle_tetrahedra.assign_rows(arrays.incidences.triangle_tetrahedra);
+    incidences_revision_          = revision_;
+    are_incidence_lists_deferred_ = true;
+}
+
+void tetrahedron_set_t::build_deferred_incidence_lists()
+{
+    if (!are_incidence_lists_deferred_)
+        return;
+
+    // the set was not edited since assign_arrays(), such that incidences_ is up to date
+    copy_incidences(incidences_.vertex_edges, [&](std::size_t vi) -> auto& {
+        return mutable_vertex(vi).incident_edge_indices();
+    });
+    copy_incidences(incidences_.vertex_triangles, [&](std::size_t vi) -> auto& {
+        return mutable_vertex(vi).incident_triangle_indices();
+    });
+    copy_incidences(incidences_.vertex_tetrahedra, [&](std::size_t vi) -> auto& {
+        return mutable_vertex(vi).incident_tetrahedron_indices();
+    });
+    copy_incidences(incidences_.edge_triangles, [&](std::size_t ei) -> auto& {
+        return mutable_edge(static_cast<index_type>(ei)).incident_triangle_indices();
+    });
+    copy_incidences(incidences_.edge_tetrahedra, [&](std::size_t ei) -> auto& {
+        return mutable_edge(static_cast<index_type>(ei)).incident_tetrahedron_indices();
+    });
+    copy_incidences(incidences_.triangle_tetrahedra, [&](std::size_t fi) -> auto& {
+        return mutable_triangle(static_cast<index_type>(fi)).incident_tetrahedron_indices();
+    });
+    are_incidence_lists_deferred_ = false;
 }
 
 tetrahedron_t tetrahedron_set_t::remove_tetrahedron(index_type ti)
 {
+    build_deferred_incidence_lists();
+
     tetrahedron_t const tetrahedron = tetrahedra_[ti];
 
+    for (std::uint8_t f = 0u; f < 4u; ++f)
+    {
+        unpair_half_face(4u * ti + f);
+    }
     for (index_type const vi : tetrahedron.vertex_indices())
     {
         remove_vertex_to_tetrahedron_incidency(vi, ti);
@@ -970,13 +1505,21 @@ tetrahedron_t tetrahedron_set_t::remove_tetrahedron(index_type ti)
     for (index_type const fi : tetrahedron.face_indices())
     {
         remove_triangle_to_tetrahedron_incidency(fi, ti);
-        if (triangle(fi).incident_tetrahedron_indices().empty())
+        std::vector<index_type> const& incident_tets = triangle(fi).incident_tetrahedron_indices();
+        if (incident_tets.empty())
         {
             remove_triangle(fi);
         }
+        else
+        {
+            // a face shared by more than two tetrahedra may now pair its remaining ones
+            index_type const tj = incident_tets.front();
+            pair_half_face(tj, tetrahedra_[tj].id_of_face(fi));
+        }
     }
 
-    tetrahedron_garbage_collector_.insert(ti);
+    push_free_index(tetrahedron_garbage_collector_, ti);
+    ++revision_;
     return tetrahedron;
 }
 
@@ -995,6 +1538,8 @@ void tetrahedron_set_t::clear()
     triangle_set_t::clear();
     tetrahedra_.clear();
     tetrahedron_garbage_collector_.clear();
+    opposite_half_faces_.clear();
+    are_incidence_lists_deferred_ = false;
 }
 
 bool tetrahedron_set_t::is_safe_to_iterate_over_tetrahedra() const
@@ -1007,61 +1552,72 @@ std::vector<tetrahedron_t> const& tetrahedron_set_t::tetrahedra() const
     return tetrahedra_;
 }
 
-std::vector<tetrahedron_t>& tetrahedron_set_t::tetrahedra()
+std::vector<tetrahedron_t>& tetrahedron_set_t::mutable_tetrahedra()
 {
     return tetrahedra_;
 }
 
 void tetrahedron_set_t::create_vertex_to_tetrahedron_incidency(index_type const ti)
 {
+    build_deferred_incidence_lists();
     tetrahedron_t const& t = tetrahedron(ti);
     for (index_type const vi : t.vertex_indices())
     {
-        vertex_t& v = vertex(vi);
+        vertex_t& v = mutable_vertex(vi);
         v.incident_tetrahedron_indices().push_back(ti);
     }
 }
 
 void tetrahedron_set_t::create_edge_to_tetrahedron_incidency(index_type const ti)
 {
+    build_deferred_incidence_lists();
     tetrahedron_t const& t = tetrahedron(ti);
     for (index_type const ei : t.edge_indices())
     {
-        edge_t& e = edge(ei);
+        edge_t& e = mutable_edge(ei);
         e.incident_tetrahedron_indices().push_back(ti);
     }
 }
 
 void tetrahedron_set_t::create_triangle_to_tetrahedron_incidency(index_type const ti)
 {
+    build_deferred_incidence_lists();
     tetrahedron_t const& t = tetrahedron(ti);
     for (index_type const fi : t.face_indices())
     {
-        triangle_t& f = triangle(fi);
+        triangle_t& f = mutable_triangle(fi);
         f.incident_tetrahedron_indices().push_back(ti);
     }
 }
 
 void tetrahedron_set_t::collect_garbage()
 {
+    build_deferred_incidence_lists();
+
     /**
      * Partitions the edge vector, triangle vector and tetrahedron
      * vector such that primitives to remove are found at the end
      * of the vectors, and we can call erase() from the cutoff to
      * the end of the primitive vectors to delete those primitives.
      */
+    std::sort(edge_garbage_collector_.begin(), edge_garbage_collector_.end());
+    std::sort(triangle_garbage_collector_.begin(), triangle_garbage_collector_.end());
+    std::sort(tetrahedron_garbage_collector_.begin(), tetrahedron_garbage_collector_.end());
 
     std::size_t const previous_edge_count = edges().size();
     std::size_t const edge_cutoff         = edges().size() - edge_garbage_collector_.size();
     if (edge_cutoff > 0u)
     {
-        auto pointer_to_valid_edge = edges().rbegin();
-        auto const begin           = edges().begin();
+        auto pointer_to_valid_edge = mutable_edges().rbegin();
+        auto const begin           = mutable_edges().begin();
         auto const index_of        = [this, begin](std::vector<edge_t>::reverse_iterator rit) {
             return static_cast<index_type>(std::distance(begin, rit.base())) - 1u;
         };
         auto const is_valid_edge = [this](index_type const ei) {
-            return edge_garbage_collector_.find(ei) == edge_garbage_collector_.end();
+            return !std::binary_search(
+                edge_garbage_collector_.begin(),
+                edge_garbage_collector_.end(),
+                ei);
         };
         // move the pointer to the first valid edge
         while (!is_valid_edge(index_of(pointer_to_valid_edge)))
@@ -1093,13 +1649,16 @@ void tetrahedron_set_t::collect_garbage()
     std::size_t const triangle_cutoff = triangles().size() - triangle_garbage_collector_.size();
     if (triangle_cutoff > 0u)
     {
-        auto pointer_to_valid_triangle = triangles().rbegin();
-        auto const begin               = triangles().begin();
+        auto pointer_to_valid_triangle = mutable_triangles().rbegin();
+        auto const begin               = mutable_triangles().begin();
         auto const index_of = [this, begin](std::vector<triangle_t>::reverse_iterator rit) {
             return static_cast<index_type>(std::distance(begin, rit.base())) - 1u;
         };
         auto const is_valid_triangle = [this](index_type const fi) {
-            return triangle_garbage_collector_.find(fi) == triangle_garbage_collector_.end();
+            return !std::binary_search(
+                triangle_garbage_collector_.begin(),
+                triangle_garbage_collector_.end(),
+                fi);
         };
         // move the pointer to the first valid edge
         while (!is_valid_triangle(index_of(pointer_to_valid_triangle)))
@@ -1132,13 +1691,16 @@ void tetrahedron_set_t::collect_garbage()
         tetrahedra().size() - tetrahedron_garbage_collector_.size();
     if (tetrahedron_cutoff > 0u)
     {
-        auto pointer_to_valid_tetrahedron = tetrahedra().rbegin();
-        auto const begin                  = tetrahedra().begin();
+        auto pointer_to_valid_tetrahedron = mutable_tetrahedra().rbegin();
+        auto const begin                  = mutable_tetrahedra().begin();
         auto const index_of = [this, begin](std::vector<tetrahedron_t>::reverse_iterator rit) {
             return static_cast<index_type>(std::distance(begin, rit.base())) - 1u;
         };
         auto const is_valid_tetrahedron = [this](index_type const ti) {
-            return tetrahedron_garbage_collector_.find(ti) == tetrahedron_garbage_collector_.end();
+            return !std::binary_search(
+                tetrahedron_garbage_collector_.begin(),
+                tetrahedron_garbage_collector_.end(),
+                ti);
         };
         // move the pointer to the first valid edge
         while (!is_valid_tetrahedron(index_of(pointer_to_valid_tetrahedron)))
@@ -1167,16 +1729,132 @@ void tetrahedron_set_t::collect_garbage()
         }
     }
 
-    edges().erase(edges().begin() + edge_cutoff, edges().end());
-    triangles().erase(triangles().begin() + triangle_cutoff, triangles().end());
-    tetrahedra().erase(tetrahedra().begin() + tetrahedron_cutoff, tetrahedra().end());
+    mutable_edges().erase(mutable_edges().begin() + edge_cutoff, mutable_edges().end());
+    mutable_triangles().erase(
+        mutable_triangles().begin() + triangle_cutoff,
+        mutable_triangles().end());
+    mutable_tetrahedra().erase(
+        mutable_tetrahedra().begin() + tetrahedron_cutoff,
+        mutable_tetrahedra().end());
+    opposite_half_faces_.resize(4u * tetrahedra().size());
 
     edge_garbage_collector_.clear();
     triangle_garbage_collector_.clear();
     tetrahedron_garbage_collector_.clear();
+    ++revision_;
     return;
 }
 
+topology_incidences_t const& tetrahedron_set_t::incidences() const
+{
+    if (incidences_revision_ == revision_)
+        return incidences_;
+
+    // removed primitives are not incident to anything
+    auto const removed = [](std::vector<index_type> const& garbage, std::size_t count) {
+        std::vector<bool> is_removed(count, false);
+        for (index_type const i : garbage)
+            is_removed[i] = true;
+        return is_removed;
+    };
+    std::vector<bool> const is_removed_edge = removed(edge_garbage_collector_, edges().size());
+    std::vector<bool> const is_removed_triangle =
+        removed(triangle_garbage_collector_, triangles().size());
+    std::vector<bool> const is_removed_tetrahedron =
+        removed(tetrahedron_garbage_collector_, tetrahedra_.size());
+
+    std::size_t const vertex_total = vertex_count();
+    incidences_.vertex_edges.assign(
+        vertex_total,
+        edges().size(),
+        2u,
+        [&](std::size_t ei, std::size_t k) {
+            return is_removed_edge[ei] ? csr_incidence_t::no_row : edge(ei).vertex_indices()[k];
+        });
+    incidences_.vertex_triangles.assign(
+        vertex_total,
+        triangles().size(),
+        3u,
+        [&](std::size_t fi, std::size_t k) {
+            return is_removed_triangle[fi] ? csr_incidence_t::no_row :
+                                             triangle(fi).vertex_indices()[k];
+        });
+    incidences_.vertex_tetrahedra.assign(
+        vertex_total,
+        tetrahedra_.size(),
+        4u,
+        [&](std::size_t ti, std::size_t k) {
+            return is_removed_tetrahedron[ti] ? csr_incidence_t::no_row :
+                                                tetrahedra_[ti].vertex_indices()[k];
+        });
+    incidences_.edge_triangles.assign(
+        edges().size(),
+        triangles().size(),
+        3u,
+        [&](std::size_t fi, std::size_t k) {
+            return is_removed_triangle[fi] ? csr_incidence_t::no_row :
+                                             triangle(fi).edge_indices()[k];
+        });
+    incidences_.edge_tetrahedra.assign(
+        edges().size(),
+        tetrahedra_.size(),
+        6u,
+        [&](std::size_t ti, std::size_t k) {
+            return is_removed_tetrahedron[ti] ? csr_incidence_t::no_row :
+                                                tetrahedra_[ti].edge_indices()[k];
+        });
+    incidences_.triangle_tetrahedra.assign(
+        triangles().size(),
+        tetrahedra_.size(),
+        4u,
+        [&](std::size_t ti, std::size_t k) {
+            return is_removed_tetrahedron[ti] ? csr_incidence_t::no_row :
+                                                tetrahedra_[ti].face_indices()[k];
+        });
+
+    incidences_revision_ = revision_;
+    return incidences_;
+}
+
+index_type tetrahedron_set_t::opposite_half_face(index_type ti, std::uint8_t f) const
+{
+    return opposite_half_faces_[4u * ti + f];
+}
+
+std::optional<index_type> tetrahedron_set_t::neighbor(index_type ti, std::uint8_t f) const
+{
+    index_type const h = opposite_half_face(ti, f);
+    if (h == no_half_face)
+        return {};
+
+    return h / 4u;
+}
+
+bool tetrahedron_set_t::is_boundary_face(index_type ti, std::uint8_t f) const
+{
+    return opposite_half_face(ti, f) == no_half_face;
+}
+
+std::vector<index_type> const& tetrahedron_set_t::opposite_half_faces() const
+{
+    return opposite_half_faces_;
+}
+
+std::vector<index_type> tetrahedron_set_t::boundary_half_faces() const
+{
+    std::vector<bool> is_removed_tetrahedron(tetrahedra_.size(), false);
+    for (index_type const ti : tetrahedron_garbage_collector_)
+        is_removed_tetrahedron[ti] = true;
+
+    std::vector<index_type> boundary{};
+    for (index_type h = 0u; h < opposite_half_faces_.size(); ++h)
+    {
+        if (opposite_half_faces_[h] == no_half_face && !is_removed_tetrahedron[h / 4u])
+            boundary.push_back(h);
+    }
+    return boundary;
+}
+
 bool tetrahedron_set_t::operator==(tetrahedron_set_t const& other) const
 {
     bool const are_triangle_sets_equal = triangle_set_t::operator==(other);
@@ -1193,38 +1871,38 @@ bool tetrahedron_set_t::operator==(tetrahedron_set_t const& other) const
 
 void tetrahedron_set_t::swap_edges(index_type ei, index_type eip)
 {
-    std::swap(edge(ei), edge(eip));
-    edge_map_[edge(ei)] = ei;
+    std::swap(mutable_edge(ei), mutable_edge(eip));
+    edge_map_.insert_or_assign(edge(ei).key(), ei);
 
     edge_t const& swapped_edge = edge(ei);
 
     for (index_type const vi : swapped_edge.vertex_indices())
     {
-        vertex_t& v = vertex(vi);
+        vertex_t& v = mutable_vertex(vi);
         std::replace(v.incident_edge_indices().begin(), v.incident_edge_indices().end(), eip, ei);
     }
     for (index_type const fi : swapped_edge.incident_triangle_indices())
     {
-        triangle_t& f = triangle(fi);
+        triangle_t& f = mutable_triangle(fi);
         std::replace(f.edge_indices().begin(), f.edge_indices().end(), eip, ei);
     }
     for (index_type const ti : swapped_edge.incident_tetrahedron_indices())
     {
-        tetrahedron_t& t = tetrahedron(ti);
+        tetrahedron_t& t = mutable_tetrahedron(ti);
         std::replace(t.edge_indices().begin(), t.edge_indices().end(), eip, ei);
     }
 }
 
 void tetrahedron_set_t::swap_triangles(index_type fi, index_type fip)
 {
-    std::swap(triangle(fi), triangle(fip));
-    triangle_map_[triangle(fi)] = fi;
+    std::swap(mutable_triangle(fi), mutable_triangle(fip));
+    triangle_map_.insert_or_assign(triangle(fi).key(), fi);
 
     triangle_t const& swapped_triangle = triangle(fi);
 
     for (index_type const vi : swapped_triangle.vertex_indices())
     {
-        vertex_t& v = vertex(vi);
+        vertex_t& v = mutable_vertex(vi);
         std::replace(
             v.incident_triangle_indices().begin(),
             v.incident_triangle_indices().end(),
@@ -1233,7 +1911,7 @@ void tetrahedron_set_t::swap_triangles(index_type fi, index_type fip)
     }
     for (index_type const ei : swapped_triangle.edge_indices())
     {
-        edge_t& e = edge(ei);
+        edge_t& e = mutable_edge(ei);
         std::replace(
             e.incident_triangle_indices().begin(),
             e.incident_triangle_indices().end(),
@@ -1242,20 +1920,30 @@ void tetrahedron_set_t::swap_triangles(index_type fi, index_type fip)
     }
     for (index_type const ti : swapped_triangle.incident_tetrahedron_indices())
     {
-        tetrahedron_t& t = tetrahedron(ti);
+        tetrahedron_t& t = mutable_tetrahedron(ti);
         std::replace(t.face_indices().begin(), t.face_indices().end(), fip, fi);
     }
 }
 
 void tetrahedron_set_t::swap_tetrahedra(index_type ti, index_type tip)
 {
-    std::swap(tetrahedron(ti), tetrahedron(tip));
+    std::swap(mutable_tetrahedron(ti), mutable_tetrahedron(tip));
+
+    // the removed tetrahedron ti has no paired half-faces
+    for (std::uint8_t f = 0u; f < 4u; ++f)
+    {
+        index_type const h                 = opposite_half_faces_[4u * tip + f];
+        opposite_half_faces_[4u * ti + f]  = h;
+        opposite_half_faces_[4u * tip + f] = no_half_face;
+        if (h != no_half_face)
+            opposite_half_faces_[h] = 4u * ti + f;
+    }
 
     tetrahedron_t const& swapped_tetrahedron = tetrahedron(ti);
 
     for (index_type const vi : swapped_tetrahedron.vertex_indices())
     {
-        vertex_t& v = vertex(vi);
+        vertex_t& v = mutable_vertex(vi);
         std::replace(
             v.incident_tetrahedron_indices().begin(),
             v.incident_tetrahedron_indices().end(),
@@ -1264,7 +1952,7 @@ void tetrahedron_set_t::swap_tetrahedra(index_type ti, index_type tip)
     }
     for (index_type const ei : swapped_tetrahedron.edge_indices())
     {
-        edge_t& e = edge(ei);
+        edge_t& e = mutable_edge(ei);
         std::replace(
             e.incident_tetrahedron_indices().begin(),
             e.incident_tetrahedron_indices().end(),
@@ -1273,7 +1961,7 @@ void tetrahedron_set_t::swap_tetrahedra(index_type ti, index_type tip)
     }
     for (index_type const fi : swapped_tetrahedron.face_indices())
     {
-        triangle_t& f = triangle(fi);
+        triangle_t& f = mutable_triangle(fi);
         std::replace(
             f.incident_tetrahedron_indices().begin(),
             f.incident_tetrahedron_indices().end(),
@@ -1282,5 +1970,37 @@ void tetrahedron_set_t::swap_tetrahedra(index_type ti, index_type tip)
     }
 }
 
+void tetrahedron_set_t::pair_half_face(index_type ti, std::uint8_t f)
+{
+    index_type const fi                          = tetrahedra_[ti].face_indices()[f];
+    std::vector<index_type> const& incident_tets = triangle(fi).incident_tetrahedron_indices();
+    if (incident_tets.size() < 2u)
+        return;
+
+    // only the first two tetrahedra of a face pair up
+    index_type tj{};
+    if (incident_tets[0] == ti)
+        tj = incident_tets[1];
+    else if (incident_tets[1] == ti)
+        tj = incident_tets[0];
+    else
+        return;
+
+    index_type const h       = 4u * ti + f;
+    index_type const hj      = 4u * tj + tetrahedra_[tj].id_of_face(fi);
+    opposite_half_faces_[h]  = hj;
+    opposite_half_faces_[hj] = h;
+}
+
+void tetrahedron_set_t::unpair_half_face(index_type h)
+{
+    index_type const opposite = opposite_half_faces_[h];
+    if (opposite == no_half_face)
+        return;
+
+    opposite_half_faces_[opposite] = no_half_face;
+    opposite_half_faces_[h]        = no_half_face;
+}
+
 } // namespace physics
-} // namespace sbs
\ No newline at end of file
+} // namespace sbs
@@ -13,16 +13,26 @@ collision_constraint_t::collision_constraint_t(
     index_type bi,
     index_type vi,
     Eigen::Vector3d const& p,
-    Eigen::Vector3d const& n)
-    : constraint_t{alpha, beta}, bi_(bi), vi_(vi), qs_(p), n_(n)
+    Eigen::Vector3d const& n,
+    Eigen::Vector3d const& v)
+    : constraint_t{alpha, beta},
+      bi_(bi),
+      vi_(vi),
+      qs_(p),
+      n_(n),
+      vs_(v),
+      elapsed_(0.),
+      solved_dt_(0.)
 {
 }
 
 void collision_constraint_t::project_positions(simulation_t& simulation, scalar_type dt)
 {
+    solved_dt_ = dt;
+
     particle_t& p       = simulation.particles()[bi_][vi_];
     scalar_type const w = p.invmass();
-    scalar_type const C = evaluate(p.xi());
+    scalar_type const C = evaluate(p.xi(), dt);
 
     if (C >= static_cast<scalar_type>(0.))
         return;
@@ -40,13 +50,20 @@ void collision_constraint_t::project_positions(simulation_t& simulation, scalar_
     p.xi() += w * n_ * delta_lagrange;
 }
 
-scalar_type collision_constraint_t::evaluate(Eigen::Vector3d const& p) const
+scalar_type collision_constraint_t::evaluate(Eigen::Vector3d const& p, scalar_type dt) const
 {
-    Eigen::Vector3d const qp = p - qs_;
+    Eigen::Vector3d const qp = p - (qs_ + vs_ * (elapsed_ + dt));
     double const C           = qp.dot(n_);
     return C;
 }
 
+void collision_constraint_t::prepare_for_projection_impl(simulation_t& simulation)
+{
+    // every solve after the first one starts a substep after the one last projected
+    elapsed_ += solved_dt_;
+    solved_dt_ = 0.;
+}
+
 } // namespace xpbd
 } // namespace physics
 } // namespace sbs
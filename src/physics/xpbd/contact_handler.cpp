@@ -4,6 +4,7 @@
 #include <sbs/physics/tetrahedral_mesh_boundary.h>
 #include <sbs/physics/xpbd/collision_constraint.h>
 #include <sbs/physics/xpbd/contact_handler.h>
+#include <sbs/physics/xpbd/vertex_triangle_collision_constraint.h>
 
 namespace sbs {
 namespace physics {
@@ -16,28 +17,48 @@ void contact_handler_t::handle(collision::contact_t const& contact)
     auto const contact_type = contact.type();
     if (contact_type == collision::contact_t::type_t::surface_particle_to_sdf)
     {
-        collision::surface_mesh_particle_to_sdf_contact_t const& surface_mesh_contact =
-            reinterpret_cast<collision::surface_mesh_particle_to_sdf_contact_t const&>(contact);
+        handle(
+            &static_cast<collision::surface_mesh_particle_to_sdf_contact_t const&>(contact),
+            1u);
+    }
+    if (contact_type == collision::contact_t::type_t::surface_particle_to_surface_triangle)
+    {
+        handle(
+            &static_cast<collision::surface_mesh_particle_to_triangle_contact_t const&>(contact),
+            1u);
+    }
+}
 
-        body_t const& b1 = *simulation_.bodies().at(contact.b1());
-        body_t const& b2 = *simulation_.bodies().at(contact.b2());
+void contact_handler_t::handle(
+    collision::surface_mesh_particle_to_sdf_contact_t const* contacts,
+    std::size_t count)
+{
+    if (count == 0u)
+        return;
 
-        tetrahedral_body_t const* tet_mesh = dynamic_cast<tetrahedral_body_t const*>(&b1);
-        if (!tet_mesh)
-        {
-            return;
-        }
+    body_t const& b1 = *simulation_.bodies().at(contacts[0u].b1());
 
-        auto const& visual_model = b1.visual_model();
-        tetrahedral_mesh_boundary_t const* mesh_boundary =
-            dynamic_cast<tetrahedral_mesh_boundary_t const*>(&visual_model);
-        if (!mesh_boundary)
-        {
-            return;
-        }
+    tetrahedral_body_t const* tet_mesh = dynamic_cast<tetrahedral_body_t const*>(&b1);
+    if (!tet_mesh)
+    {
+        return;
+    }
 
-        index_type const particle_index =
-            mesh_boundary->from_surface_vertex(surface_mesh_contact.vi());
+    auto const& visual_model = b1.visual_model();
+    tetrahedral_mesh_boundary_t const* mesh_boundary =
+        dynamic_cast<tetrahedral_mesh_boundary_t const*>(&visual_model);
+    if (!mesh_boundary)
+    {
+        return;
+    }
+
+    std::vector<std::unique_ptr<physics::constraint_t>>& collision_constraints =
+        simulation_.collision_constraints();
+    for (std::size_t c = 0u; c < count; ++c)
+    {
+        collision::surface_mesh_particle_to_sdf_contact_t const& contact = contacts[c];
+
+        index_type const particle_index = mesh_boundary->from_surface_vertex(contact.vi());
 
         auto collision_constraint = std::make_unique<xpbd::collision_constraint_t>(
             simulation_.simulation_parameters().collision_compliance,
@@ -46,9 +67,52 @@ void contact_handler_t::handle(collision::contact_t const& contact)
             b1.id(),
             particle_index,
             contact.point(),
+            contact.normal(),
+            contact.sdf_velocity());
+        collision_constraints.push_back(std::move(collision_constraint));
+    }
+}
+
+void contact_handler_t::handle(
+    collision::surface_mesh_particle_to_triangle_contact_t const* contacts,
+    std::size_t count)
+{
+    if (count == 0u)
+        return;
+
+    body_t const& b1 = *simulation_.bodies().at(contacts[0u].b1());
+    body_t const& b2 = *simulation_.bodies().at(contacts[0u].b2());
+
+    tetrahedral_mesh_boundary_t const* b1_boundary =
+        dynamic_cast<tetrahedral_mesh_boundary_t const*>(&b1.visual_model());
+    tetrahedral_mesh_boundary_t const* b2_boundary =
+        dynamic_cast<tetrahedral_mesh_boundary_t const*>(&b2.visual_model());
+    if (!b1_boundary || !b2_boundary)
+    {
+        return;
+    }
+
+    std::vector<std::unique_ptr<physics::constraint_t>>& collision_constraints =
+        simulation_.collision_constraints();
+    for (std::size_t c = 0u; c < count; ++c)
+    {
+        collision::surface_mesh_particle_to_triangle_contact_t const& contact = contacts[c];
+
+        index_type const particle_index = b1_boundary->from_surface_vertex(contact.vi());
+        auto const triangle             = b2_boundary->triangle(contact.fi());
+
+        auto collision_constraint = std::make_unique<xpbd::vertex_triangle_collision_constraint_t>(
+            simulation_.simulation_parameters().collision_compliance,
+            simulation_.simulation_parameters().collision_damping,
+            simulation_,
+            b1.id(),
+            particle_index,
+            b2.id(),
+            b2_boundary->from_surface_vertex(triangle.vertices[0u]),
+            b2_boundary->from_surface_vertex(triangle.vertices[1u]),
+            b2_boundary->from_surface_vertex(triangle.vertices[2u]),
+            contact.barycentric_coordinates(),
             contact.normal());
-        std::vector<std::unique_ptr<physics::constraint_t>>& collision_constraints =
-            simulation_.collision_constraints();
         collision_constraints.push_back(std::move(collision_constraint));
     }
 }
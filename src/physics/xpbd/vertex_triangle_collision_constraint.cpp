@@ -0,0 +1,79 @@
+#include <sbs/physics/simulation.h>
+#include <sbs/physics/xpbd/vertex_triangle_collision_constraint.h>
+
+namespace sbs {
+namespace physics {
+namespace xpbd {
+
+vertex_triangle_collision_constraint_t::vertex_triangle_collision_constraint_t(
+    scalar_type alpha,
+    scalar_type beta,
+    simulation_t const& simulation,
+    index_type bi,
+    index_type vi,
+    index_type bj,
+    index_type v1,
+    index_type v2,
+    index_type v3,
+    Eigen::Vector3d const& barycentric_coordinates,
+    Eigen::Vector3d const& n)
+    : constraint_t{alpha, beta},
+      bi_(bi),
+      vi_(vi),
+      bj_(bj),
+      v1_(v1),
+      v2_(v2),
+      v3_(v3),
+      barycentric_coordinates_(barycentric_coordinates),
+      n_(n)
+{
+}
+
+void vertex_triangle_collision_constraint_t::project_positions(
+    simulation_t& simulation,
+    scalar_type dt)
+{
+    particle_t& p  = simulation.particles()[bi_][vi_];
+    particle_t& p1 = simulation.particles()[bj_][v1_];
+    particle_t& p2 = simulation.particles()[bj_][v2_];
+    particle_t& p3 = simulation.particles()[bj_][v3_];
+
+    scalar_type const u = barycentric_coordinates_(0);
+    scalar_type const v = barycentric_coordinates_(1);
+    scalar_type const w = barycentric_coordinates_(2);
+
+    Eigen::Vector3d const q = u * p1.xi() + v * p2.xi() + w * p3.xi();
+    scalar_type const C     = (p.xi() - q).dot(n_);
+
+    if (C >= static_cast<scalar_type>(0.))
+        return;
+
+    scalar_type const w0 = p.invmass();
+    scalar_type const w1 = p1.invmass();
+    scalar_type const w2 = p2.invmass();
+    scalar_type const w3 = p3.invmass();
+
+    /**
+     * grad_x(C) = n, grad_xk(C) = -b_k * n,
+     * ||n||^2 = 1, so sum_i w_i * ||grad_i(C)||^2 = w + u^2 w1 + v^2 w2 + w^2 w3
+     */
+    scalar_type const weighted_sum_of_gradients = w0 + u * u * w1 + v * v * w2 + w * w * w3;
+    scalar_type const alpha_tilde               = alpha_ / (dt * dt);
+    scalar_type const denominator               = weighted_sum_of_gradients + alpha_tilde;
+
+    if (denominator <= static_cast<scalar_type>(0.))
+        return;
+
+    scalar_type const delta_lagrange = -(C + alpha_tilde * lagrange_) / denominator;
+
+    lagrange_ += delta_lagrange;
+
+    p.xi() += w0 * n_ * delta_lagrange;
+    p1.xi() += w1 * -u * n_ * delta_lagrange;
+    p2.xi() += w2 * -v * n_ * delta_lagrange;
+    p3.xi() += w3 * -w * n_ * delta_lagrange;
+}
+
+} // namespace xpbd
+} // namespace physics
+} // namespace sbs
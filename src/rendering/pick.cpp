@@ -1,20 +1,58 @@
 #include "sbs/rendering/pick.h"
 
 #include "sbs/common/mesh.h"
+#include "sbs/physics/collision/wide_bvh.h"
 #include "sbs/rendering/renderer.h"
 
 #include <Eigen/LU>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <limits>
 
 namespace sbs {
 namespace rendering {
 
+namespace {
+
+/**
+ * The picked triangle's vertex with the largest barycentric coordinate
+ */
+std::optional<std::uint32_t> closest_vertex(
+    common::shared_vertex_surface_mesh_i const& mesh,
+    std::optional<std::tuple<std::uint32_t, double, double, double>> const& picked_triangle)
+{
+    if (!picked_triangle.has_value())
+        return {};
+
+    auto const& [f, u, v, w] = picked_triangle.value();
+    std::uint32_t vi         = mesh.triangle(f).vertices[0u];
+    if (v > u && v > w)
+        vi = mesh.triangle(f).vertices[1u];
+    if (w > u && w > v)
+        vi = mesh.triangle(f).vertices[2u];
+
+    return vi;
+}
+
+} // namespace
+
 picker_t::picker_t(
     renderer_t const* renderer,
     std::vector<common::shared_vertex_surface_mesh_i*> const& nodes)
+    : picker_t(
+          renderer,
+          nodes,
+          std::vector<physics::collision::wide_bvh_t const*>(nodes.size(), nullptr))
+{
+}
+
+picker_t::picker_t(
+    renderer_t const* renderer,
+    std::vector<common::shared_vertex_surface_mesh_i*> const& nodes,
+    std::vector<physics::collision::wide_bvh_t const*> const& bvhs)
     : renderer_(renderer),
       nodes_(nodes),
+      bvhs_(bvhs),
       is_node_picked_(nodes.size(), false),
       picked_vertices_(nodes.size(), 0u),
       is_picking_{false},
@@ -61,7 +99,10 @@ void picker_t::mouse_button_pressed_event(GLFWwindow* window, int button, int ac
             if (!should_pick(node))
                 continue;
 
-            auto const vid = rendering::pick_vertex(ray, *node);
+            auto const* bvh = bvhs_[i];
+            auto const vid  = bvh != nullptr && !bvh->empty() ?
+                                  rendering::pick_vertex(ray, *node, *bvh) :
+                                  rendering::pick_vertex(ray, *node);
             if (!vid.has_value())
                 continue;
 
@@ -298,22 +339,59 @@ pick(common::ray_t const& ray, common::shared_vertex_surface_mesh_i const& mesh)
     return intersected_triangles.front();
 }
 
-std::optional<std::uint32_t>
-pick_vertex(common::ray_t const& ray, common::shared_vertex_surface_mesh_i const& mesh)
+std::optional<std::tuple<std::uint32_t, double, double, double>> pick(
+    common::ray_t const& ray,
+    common::shared_vertex_surface_mesh_i const& mesh,
+    physics::collision::wide_bvh_t const& bvh)
 {
-    auto const picked_triangle = pick(ray, mesh);
-    if (!picked_triangle.has_value())
-        return {};
+    std::optional<std::tuple<std::uint32_t, double, double, double>> closest_intersection{};
+    double closest_squared_distance = std::numeric_limits<double>::max();
 
-    auto const& [f, u, v, w] = picked_triangle.value();
-    std::uint32_t vi         = mesh.triangle(f).vertices[0u];
-    if (v > u && v > w)
-        vi = mesh.triangle(f).vertices[1u];
-    if (w > u && w > v)
-        vi = mesh.triangle(f).vertices[2u];
+    // the ray is a two-way line, like in pick(ray, mesh)
+    double constexpr infinity = std::numeric_limits<double>::infinity();
+    bvh.raycast(ray.p, ray.v, -infinity, infinity, [&](std::uint32_t begin, std::uint32_t count) {
+        for (std::uint32_t i = begin; i < begin + count; ++i)
+        {
+            std::uint32_t const f = bvh.entity(i);
+            auto const t          = mesh.triangle(f);
 
-    return vi;
+            auto const& a = common::point_t{mesh.vertex(t.vertices[0u]).position};
+            auto const& b = common::point_t{mesh.vertex(t.vertices[1u]).position};
+            auto const& c = common::point_t{mesh.vertex(t.vertices[2u]).position};
+
+            common::triangle_t const triangle{a, b, c};
+            auto const intersection = common::intersect_twoway(ray, triangle);
+
+            if (!intersection.has_value())
+                continue;
+
+            double const squared_distance = (intersection.value() - ray.p).squaredNorm();
+            if (squared_distance >= closest_squared_distance)
+                continue;
+
+            auto const [u, v, w] = common::barycentric_coordinates(a, b, c, intersection.value());
+
+            closest_intersection     = std::make_tuple(f, u, v, w);
+            closest_squared_distance = squared_distance;
+        }
+    });
+
+    return closest_intersection;
+}
+
+std::optional<std::uint32_t>
+pick_vertex(common::ray_t const& ray, common::shared_vertex_surface_mesh_i const& mesh)
+{
+    return closest_vertex(mesh, pick(ray, mesh));
 };
 
+std::optional<std::uint32_t> pick_vertex(
+    common::ray_t const& ray,
+    common::shared_vertex_surface_mesh_i const& mesh,
+    physics::collision::wide_bvh_t const& bvh)
+{
+    return closest_vertex(mesh, pick(ray, mesh, bvh));
+}
+
 } // namespace rendering
 } // namespace sbs
\ No newline at end of file
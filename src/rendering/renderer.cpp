@@ -4,12 +4,54 @@
 
 #include <imgui/backends/imgui_impl_glfw.h>
 #include <imgui/backends/imgui_impl_opengl3.h>
+#include <algorithm>
 #include <imgui/imgui.h>
 #include <sbs/physics/simulation.h>
 
 namespace sbs {
 namespace rendering {
 
+namespace {
+
+/**
+ * Transfers the changed entries [begin, end) of a cpu buffer to the gpu buffer bound to target.
+ * The gpu storage is reallocated with headroom when the cpu buffer outgrows it, and orphaned when
+ * all entries changed.
+ */
+template <class T>
+void transfer_buffer_range(
+    GLenum target,
+    std::vector<T> const& buffer,
+    std::size_t begin,
+    std::size_t end)
+{
+    GLint capacity = 0;
+    glGetBufferParameteriv(target, GL_BUFFER_SIZE, &capacity);
+
+    std::size_t const size           = buffer.size() * sizeof(T);
+    std::size_t const allocated_size = static_cast<std::size_t>(capacity);
+    bool const are_all_entries_dirty = begin == 0u && end >= buffer.size();
+    if (size > allocated_size || are_all_entries_dirty)
+    {
+        std::size_t const new_size = size > allocated_size ? size + size / 2u : allocated_size;
+        glBufferData(target, new_size, nullptr, GL_DYNAMIC_DRAW);
+        begin = 0u;
+        end   = buffer.size();
+    }
+
+    end = std::min(end, buffer.size());
+    if (begin < end)
+    {
+        glBufferSubData(
+            target,
+            begin * sizeof(T),
+            (end - begin) * sizeof(T),
+            buffer.data() + begin);
+    }
+}
+
+} // namespace
+
 renderer_base_t* renderer_base_t::active_renderer = nullptr;
 
 renderer_t::renderer_t(
@@ -499,11 +541,11 @@ void renderer_t::transfer_vertices_to_gpu(
      * Transfer vertex data to the GPU
      */
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(
+    transfer_buffer_range(
         GL_ARRAY_BUFFER,
-        cpu_buffer.size() * num_bytes_per_float,
-        cpu_buffer.data(),
-        GL_DYNAMIC_DRAW);
+        cpu_buffer,
+        object->dirty_vertices_begin(),
+        object->dirty_vertices_end());
 
     /**
      * Specify vertex attributes' layout on the GPU
@@ -545,19 +587,16 @@ void renderer_t::transfer_indices_to_gpu(unsigned int EBO, common::renderable_no
     const
 {
     std::vector<std::uint32_t> const& indices = object->get_cpu_index_buffer();
-    auto const num_indices                    = indices.size();
 
     /**
      * Transfer triangle data to the GPU
      */
-    auto constexpr num_bytes_per_index = sizeof(decltype(indices.front()));
-
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(
+    transfer_buffer_range(
         GL_ELEMENT_ARRAY_BUFFER,
-        indices.size() * num_bytes_per_index,
-        indices.data(),
-        GL_DYNAMIC_DRAW);
+        indices,
+        object->dirty_indices_begin(),
+        object->dirty_indices_end());
 }
 
 void renderer_t::update_shader_view_projection_uniforms(shader_t const& shader) const